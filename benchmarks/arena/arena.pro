@@ -0,0 +1,25 @@
+TEMPLATE = app
+TARGET = 
+DEPENDPATH += . src ../../common
+INCLUDEPATH += . src ../../common
+MOC_DIR = build
+OBJECTS_DIR = build
+
+CONFIG += qt release console
+QT -= gui
+
+HEADERS += ../../common/color.h \
+	../../common/serializable_item.h \
+	../../common/serializable_arena.h \
+	../../common/decklist.h \
+	../../common/protocol.h \
+	../../common/protocol_items.h \
+	../../common/protocol_datastructures.h
+
+SOURCES += src/main.cpp \
+	../../common/serializable_item.cpp \
+	../../common/serializable_arena.cpp \
+	../../common/decklist.cpp \
+	../../common/protocol.cpp \
+	../../common/protocol_items.cpp \
+	../../common/protocol_datastructures.cpp
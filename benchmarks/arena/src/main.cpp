@@ -0,0 +1,88 @@
+// Allocation benchmark for SerializableArena.
+//
+// Builds, serializes and deletes the protocol items of a typical game command
+// (a response and a game event container with a few card moves and attribute
+// changes), once with the items on the heap and once inside an arena scope,
+// the way Server_ProtocolHandler processes command containers.
+//
+// Usage: arena [iterations]
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QXmlStreamWriter>
+#include <QBuffer>
+#include <QStringList>
+#include <iostream>
+#include "protocol.h"
+#include "protocol_items.h"
+#include "serializable_arena.h"
+
+static void runCommand(QXmlStreamWriter *xmlWriter, QBuffer *buffer, int iteration)
+{
+	ProtocolResponse *response = new ProtocolResponse(iteration, RespOk);
+	QList<GameEvent *> events;
+	for (int i = 0; i < 4; ++i) {
+		events.append(new Event_MoveCard(0, i, "Island", "hand", i, 0, "table", i * 10, 0, 100 + i, false));
+		events.append(new Event_SetCardAttr(0, "table", 100 + i, "tapped", "1"));
+	}
+	events.append(new Event_SetCounter(0, 0, 20 - (iteration % 20)));
+	GameEventContainer *cont = new GameEventContainer(events, 1);
+	
+	response->write(xmlWriter);
+	cont->write(xmlWriter);
+	buffer->buffer().clear();
+	buffer->seek(0);
+	
+	delete cont;
+	delete response;
+}
+
+static void report(const QString &name, int iterations, qint64 nsecs, qint64 itemAllocations, qint64 heapAllocations)
+{
+	std::cout << name.toStdString()
+		<< ": " << (nsecs / iterations) << " ns/command, "
+		<< QString::number((double) itemAllocations / iterations, 'f', 1).toStdString() << " item allocations/command, "
+		<< QString::number((double) heapAllocations / iterations, 'f', 1).toStdString() << " of them from the heap"
+		<< std::endl;
+}
+
+int main(int argc, char *argv[])
+{
+	QCoreApplication app(argc, argv);
+	ProtocolItem::initializeHash();
+	
+	int iterations = 100000;
+	QStringList args = app.arguments();
+	if (args.size() > 1)
+		iterations = qMax(1, args[1].toInt());
+	
+	QBuffer buffer;
+	buffer.open(QIODevice::WriteOnly);
+	QXmlStreamWriter xmlWriter(&buffer);
+	
+	// Without an active arena every item is a heap allocation of its own.
+	// The arena reports how many items were created through it, so one
+	// warm-up command inside a scope gives the number of items per command.
+	SerializableArena arena;
+	{
+		SerializableArena::Scope scope(&arena);
+		runCommand(&xmlWriter, &buffer, 0);
+	}
+	const qint64 itemsPerCommand = arena.getTotalAllocationCount();
+	arena.resetStatistics();
+	
+	QElapsedTimer timer;
+	timer.start();
+	for (int i = 0; i < iterations; ++i)
+		runCommand(&xmlWriter, &buffer, i);
+	report("heap", iterations, timer.nsecsElapsed(), itemsPerCommand * iterations, itemsPerCommand * iterations);
+	
+	timer.restart();
+	for (int i = 0; i < iterations; ++i) {
+		SerializableArena::Scope scope(&arena);
+		runCommand(&xmlWriter, &buffer, i);
+	}
+	report("arena", iterations, timer.nsecsElapsed(), arena.getTotalAllocationCount(), arena.getHeapAllocationCount());
+	
+	return 0;
+}
@@ -0,0 +1,189 @@
+TEMPLATE = app
+TARGET = 
+DEPENDPATH += . src ../../cockatrice/src ../../common
+INCLUDEPATH += . src ../../cockatrice/src ../../common
+MOC_DIR = build
+OBJECTS_DIR = build
+RESOURCES = ../../cockatrice/cockatrice.qrc
+QT += network svg
+
+CONFIG += qt release console
+
+unix:LIBS += -lz
+win32:INCLUDEPATH += $$[QT_INSTALL_PREFIX]/src/3rdparty/zlib
+
+HEADERS += ../../cockatrice/src/abstractcounter.h \
+	../../cockatrice/src/counter_general.h \
+	../../cockatrice/src/dlg_creategame.h \
+	../../cockatrice/src/dlg_connect.h \
+	../../cockatrice/src/dlg_create_token.h \
+	../../cockatrice/src/gamesmodel.h \
+	../../cockatrice/src/abstractclient.h \
+	../../cockatrice/src/remoteclient.h \
+	../../cockatrice/src/remoteclientconnection.h \
+	../../cockatrice/src/window_main.h \
+	../../cockatrice/src/cardzone.h \
+	../../cockatrice/src/selectzone.h \
+	../../cockatrice/src/player.h \
+	../../cockatrice/src/playertarget.h \
+	../../cockatrice/src/cardlist.h \
+	../../cockatrice/src/abstractcarditem.h \
+	../../cockatrice/src/carditem.h \
+	../../cockatrice/src/tablezone.h \
+	../../cockatrice/src/handzone.h \
+	../../cockatrice/src/handcounter.h \
+	../../cockatrice/src/carddatabase.h \
+	../../cockatrice/src/gameview.h \
+	../../cockatrice/src/decklistmodel.h \
+	../../cockatrice/src/dlg_load_deck_from_clipboard.h \
+	../../cockatrice/src/dlg_load_remote_deck.h \
+	../../cockatrice/src/cardinfowidget.h \
+	../../cockatrice/src/messagelogwidget.h \
+	../../cockatrice/src/zoneviewzone.h \
+	../../cockatrice/src/zoneviewwidget.h \
+	../../cockatrice/src/pilezone.h \
+	../../cockatrice/src/stackzone.h \
+	../../cockatrice/src/carddragitem.h \
+	../../cockatrice/src/carddatabasemodel.h \
+	../../cockatrice/src/cardsearchindex.h \
+	../../cockatrice/src/cardquery.h \
+	../../cockatrice/src/window_deckeditor.h \
+	../../cockatrice/src/setsmodel.h \
+	../../cockatrice/src/window_sets.h \
+	../../cockatrice/src/abstractgraphicsitem.h \
+	../../cockatrice/src/abstractcarddragitem.h \
+	../../cockatrice/src/dlg_settings.h \
+	../../cockatrice/src/dlg_cardsearch.h \
+	../../cockatrice/src/phasestoolbar.h \
+	../../cockatrice/src/gamescene.h \
+	../../cockatrice/src/arrowitem.h \
+	../../cockatrice/src/arrowtarget.h \
+	../../cockatrice/src/tab.h \
+	../../cockatrice/src/tab_server.h \
+	../../cockatrice/src/tab_room.h \
+	../../cockatrice/src/tab_message.h \
+	../../cockatrice/src/tab_game.h \
+	../../cockatrice/src/tab_deck_storage.h \
+	../../cockatrice/src/tab_supervisor.h \
+	../../cockatrice/src/tab_admin.h \
+	../../cockatrice/src/userlist.h \
+	../../cockatrice/src/userinfobox.h \
+	../../cockatrice/src/avatarcache.h \
+	../../cockatrice/src/remotedecklist_treewidget.h \
+	../../cockatrice/src/deckview.h \
+	../../cockatrice/src/playerlistwidget.h \
+	../../cockatrice/src/pixmapgenerator.h \
+	../../cockatrice/src/settingscache.h \
+	../../cockatrice/src/localserver.h \
+	../../cockatrice/src/localserverinterface.h \
+	../../cockatrice/src/localclient.h \
+	../../cockatrice/src/translation.h \
+	../../common/color.h \
+	../../common/serializable_item.h \
+	../../common/stream_compression.h \
+	../../common/serializable_arena.h \
+	../../common/decklist.h \
+	../../common/protocol.h \
+	../../common/protocol_items.h \
+	../../common/protocol_datastructures.h \
+	../../common/rng_abstract.h \
+	../../common/rng_sfmt.h \
+	../../common/server.h \
+	../../common/server_arrow.h \
+	../../common/server_card.h \
+	../../common/server_cardpool.h \
+	../../common/server_cardzone.h \
+	../../common/server_room.h \
+	../../common/server_presence.h \
+	../../common/server_timerwheel.h \
+	../../common/server_counter.h \
+	../../common/server_game.h \
+	../../common/server_player.h \
+	../../common/server_protocolhandler.h \
+	../../common/server_arrowtarget.h
+
+SOURCES += src/main.cpp \
+	../../cockatrice/src/abstractcounter.cpp \
+	../../cockatrice/src/counter_general.cpp \
+	../../cockatrice/src/dlg_creategame.cpp \
+	../../cockatrice/src/dlg_connect.cpp \
+	../../cockatrice/src/dlg_create_token.cpp \
+	../../cockatrice/src/abstractclient.cpp \
+	../../cockatrice/src/remoteclient.cpp \
+	../../cockatrice/src/remoteclientconnection.cpp \
+	../../cockatrice/src/window_main.cpp \
+	../../cockatrice/src/gamesmodel.cpp \
+	../../cockatrice/src/player.cpp \
+	../../cockatrice/src/playertarget.cpp \
+	../../cockatrice/src/cardzone.cpp \
+	../../cockatrice/src/selectzone.cpp \
+	../../cockatrice/src/cardlist.cpp \
+	../../cockatrice/src/abstractcarditem.cpp \
+	../../cockatrice/src/carditem.cpp \
+	../../cockatrice/src/tablezone.cpp \
+	../../cockatrice/src/handzone.cpp \
+	../../cockatrice/src/handcounter.cpp \
+	../../cockatrice/src/carddatabase.cpp \
+	../../cockatrice/src/gameview.cpp \
+	../../cockatrice/src/decklistmodel.cpp \
+	../../cockatrice/src/dlg_load_deck_from_clipboard.cpp \
+	../../cockatrice/src/dlg_load_remote_deck.cpp \
+	../../cockatrice/src/cardinfowidget.cpp \
+	../../cockatrice/src/messagelogwidget.cpp \
+	../../cockatrice/src/zoneviewzone.cpp \
+	../../cockatrice/src/zoneviewwidget.cpp \
+	../../cockatrice/src/pilezone.cpp \
+	../../cockatrice/src/stackzone.cpp \
+	../../cockatrice/src/carddragitem.cpp \
+	../../cockatrice/src/carddatabasemodel.cpp \
+	../../cockatrice/src/cardsearchindex.cpp \
+	../../cockatrice/src/cardquery.cpp \
+	../../cockatrice/src/window_deckeditor.cpp \
+	../../cockatrice/src/setsmodel.cpp \
+	../../cockatrice/src/window_sets.cpp \
+	../../cockatrice/src/abstractgraphicsitem.cpp \
+	../../cockatrice/src/abstractcarddragitem.cpp \
+	../../cockatrice/src/dlg_settings.cpp \
+	../../cockatrice/src/dlg_cardsearch.cpp \
+	../../cockatrice/src/phasestoolbar.cpp \
+	../../cockatrice/src/gamescene.cpp \
+	../../cockatrice/src/arrowitem.cpp \
+	../../cockatrice/src/arrowtarget.cpp \
+	../../cockatrice/src/tab_server.cpp \
+	../../cockatrice/src/tab_room.cpp \
+	../../cockatrice/src/tab_message.cpp \
+	../../cockatrice/src/tab_game.cpp \
+	../../cockatrice/src/tab_deck_storage.cpp \
+	../../cockatrice/src/tab_supervisor.cpp \
+	../../cockatrice/src/tab_admin.cpp \
+	../../cockatrice/src/userlist.cpp \
+	../../cockatrice/src/userinfobox.cpp \
+	../../cockatrice/src/avatarcache.cpp \
+	../../cockatrice/src/remotedecklist_treewidget.cpp \
+	../../cockatrice/src/deckview.cpp \
+	../../cockatrice/src/playerlistwidget.cpp \
+	../../cockatrice/src/pixmapgenerator.cpp \
+	../../cockatrice/src/settingscache.cpp \
+	../../cockatrice/src/localserver.cpp \
+	../../cockatrice/src/localserverinterface.cpp \
+	../../cockatrice/src/localclient.cpp \
+	../../common/serializable_item.cpp \
+	../../common/stream_compression.cpp \
+	../../common/serializable_arena.cpp \
+	../../common/decklist.cpp \
+	../../common/protocol.cpp \
+	../../common/protocol_items.cpp \
+	../../common/protocol_datastructures.cpp \
+	../../common/rng_abstract.cpp \
+	../../common/rng_sfmt.cpp \
+	../../common/sfmt/SFMT.c \
+	../../common/server.cpp \
+	../../common/server_card.cpp \
+	../../common/server_cardpool.cpp \
+	../../common/server_cardzone.cpp \
+	../../common/server_room.cpp \
+	../../common/server_presence.cpp \
+	../../common/server_timerwheel.cpp \
+	../../common/server_game.cpp \
+	../../common/server_player.cpp \
+	../../common/server_protocolhandler.cpp
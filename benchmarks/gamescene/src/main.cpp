@@ -0,0 +1,400 @@
+// Game scene benchmark.
+//
+// Replays a log of game events through a spectating TabGame that is never
+// shown and reports how long the client takes to apply the events, to lay
+// out the scene and to paint it into an offscreen image.
+//
+// The log is the XML a client receives from the server, starting with the
+// cockatrice_server_stream element; items other than game event containers
+// are skipped. Without a log file, a scripted game of 200 turns is generated
+// and replayed instead. Every turn, the active player draws and plays cards,
+// creates tokens, attaches cards, points arrows at the next player's cards,
+// attacks and changes counters. With two players, each of them ends up
+// with well over a hundred permanents.
+//
+// Usage: gamescene [--players n] [event log]
+//
+// The QApplication still needs a display on X11, e.g. run it under Xvfb.
+
+#include <QApplication>
+#include <QTextCodec>
+#include <QTranslator>
+#include <QElapsedTimer>
+#include <QXmlStreamReader>
+#include <QXmlStreamWriter>
+#include <QShowEvent>
+#include <QPainter>
+#include <QImage>
+#include <QFile>
+#include <QStringList>
+#include <QMap>
+#include <iostream>
+#include "main.h"
+#include "carddatabase.h"
+#include "settingscache.h"
+#include "pixmapgenerator.h"
+#include "rng_sfmt.h"
+#include "tab_game.h"
+#include "gameview.h"
+#include "protocol.h"
+#include "protocol_items.h"
+
+CardDatabase *db;
+QTranslator *translator, *qtTranslator;
+SettingsCache *settingsCache;
+RNG_Abstract *rng;
+
+void installNewTranslator()
+{
+}
+
+static const int gameId = 1;
+static const int renderCount = 20;
+static const int initialHandSize = 7;
+static const int maxArrowsPerPlayer = 6;
+
+// The part of the game state the script has to know to only send events the
+// client can apply, the way the server would send them.
+struct ScriptArrow {
+	int playerId, arrowId;
+	int startPlayerId, startCardId;
+	int targetPlayerId, targetCardId;
+};
+
+struct ScriptPlayer {
+	int deckSize, handSize, life;
+	int nextCardId, nextArrowId;
+	QList<int> tableCards;
+	QMap<int, int> attachedTo;
+	ScriptPlayer(int _deckSize = 0) : deckSize(_deckSize), handSize(initialHandSize), life(20), nextCardId(0), nextArrowId(0) { }
+};
+
+static QList<ServerInfo_Zone *> initialZones(int deckSize)
+{
+	return QList<ServerInfo_Zone *>()
+		<< new ServerInfo_Zone("deck", HiddenZone, false, deckSize)
+		<< new ServerInfo_Zone("sb", HiddenZone, false, 15)
+		<< new ServerInfo_Zone("table", PublicZone, true, 0)
+		<< new ServerInfo_Zone("hand", PrivateZone, false, initialHandSize)
+		<< new ServerInfo_Zone("stack", PublicZone, false, 0)
+		<< new ServerInfo_Zone("grave", PublicZone, false, 0)
+		<< new ServerInfo_Zone("rfg", PublicZone, false, 0);
+}
+
+// Before a card leaves the table or is attached, the server deletes the
+// arrows from and to it and unattaches the cards attached to it.
+static void releaseCard(QList<GameEvent *> &events, QList<ScriptArrow> &arrows, ScriptPlayer &player, int playerId, int cardId)
+{
+	for (int i = arrows.size() - 1; i >= 0; --i) {
+		const ScriptArrow &arrow = arrows[i];
+		if (((arrow.startPlayerId == playerId) && (arrow.startCardId == cardId)) || ((arrow.targetPlayerId == playerId) && (arrow.targetCardId == cardId))) {
+			events.append(new Event_DeleteArrow(arrow.playerId, arrow.arrowId));
+			arrows.removeAt(i);
+		}
+	}
+	QMutableMapIterator<int, int> attachedIterator(player.attachedTo);
+	while (attachedIterator.hasNext())
+		if (attachedIterator.next().value() == cardId) {
+			events.append(new Event_AttachCard(playerId, "table", attachedIterator.key(), -1, QString(), -1));
+			attachedIterator.remove();
+		}
+}
+
+static QList<GameEventContainer *> scriptedGame(int turns, int playerCount)
+{
+	static const char *cardNames[] = { "Forest", "Llanowar Elves", "Mountain", "Grizzly Bears", "Island", "Serra Angel", "Plains", "Shivan Dragon" };
+	QList<GameEventContainer *> result;
+
+	// Two cards are drawn every turn, so that the hand never runs out.
+	const int turnsPerPlayer = (turns + playerCount - 1) / playerCount;
+	QList<ScriptPlayer> players;
+	QList<ServerInfo_Player *> playerList;
+	for (int playerId = 0; playerId < playerCount; ++playerId) {
+		players.append(ScriptPlayer(qMax(53, 2 * turnsPerPlayer)));
+		playerList.append(new ServerInfo_Player(
+			new ServerInfo_PlayerProperties(playerId, new ServerInfo_User(QString("Player %1").arg(playerId)), false, false, true, -1),
+			0,
+			initialZones(players[playerId].deckSize),
+			QList<ServerInfo_Counter *>() << new ServerInfo_Counter(0, "life", Color(255, 255, 255), 25, players[playerId].life)
+		));
+	}
+	result.append(new GameEventContainer(QList<GameEvent *>() << new Event_GameStateChanged(true, 0, 0, playerList), gameId));
+
+	QList<ScriptArrow> arrows;
+	for (int turn = 0; turn < turns; ++turn) {
+		const int p = turn % playerCount;
+		const int opponent = (p + 1) % playerCount;
+		ScriptPlayer &player = players[p];
+		QList<GameEvent *> events;
+		events << new Event_SetActivePlayer(-1, p) << new Event_SetActivePhase(-1, 0);
+		result.append(new GameEventContainer(events, gameId));
+
+		result.append(new GameEventContainer(QList<GameEvent *>() << new Event_SetCardAttr(p, "table", -1, "tapped", "0"), gameId));
+		const int drawn = qMin(2, player.deckSize);
+		if (drawn) {
+			result.append(new GameEventContainer(QList<GameEvent *>() << new Event_DrawCards(p, drawn), gameId));
+			player.deckSize -= drawn;
+			player.handSize += drawn;
+		}
+
+		// A land and a spell per turn; every third turn a creature dies.
+		for (int i = 0; (i < 2) && player.handSize; ++i, --player.handSize) {
+			const int cardId = player.nextCardId++;
+			const int column = player.tableCards.size();
+			result.append(new GameEventContainer(QList<GameEvent *>() << new Event_MoveCard(p, -1, cardNames[(turn + i) % 8], "hand", 0, p, "table", column * 3, 1 + (i + 1) % 2, cardId, false), gameId));
+			player.tableCards.append(cardId);
+		}
+		if ((turn % 3 == 2) && !player.tableCards.isEmpty()) {
+			const int cardId = player.tableCards.takeFirst();
+			QList<GameEvent *> dies;
+			releaseCard(dies, arrows, player, p, cardId);
+			player.attachedTo.remove(cardId);
+			dies.append(new Event_MoveCard(p, cardId, cardNames[turn % 8], "table", -1, p, "grave", 0, -1, player.nextCardId++, false));
+			result.append(new GameEventContainer(dies, gameId));
+		}
+		if (turn % 4 == 3) {
+			const int cardId = player.nextCardId++;
+			result.append(new GameEventContainer(QList<GameEvent *>() << new Event_CreateToken(p, "table", cardId, "Soldier", "w", "1/1", QString(), true, player.tableCards.size() * 3, 1), gameId));
+			player.tableCards.append(cardId);
+		}
+
+		// Every fifth turn, the newest card is attached to the oldest free one.
+		if ((turn % 5 == 1) && (player.tableCards.size() > 1)) {
+			const int cardId = player.tableCards.last();
+			int parentId = -1;
+			for (int i = 0; (i < player.tableCards.size() - 1) && (parentId == -1); ++i)
+				if (!player.attachedTo.contains(player.tableCards[i]))
+					parentId = player.tableCards[i];
+			if (parentId != -1) {
+				QList<GameEvent *> attach;
+				releaseCard(attach, arrows, player, p, cardId);
+				attach.append(new Event_AttachCard(p, "table", cardId, p, "table", parentId));
+				player.attachedTo.insert(cardId, parentId);
+				result.append(new GameEventContainer(attach, gameId));
+			}
+		}
+
+		// The newest card points at a card of the next player, or at the
+		// player if there is none; the oldest arrows are removed again.
+		if (!player.tableCards.isEmpty()) {
+			QList<GameEvent *> arrowEvents;
+			int playerArrows = 0;
+			for (int i = 0; i < arrows.size(); ++i)
+				if (arrows[i].playerId == p)
+					++playerArrows;
+			for (int i = 0; (i < arrows.size()) && (playerArrows >= maxArrowsPerPlayer); )
+				if (arrows[i].playerId == p) {
+					arrowEvents.append(new Event_DeleteArrow(p, arrows[i].arrowId));
+					arrows.removeAt(i);
+					--playerArrows;
+				} else
+					++i;
+
+			const QList<int> &targetCards = players[opponent].tableCards;
+			ScriptArrow arrow;
+			arrow.playerId = p;
+			arrow.arrowId = player.nextArrowId++;
+			arrow.startPlayerId = p;
+			arrow.startCardId = player.tableCards.last();
+			arrow.targetPlayerId = opponent;
+			arrow.targetCardId = targetCards.isEmpty() ? -1 : targetCards[turn % targetCards.size()];
+			bool duplicate = (arrow.targetPlayerId == arrow.startPlayerId) && (arrow.targetCardId == arrow.startCardId);
+			for (int i = 0; i < arrows.size(); ++i)
+				if ((arrows[i].playerId == p) && (arrows[i].startCardId == arrow.startCardId) && (arrows[i].targetPlayerId == arrow.targetPlayerId) && (arrows[i].targetCardId == arrow.targetCardId))
+					duplicate = true;
+			if (!duplicate) {
+				arrowEvents.append(new Event_CreateArrows(p, QList<ServerInfo_Arrow *>() << new ServerInfo_Arrow(
+					arrow.arrowId,
+					arrow.startPlayerId,
+					"table",
+					arrow.startCardId,
+					arrow.targetPlayerId,
+					arrow.targetCardId == -1 ? QString() : QString("table"),
+					arrow.targetCardId,
+					Color(255, 0, 0)
+				)));
+				arrows.append(arrow);
+			}
+			if (!arrowEvents.isEmpty())
+				result.append(new GameEventContainer(arrowEvents, gameId));
+		}
+
+		QList<GameEvent *> attack;
+		for (int i = 0; i < player.tableCards.size(); i += 2) {
+			attack.append(new Event_SetCardAttr(p, "table", player.tableCards[i], "tapped", "1"));
+			attack.append(new Event_SetCardAttr(p, "table", player.tableCards[i], "attacking", "1"));
+		}
+		if (!attack.isEmpty())
+			result.append(new GameEventContainer(attack, gameId));
+
+		players[opponent].life = qMax(1, players[opponent].life - 2);
+		result.append(new GameEventContainer(QList<GameEvent *>() << new Event_SetCounter(opponent, 0, players[opponent].life), gameId));
+		if (!player.tableCards.isEmpty())
+			result.append(new GameEventContainer(QList<GameEvent *>() << new Event_SetCardCounter(p, "table", player.tableCards.last(), 0, turn % 3), gameId));
+	}
+	return result;
+}
+
+static QByteArray writeLog(const QList<GameEventContainer *> &containers)
+{
+	QByteArray log;
+	QXmlStreamWriter xml(&log);
+	xml.writeStartDocument();
+	xml.writeStartElement("cockatrice_server_stream");
+	xml.writeAttribute("version", QString::number(ProtocolItem::protocolVersion));
+	for (int i = 0; i < containers.size(); ++i)
+		containers[i]->write(&xml);
+	xml.writeEndElement();
+	xml.writeEndDocument();
+	return log;
+}
+
+static QList<GameEventContainer *> readLog(const QByteArray &log)
+{
+	QList<GameEventContainer *> result;
+	QXmlStreamReader xml(log);
+	SerializableItem *currentItem = 0;
+	while (!xml.atEnd()) {
+		xml.readNext();
+		if (!currentItem) {
+			if (!xml.isStartElement() || (xml.name().toString() == "cockatrice_server_stream"))
+				continue;
+			const QString itemName = xml.name().toString();
+			currentItem = SerializableItem::getNewItem(itemName + xml.attributes().value("type").toString());
+			if (!currentItem)
+				currentItem = new SerializableItem_Invalid(itemName);
+		}
+		if (currentItem->readElement(&xml)) {
+			GameEventContainer *cont = dynamic_cast<GameEventContainer *>(currentItem);
+			if (cont)
+				result.append(cont);
+			else
+				delete currentItem;
+			currentItem = 0;
+		}
+	}
+	delete currentItem;
+	return result;
+}
+
+static int countEvents(const QList<GameEventContainer *> &containers)
+{
+	int result = 0;
+	for (int i = 0; i < containers.size(); ++i)
+		result += containers[i]->getEventList().size();
+	return result;
+}
+
+static TabGame *newTab(QList<AbstractClient *> &clients)
+{
+	// Spectating, so that no local player needs a deck view or a client.
+	return new TabGame(clients, gameId, "benchmark", -1, true, false, false, false);
+}
+
+static void report(const QString &name, qint64 nsecs, int count, const QString &unit)
+{
+	std::cout << name.toStdString()
+		<< ": " << (nsecs / 1000000) << " ms, "
+		<< (nsecs / qMax(count, 1)) << " ns/" << unit.toStdString()
+		<< std::endl;
+}
+
+int main(int argc, char *argv[])
+{
+	QApplication app(argc, argv);
+	QTextCodec::setCodecForCStrings(QTextCodec::codecForName("UTF-8"));
+	QCoreApplication::setOrganizationName("Cockatrice");
+	QCoreApplication::setOrganizationDomain("cockatrice.de");
+	QCoreApplication::setApplicationName("Cockatrice");
+
+	rng = new RNG_SFMT;
+	settingsCache = new SettingsCache;
+	db = new CardDatabase;
+	qtTranslator = new QTranslator;
+	translator = new QTranslator;
+	ProtocolItem::initializeHash();
+
+	QStringList args = app.arguments();
+	int playerCount = 2;
+	int playersArg = args.indexOf("--players");
+	if ((playersArg != -1) && (playersArg + 1 < args.size())) {
+		playerCount = qMax(args[playersArg + 1].toInt(), 1);
+		args.removeAt(playersArg + 1);
+		args.removeAt(playersArg);
+	}
+
+	QByteArray log;
+	if (args.size() > 1) {
+		QFile file(args[1]);
+		if (!file.open(QIODevice::ReadOnly)) {
+			std::cerr << "cannot open " << args[1].toStdString() << std::endl;
+			return 1;
+		}
+		log = file.readAll();
+	} else {
+		QList<GameEventContainer *> script = scriptedGame(200, playerCount);
+		log = writeLog(script);
+		qDeleteAll(script);
+	}
+
+	// Card names may be sent by id, so the log has to be read from its start
+	// with a fresh dictionary, like a new connection.
+	CardNameDictionary cardNames;
+	SerializableItem_CardName::setReadDictionary(&cardNames);
+	QElapsedTimer timer;
+	timer.start();
+	QList<GameEventContainer *> containers = readLog(log);
+	const qint64 decodeTime = timer.nsecsElapsed();
+	SerializableItem_CardName::setReadDictionary(0);
+
+	const int eventCount = countEvents(containers);
+	std::cout << containers.size() << " event containers, " << eventCount << " events" << std::endl;
+	report("decode", decodeTime, eventCount, "event");
+
+	QList<AbstractClient *> clients;
+
+	// A game in a background tab: the scene is suspended until it is shown.
+	TabGame *tab = newTab(clients);
+	timer.start();
+	for (int i = 0; i < containers.size(); ++i)
+		tab->processGameEventContainer(containers[i], 0);
+	report("apply events, hidden tab", timer.nsecsElapsed(), eventCount, "event");
+
+	QShowEvent showEvent;
+	timer.start();
+	QApplication::sendEvent(tab, &showEvent);
+	report("layout on show", timer.nsecsElapsed(), 1, "show");
+	delete tab;
+
+	// A game in the visible tab: deferred layout runs after every container,
+	// as it would once control returns to the event loop.
+	tab = newTab(clients);
+	QApplication::sendEvent(tab, &showEvent);
+	timer.start();
+	for (int i = 0; i < containers.size(); ++i) {
+		tab->processGameEventContainer(containers[i], 0);
+		QCoreApplication::processEvents();
+	}
+	report("apply events and layout, visible tab", timer.nsecsElapsed(), eventCount, "event");
+
+	GameView *view = tab->findChild<GameView *>();
+	if (view && view->scene()) {
+		QImage image(1280, 1024, QImage::Format_ARGB32_Premultiplied);
+		QPainter painter(&image);
+		timer.start();
+		for (int i = 0; i < renderCount; ++i)
+			view->scene()->render(&painter);
+		report("paint", timer.nsecsElapsed(), renderCount, "frame");
+	}
+	delete tab;
+
+	qDeleteAll(containers);
+	delete translator;
+	delete qtTranslator;
+	delete db;
+	delete settingsCache;
+	delete rng;
+	PingPixmapGenerator::clear();
+	SvgSpriteCache::destroy();
+	return 0;
+}
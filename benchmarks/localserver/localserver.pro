@@ -0,0 +1,57 @@
+TEMPLATE = app
+TARGET = 
+DEPENDPATH += . src ../../cockatrice/src ../../common
+INCLUDEPATH += . src ../../cockatrice/src ../../common
+MOC_DIR = build
+OBJECTS_DIR = build
+
+CONFIG += qt release console
+QT -= gui
+
+HEADERS += ../../cockatrice/src/localserver.h \
+	../../cockatrice/src/localserverinterface.h \
+	../../common/color.h \
+	../../common/serializable_item.h \
+	../../common/serializable_arena.h \
+	../../common/decklist.h \
+	../../common/protocol.h \
+	../../common/protocol_items.h \
+	../../common/protocol_datastructures.h \
+	../../common/rng_abstract.h \
+	../../common/rng_sfmt.h \
+	../../common/server.h \
+	../../common/server_arrow.h \
+	../../common/server_card.h \
+	../../common/server_cardpool.h \
+	../../common/server_cardzone.h \
+	../../common/server_room.h \
+	../../common/server_presence.h \
+	../../common/server_timerwheel.h \
+	../../common/server_counter.h \
+	../../common/server_game.h \
+	../../common/server_player.h \
+	../../common/server_protocolhandler.h \
+	../../common/server_arrowtarget.h
+
+SOURCES += src/main.cpp \
+	../../cockatrice/src/localserver.cpp \
+	../../cockatrice/src/localserverinterface.cpp \
+	../../common/serializable_item.cpp \
+	../../common/serializable_arena.cpp \
+	../../common/decklist.cpp \
+	../../common/protocol.cpp \
+	../../common/protocol_items.cpp \
+	../../common/protocol_datastructures.cpp \
+	../../common/rng_abstract.cpp \
+	../../common/rng_sfmt.cpp \
+	../../common/sfmt/SFMT.c \
+	../../common/server.cpp \
+	../../common/server_card.cpp \
+	../../common/server_cardpool.cpp \
+	../../common/server_cardzone.cpp \
+	../../common/server_room.cpp \
+	../../common/server_presence.cpp \
+	../../common/server_timerwheel.cpp \
+	../../common/server_game.cpp \
+	../../common/server_player.cpp \
+	../../common/server_protocolhandler.cpp
@@ -0,0 +1,292 @@
+// Server command benchmark.
+//
+// Drives a LocalServer with scripted games and reports how long
+// Server_ProtocolHandler::processCommandContainer takes per command and how
+// many items the command arena allocates for it, both per command type and
+// for the whole mix.
+//
+// Every game starts with a mulligan by each player. Every turn, the active
+// player draws, plays a card from the hand to the table, taps it, changes
+// the life counter and returns the oldest card on the table to the library
+// once the table is full. Arrows to the next player's cards are created and
+// deleted, cards are attached to each other, and shuffles, zone dumps and
+// spectators joining and leaving the game are mixed in at fixed intervals.
+//
+// Spectator joins are reported separately from player joins, and
+// Server_Game::getGameState is also timed on its own, in an arena scope
+// like the one processCommandContainer opens. Debug output of the server
+// is discarded so that writing it does not dominate the timings.
+//
+// Usage: localserver [games] [turns per game] [players per game]
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QStringList>
+#include <QMap>
+#include <iostream>
+#include <cstdlib>
+#include "localserver.h"
+#include "localserverinterface.h"
+#include "server_room.h"
+#include "server_game.h"
+#include "server_player.h"
+#include "server_cardzone.h"
+#include "server_card.h"
+#include "serializable_arena.h"
+#include "rng_sfmt.h"
+#include "decklist.h"
+#include "protocol.h"
+#include "protocol_items.h"
+
+RNG_Abstract *rng;
+
+class ResponseChecker : public QObject {
+	Q_OBJECT
+private:
+	int failures;
+public:
+	ResponseChecker() : QObject(), failures(0) { }
+	int getFailures() const { return failures; }
+public slots:
+	void itemToClient(ProtocolItem *item)
+	{
+		ProtocolResponse *response = qobject_cast<ProtocolResponse *>(item);
+		if (response && (response->getResponseCode() != RespOk) && (response->getResponseCode() != RespNothing))
+			++failures;
+	}
+};
+
+struct CommandTotals {
+	int count;
+	qint64 nsecs;
+	qint64 allocations;
+	qint64 heapAllocations;
+	CommandTotals() : count(0), nsecs(0), allocations(0), heapAllocations(0) { }
+	void add(const CommandTotals &other)
+	{
+		count += other.count;
+		nsecs += other.nsecs;
+		allocations += other.allocations;
+		heapAllocations += other.heapAllocations;
+	}
+};
+
+static LocalServer *server;
+static ResponseChecker *checker;
+static QMap<QString, CommandTotals> totals;
+static int cmdId = 0;
+
+static void messageOutput(QtMsgType type, const char *msg)
+{
+	if (type == QtDebugMsg)
+		return;
+	std::cerr << msg << std::endl;
+	if (type == QtFatalMsg)
+		abort();
+}
+
+static LocalServerInterface *newClient(const QString &userName)
+{
+	LocalServerInterface *client = server->newConnection();
+	QObject::connect(client, SIGNAL(itemToClient(ProtocolItem *)), checker, SLOT(itemToClient(ProtocolItem *)));
+	client->itemFromClient(new CommandContainer(QList<Command *>() << new Command_Login(userName, QString()), cmdId++));
+	client->itemFromClient(new CommandContainer(QList<Command *>() << new Command_JoinRoom(0), cmdId++));
+	return client;
+}
+
+static void addTotals(const QString &name, qint64 nsecs, qint64 allocations, qint64 heapAllocations)
+{
+	CommandTotals &t = totals[name];
+	++t.count;
+	t.nsecs += nsecs;
+	t.allocations += allocations;
+	t.heapAllocations += heapAllocations;
+}
+
+static void sendCommand(LocalServerInterface *client, Command *cmd, const QString &name = QString())
+{
+	const QString totalsName = name.isEmpty() ? cmd->getItemSubType() : name;
+	CommandContainer *cont = new CommandContainer(QList<Command *>() << cmd, cmdId++);
+	SerializableArena *arena = server->getCommandArena();
+	const qint64 allocationsBefore = arena->getTotalAllocationCount();
+	const qint64 heapAllocationsBefore = arena->getHeapAllocationCount();
+
+	QElapsedTimer timer;
+	timer.start();
+	client->itemFromClient(cont);
+	const qint64 nsecs = timer.nsecsElapsed();
+
+	addTotals(totalsName, nsecs, arena->getTotalAllocationCount() - allocationsBefore, arena->getHeapAllocationCount() - heapAllocationsBefore);
+}
+
+static void measureGameState(Server_Game *game, Server_Player *playerWhosAsking)
+{
+	SerializableArena *arena = server->getCommandArena();
+	SerializableArena::Scope arenaScope(arena);
+	const qint64 allocationsBefore = arena->getTotalAllocationCount();
+	const qint64 heapAllocationsBefore = arena->getHeapAllocationCount();
+
+	QElapsedTimer timer;
+	timer.start();
+	QList<ServerInfo_Player *> gameState = game->getGameState(playerWhosAsking);
+	const qint64 nsecs = timer.nsecsElapsed();
+
+	addTotals("Server_Game::getGameState", nsecs, arena->getTotalAllocationCount() - allocationsBefore, arena->getHeapAllocationCount() - heapAllocationsBefore);
+	qDeleteAll(gameState);
+}
+
+static DeckList *newDeck()
+{
+	static const char *cardNames[] = { "Forest", "Llanowar Elves", "Mountain", "Grizzly Bears", "Island", "Serra Angel", "Plains", "Shivan Dragon" };
+	DeckList *deck = new DeckList;
+	for (int i = 0; i < 60; ++i)
+		deck->addCard(cardNames[i % 8], "main");
+	return deck;
+}
+
+static Server_Card *attachTarget(Server_CardZone *table, Server_Card *card)
+{
+	for (int i = 0; i < table->cards.size(); ++i)
+		if ((table->cards[i] != card) && !table->cards[i]->getParentCard())
+			return table->cards[i];
+	return 0;
+}
+
+static void playTurn(Server_Game *game, const QList<Server_Player *> &players, LocalServerInterface *spectator, int turn)
+{
+	const int gameId = game->getGameId();
+	Server_Player *player = game->getPlayer(game->getActivePlayer());
+	Server_Player *opponent = players[(players.indexOf(player) + 1) % players.size()];
+	LocalServerInterface *client = static_cast<LocalServerInterface *>(player->getProtocolHandler());
+	const int playerId = player->getPlayerId();
+	Server_CardZone *hand = player->getZone(HandZoneId);
+	Server_CardZone *table = player->getZone(TableZoneId);
+	Server_CardZone *opponentTable = opponent->getZone(TableZoneId);
+
+	sendCommand(client, new Command_DrawCards(gameId, 1));
+	if (!hand->cards.isEmpty()) {
+		sendCommand(client, new Command_MoveCard(gameId, "hand", QList<CardId *>() << new CardId(hand->cards.first()->getId()), playerId, "table", 0, 0, false, false));
+		Server_Card *card = table->cards.last();
+		sendCommand(client, new Command_SetCardAttr(gameId, "table", card->getId(), "tapped", "1"));
+
+		if (player->getArrows().size() >= 3)
+			sendCommand(client, new Command_DeleteArrow(gameId, player->getArrows().begin().key()));
+		if (opponentTable->cards.isEmpty())
+			sendCommand(client, new Command_CreateArrow(gameId, playerId, "table", card->getId(), opponent->getPlayerId(), QString(), -1, Color(255, 0, 0)));
+		else
+			sendCommand(client, new Command_CreateArrow(gameId, playerId, "table", card->getId(), opponent->getPlayerId(), "table", opponentTable->cards[turn % opponentTable->cards.size()]->getId(), Color(255, 0, 0)));
+
+		// Attaching also deletes the arrow that was just created.
+		if (turn % 5 == 1) {
+			Server_Card *target = attachTarget(table, card);
+			if (target)
+				sendCommand(client, new Command_AttachCard(gameId, "table", card->getId(), playerId, "table", target->getId()));
+		}
+	}
+	if (turn % 5 == 4)
+		sendCommand(client, new Command_SetCounter(gameId, 0, 20));
+	else
+		sendCommand(client, new Command_IncCounter(gameId, 0, -1));
+	if (table->cards.size() > 12)
+		sendCommand(client, new Command_MoveCard(gameId, "table", QList<CardId *>() << new CardId(table->cards.first()->getId()), playerId, "deck", 0, 0, false, false));
+	if (turn % 4 == 3)
+		sendCommand(client, new Command_Shuffle(gameId));
+	if (turn % 3 == 2)
+		sendCommand(client, new Command_DumpZone(gameId, opponent->getPlayerId(), "table", -1));
+	if (turn % 10 == 9) {
+		// Joining sends the whole game state to the spectator.
+		sendCommand(spectator, new Command_JoinGame(0, gameId, QString(), true), "join_game (spectator)");
+		sendCommand(spectator, new Command_LeaveGame(gameId), "leave_game (spectator)");
+	}
+	measureGameState(game, player);
+	sendCommand(client, new Command_NextTurn(gameId));
+}
+
+static bool playGame(const QList<LocalServerInterface *> &clients, LocalServerInterface *spectator, int turns)
+{
+	sendCommand(clients[0], new Command_CreateGame(0, "benchmark", QString(), clients.size(), true, false, true, false));
+	Server_Game *game = server->getRooms().value(0)->getGames().values().last();
+	const int gameId = game->getGameId();
+	for (int i = 1; i < clients.size(); ++i)
+		sendCommand(clients[i], new Command_JoinGame(0, gameId, QString(), false));
+
+	// The command takes ownership of the deck.
+	for (int i = 0; i < clients.size(); ++i) {
+		sendCommand(clients[i], new Command_DeckSelect(gameId, newDeck()));
+		sendCommand(clients[i], new Command_ReadyStart(gameId, true));
+	}
+	if (!game->getGameStarted())
+		return false;
+
+	const QList<Server_Player *> players = game->getPlayers().values();
+	for (int i = 0; i < clients.size(); ++i)
+		sendCommand(clients[i], new Command_Mulligan(gameId));
+	for (int turn = 0; turn < turns; ++turn)
+		playTurn(game, players, spectator, turn);
+
+	for (int i = 0; i < clients.size(); ++i)
+		sendCommand(clients[i], new Command_LeaveGame(gameId));
+	QCoreApplication::sendPostedEvents(0, QEvent::DeferredDelete);
+	return true;
+}
+
+static void report(const QString &name, const CommandTotals &t, const QString &unit)
+{
+	const int count = qMax(t.count, 1);
+	std::cout << name.toStdString()
+		<< ": " << t.count << " " << unit.toStdString() << "s, "
+		<< (t.nsecs / count) << " ns/" << unit.toStdString() << ", "
+		<< ((double) t.allocations / count) << " allocations/" << unit.toStdString() << " ("
+		<< ((double) t.heapAllocations / count) << " from the heap)"
+		<< std::endl;
+}
+
+int main(int argc, char *argv[])
+{
+	QCoreApplication app(argc, argv);
+	qInstallMsgHandler(messageOutput);
+	QStringList args = app.arguments();
+	const int games = args.size() > 1 ? args[1].toInt() : 1000;
+	const int turns = args.size() > 2 ? args[2].toInt() : 40;
+	const int playerCount = qMax(args.size() > 3 ? args[3].toInt() : 2, 1);
+
+	rng = new RNG_SFMT;
+	ProtocolItem::initializeHash();
+	server = new LocalServer;
+	checker = new ResponseChecker;
+
+	QList<LocalServerInterface *> clients;
+	for (int i = 0; i < playerCount; ++i)
+		clients.append(newClient(QString("Player %1").arg(i)));
+	LocalServerInterface *spectator = newClient("Spectator");
+
+	for (int i = 0; i < games; ++i)
+		if (!playGame(clients, spectator, turns)) {
+			std::cerr << "game " << i << " did not start" << std::endl;
+			return 1;
+		}
+
+	std::cout << games << " games of " << turns << " turns with " << playerCount << " players" << std::endl;
+	CommandTotals all;
+	QMapIterator<QString, CommandTotals> totalsIterator(totals);
+	while (totalsIterator.hasNext()) {
+		totalsIterator.next();
+		// getGameState is already part of the commands that call it.
+		if (totalsIterator.key() == "Server_Game::getGameState")
+			report(totalsIterator.key(), totalsIterator.value(), "call");
+		else {
+			report(totalsIterator.key(), totalsIterator.value(), "command");
+			all.add(totalsIterator.value());
+		}
+	}
+	report("all commands", all, "command");
+	if (checker->getFailures())
+		std::cout << checker->getFailures() << " commands failed" << std::endl;
+
+	delete server;
+	delete checker;
+	delete rng;
+	return 0;
+}
+
+#include "main.moc"
@@ -7,6 +7,10 @@ OBJECTS_DIR = build
 RESOURCES = cockatrice.qrc
 QT += network svg
 
+# Stream compression needs zlib, which Qt bundles on Windows.
+unix:LIBS += -lz
+win32:INCLUDEPATH += $$[QT_INSTALL_PREFIX]/src/3rdparty/zlib
+
 HEADERS += src/abstractcounter.h \
  src/counter_general.h \
  src/dlg_creategame.h \
@@ -15,6 +19,7 @@ HEADERS += src/abstractcounter.h \
  src/gamesmodel.h \
  src/abstractclient.h \
  src/remoteclient.h \
+ src/remoteclientconnection.h \
  src/window_main.h \
  src/cardzone.h \
  src/selectzone.h \
@@ -39,6 +44,8 @@ HEADERS += src/abstractcounter.h \
  src/stackzone.h \
  src/carddragitem.h \
  src/carddatabasemodel.h \
+ src/cardsearchindex.h \
+ src/cardquery.h \
  src/window_deckeditor.h \
  src/setsmodel.h \
  src/window_sets.h \
@@ -60,6 +67,7 @@ HEADERS += src/abstractcounter.h \
  src/tab_admin.h \
  src/userlist.h \
  src/userinfobox.h \
+ src/avatarcache.h \
  src/remotedecklist_treewidget.h \
  src/deckview.h \
  src/playerlistwidget.h \
@@ -71,6 +79,8 @@ HEADERS += src/abstractcounter.h \
  src/translation.h \
  	../common/color.h \
  	../common/serializable_item.h \
+	../common/stream_compression.h \
+	../common/serializable_arena.h \
 	../common/decklist.h \
 	../common/protocol.h \
 	../common/protocol_items.h \
@@ -80,8 +90,11 @@ HEADERS += src/abstractcounter.h \
 	../common/server.h \
 	../common/server_arrow.h \
 	../common/server_card.h \
+	../common/server_cardpool.h \
 	../common/server_cardzone.h \
 	../common/server_room.h \
+	../common/server_presence.h \
+	../common/server_timerwheel.h \
 	../common/server_counter.h \
 	../common/server_game.h \
 	../common/server_player.h \
@@ -95,6 +108,7 @@ SOURCES += src/abstractcounter.cpp \
  src/dlg_create_token.cpp \
  src/abstractclient.cpp \
  src/remoteclient.cpp \
+ src/remoteclientconnection.cpp \
  src/main.cpp \
  src/window_main.cpp \
  src/gamesmodel.cpp \
@@ -121,6 +135,8 @@ SOURCES += src/abstractcounter.cpp \
  src/stackzone.cpp \
  src/carddragitem.cpp \
  src/carddatabasemodel.cpp \
+ src/cardsearchindex.cpp \
+ src/cardquery.cpp \
  src/window_deckeditor.cpp \
  src/setsmodel.cpp \
  src/window_sets.cpp \
@@ -141,6 +157,7 @@ SOURCES += src/abstractcounter.cpp \
  src/tab_admin.cpp \
  src/userlist.cpp \
  src/userinfobox.cpp \
+ src/avatarcache.cpp \
  src/remotedecklist_treewidget.cpp \
  src/deckview.cpp \
  src/playerlistwidget.cpp \
@@ -150,6 +167,8 @@ SOURCES += src/abstractcounter.cpp \
  src/localserverinterface.cpp \
  src/localclient.cpp \
  	../common/serializable_item.cpp \
+	../common/stream_compression.cpp \
+	../common/serializable_arena.cpp \
 	../common/decklist.cpp \
 	../common/protocol.cpp \
 	../common/protocol_items.cpp \
@@ -159,8 +178,11 @@ SOURCES += src/abstractcounter.cpp \
 	../common/sfmt/SFMT.c \
 	../common/server.cpp \
 	../common/server_card.cpp \
+	../common/server_cardpool.cpp \
 	../common/server_cardzone.cpp \
 	../common/server_room.cpp \
+	../common/server_presence.cpp \
+	../common/server_timerwheel.cpp \
 	../common/server_game.cpp \
 	../common/server_player.cpp \
 	../common/server_protocolhandler.cpp
@@ -1,4 +1,5 @@
 #include <QPainter>
+#include <QPixmapCache>
 #include <QGraphicsScene>
 #include <QCursor>
 #include <QStyleOptionGraphicsItem>
@@ -8,6 +9,7 @@
 #include "cardinfowidget.h"
 #include "abstractcarditem.h"
 #include "settingscache.h"
+#include "gamescene.h"
 #include "main.h"
 #include <QDebug>
 #include <QTimer>
@@ -76,55 +78,118 @@ void AbstractCardItem::transformPainter(QPainter *painter, const QSizeF &transla
 	painter->setFont(f);
 }
 
+void AbstractCardItem::getFrameColors(QColor &bgColor, QColor &textColor) const
+{
+	QString colorStr;
+	if (!color.isEmpty())
+		colorStr = color;
+	else if (info->getColors().size() > 1)
+		colorStr = "m";
+	else if (!info->getColors().isEmpty())
+		colorStr = info->getColors().first().toLower();
+	
+	textColor = Qt::white;
+	if (colorStr == "b")
+		bgColor = QColor(0, 0, 0);
+	else if (colorStr == "u")
+		bgColor = QColor(0, 140, 180);
+	else if (colorStr == "w") {
+		bgColor = QColor(255, 250, 140);
+		textColor = Qt::black;
+	} else if (colorStr == "r")
+		bgColor = QColor(230, 0, 0);
+	else if (colorStr == "g")
+		bgColor = QColor(0, 160, 0);
+	else if (colorStr == "m") {
+		bgColor = QColor(250, 190, 30);
+		textColor = Qt::black;
+	} else {
+		bgColor = QColor(230, 230, 230);
+		textColor = Qt::black;
+	}
+}
+
+// Cards without a picture show their name on a coloured frame. Laying out
+// the wrapped text is expensive, so the frame is rendered once per size and
+// kept in the global pixmap cache.
+QPixmap AbstractCardItem::getLabelPixmap(const QSize &size) const
+{
+	QColor bgColor, textColor;
+	getFrameColors(bgColor, textColor);
+	
+	const QString key = QString("card_label_%1_%2_%3x%4").arg(name).arg(bgColor.rgb()).arg(size.width()).arg(size.height());
+	QPixmap result;
+	if (QPixmapCache::find(key, result))
+		return result;
+	
+	const qreal scaleFactor = (qreal) size.width() / CARD_WIDTH;
+	result = QPixmap(size);
+	result.fill(Qt::transparent);
+	QPainter painter(&result);
+	painter.setBrush(bgColor);
+	QPen pen(Qt::black);
+	pen.setWidthF(2 * scaleFactor);
+	painter.setPen(pen);
+	painter.drawRect(QRectF(scaleFactor, scaleFactor, size.width() - 2 * scaleFactor, size.height() - 2 * scaleFactor));
+	
+	QFont f;
+	int fontSize = size.height() / 6;
+	if (fontSize < 9)
+		fontSize = 9;
+	f.setPixelSize(fontSize);
+	painter.setFont(f);
+	painter.setPen(textColor);
+	painter.drawText(QRectF(4 * scaleFactor, 4 * scaleFactor, size.width() - 8 * scaleFactor, size.height() - 8 * scaleFactor), Qt::AlignTop | Qt::AlignLeft | Qt::TextWrapAnywhere, name);
+	painter.end();
+	
+	QPixmapCache::insert(key, result);
+	return result;
+}
+
 void AbstractCardItem::paintPicture(QPainter *painter, int angle)
 {
 	QSizeF translatedSize = getTranslatedSize(painter);
-	QRectF totalBoundingRect = painter->combinedTransform().mapRect(boundingRect());
-	qreal scaleFactor = translatedSize.width() / boundingRect().width();
-
-        QPixmap *translatedPixmap = info->getPixmap(translatedSize.toSize(), false);
+	
 	painter->save();
-	if (translatedPixmap) {
-		transformPainter(painter, translatedSize, angle);
-		painter->drawPixmap(QPointF(0, 0), *translatedPixmap);
-	} else {
-		QString colorStr;
-		if (!color.isEmpty())
-			colorStr = color;
-		else if (info->getColors().size() > 1)
-			colorStr = "m";
-		else if (!info->getColors().isEmpty())
-			colorStr = info->getColors().first().toLower();
-		
-		QColor bgColor;
-		QColor textColor = Qt::white;
-		if (colorStr == "b")
-			bgColor = QColor(0, 0, 0);
-		else if (colorStr == "u")
-			bgColor = QColor(0, 140, 180);
-		else if (colorStr == "w") {
-			bgColor = QColor(255, 250, 140);
-			textColor = Qt::black;
-		} else if (colorStr == "r")
-			bgColor = QColor(230, 0, 0);
-		else if (colorStr == "g")
-			bgColor = QColor(0, 160, 0);
-		else if (colorStr == "m") {
-			bgColor = QColor(250, 190, 30);
-			textColor = Qt::black;
+	if (translatedSize.width() < farDetailWidth) {
+		// Far away: a thumbnail if the picture is there, otherwise a plain frame.
+		QSize thumbnailSize(CARD_WIDTH >> (mipLevelCount - 1), CARD_HEIGHT >> (mipLevelCount - 1));
+		QPixmap *thumbnail = info->getPixmap(thumbnailSize, false);
+		if (thumbnail) {
+			transformPainter(painter, translatedSize, angle);
+			painter->setRenderHint(QPainter::SmoothPixmapTransform);
+			painter->drawPixmap(QRectF(QPointF(0, 0), translatedSize), *thumbnail, QRectF(thumbnail->rect()));
 		} else {
-			bgColor = QColor(230, 230, 230);
-			textColor = Qt::black;
+			QColor bgColor, textColor;
+			getFrameColors(bgColor, textColor);
+			painter->setPen(Qt::NoPen);
+			painter->setBrush(bgColor);
+			painter->drawRect(boundingRect());
+		}
+	} else {
+		// Up to full size, the picture is scaled down from the next larger
+		// mip level. Beyond that, it is rendered at the exact size.
+		QSize pixmapSize = translatedSize.toSize();
+		if (translatedSize.width() < CARD_WIDTH) {
+			int level = mipLevelCount - 1;
+			while ((level > 0) && ((CARD_WIDTH >> level) < translatedSize.width()))
+				--level;
+			pixmapSize = QSize(CARD_WIDTH >> level, CARD_HEIGHT >> level);
 		}
-		painter->setBrush(bgColor);
-		QPen pen(Qt::black);
-		pen.setWidth(2);
-		painter->setPen(pen);
-		painter->drawRect(QRectF(1, 1, CARD_WIDTH - 2, CARD_HEIGHT - 2));
 		
+		QPixmap *cardPixmap = info->getPixmap(pixmapSize, false);
+		QPixmap labelPixmap;
+		if (!cardPixmap) {
+			labelPixmap = getLabelPixmap(pixmapSize);
+			cardPixmap = &labelPixmap;
+		}
 		transformPainter(painter, translatedSize, angle);
-		painter->setPen(textColor);
-		painter->drawText(QRectF(4 * scaleFactor, 4 * scaleFactor, translatedSize.width() - 8 * scaleFactor, translatedSize.height() - 8 * scaleFactor), Qt::AlignTop | Qt::AlignLeft | Qt::TextWrapAnywhere, name);
+		if (cardPixmap->size() == translatedSize.toSize())
+			painter->drawPixmap(QPointF(0, 0), *cardPixmap);
+		else {
+			painter->setRenderHint(QPainter::SmoothPixmapTransform);
+			painter->drawPixmap(QRectF(QPointF(0, 0), translatedSize), *cardPixmap, QRectF(cardPixmap->rect()));
+		}
 	}
 	painter->restore();
 }
@@ -195,6 +260,9 @@ void AbstractCardItem::setTapped(bool _tapped, bool canAnimate)
 		return;
 	
 	tapped = _tapped;
+	GameScene *gameScene = qobject_cast<GameScene *>(scene());
+	if (gameScene && gameScene->getSuspended())
+		canAnimate = false;
 	if (settingsCache->getTapAnimation() && canAnimate)
 		animationTimer->start(25);
 	else {
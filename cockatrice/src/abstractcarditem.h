@@ -21,12 +21,21 @@ protected:
 	int tapAngle;
 	QString color;
 private:
+	// Below farDetailWidth device pixels, cards are drawn as thumbnails or
+	// plain frames. Below CARD_WIDTH, the picture is taken from one of
+	// mipLevelCount sizes, each twice as wide as the previous one, so that
+	// zooming does not create a new scaled pixmap for every scale.
+	static const int farDetailWidth = 20;
+	static const int mipLevelCount = 3;
 	QTimer *animationTimer;
 	bool isHovered;
 	qreal realZValue;
 private slots:
 	void animationEvent();
 	void pixmapUpdated();
+private:
+	void getFrameColors(QColor &bgColor, QColor &textColor) const;
+	QPixmap getLabelPixmap(const QSize &size) const;
 signals:
 	void hovered(AbstractCardItem *card);
 	void showCardInfoPopup(QPoint pos, QString cardName);
@@ -1,11 +1,13 @@
 #include "abstractclient.h"
 #include "protocol.h"
 #include "protocol_items.h"
+#include "avatarcache.h"
 #include <QDebug>
 
 AbstractClient::AbstractClient(QObject *parent)
 	: QObject(parent), status(StatusDisconnected)
 {
+	avatarCache = new AvatarCache(this);
 }
 
 AbstractClient::~AbstractClient()
@@ -32,8 +34,7 @@ void AbstractClient::processProtocolItem(ProtocolItem *item)
 	GenericEvent *genericEvent = qobject_cast<GenericEvent *>(item);
 	if (genericEvent) {
 		switch (genericEvent->getItemId()) {
-			case ItemId_Event_UserJoined: emit userJoinedEventReceived(qobject_cast<Event_UserJoined *>(item)); break;
-			case ItemId_Event_UserLeft: emit userLeftEventReceived(qobject_cast<Event_UserLeft *>(item)); break;
+			case ItemId_Event_UserListChanged: emit userListChangedEventReceived(qobject_cast<Event_UserListChanged *>(item)); break;
 			case ItemId_Event_ServerMessage: emit serverMessageEventReceived(qobject_cast<Event_ServerMessage *>(item)); break;
 			case ItemId_Event_ListRooms: emit listRoomsEventReceived(qobject_cast<Event_ListRooms *>(item)); break;
 			case ItemId_Event_GameJoined: emit gameJoinedEventReceived(qobject_cast<Event_GameJoined *>(item)); break;
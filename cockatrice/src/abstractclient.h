@@ -4,6 +4,7 @@
 #include <QObject>
 #include "protocol_datastructures.h"
 
+class AvatarCache;
 class Command;
 class CommandContainer;
 class ProtocolItem;
@@ -13,8 +14,7 @@ class CommandContainer;
 class RoomEvent;
 class GameEventContainer;
 class Event_ListGames;
-class Event_UserJoined;
-class Event_UserLeft;
+class Event_UserListChanged;
 class Event_ServerMessage;
 class Event_ListRooms;
 class Event_GameJoined;
@@ -40,8 +40,7 @@ signals:
 	// Game events
 	void gameEventContainerReceived(GameEventContainer *event);
 	// Generic events
-	void userJoinedEventReceived(Event_UserJoined *event);
-	void userLeftEventReceived(Event_UserLeft *event);
+	void userListChangedEventReceived(Event_UserListChanged *event);
 	void serverMessageEventReceived(Event_ServerMessage *event);
 	void listRoomsEventReceived(Event_ListRooms *event);
 	void gameJoinedEventReceived(Event_GameJoined *event);
@@ -53,12 +52,14 @@ protected:
 	QMap<int, CommandContainer *> pendingCommands;
 	ClientStatus status;
 	QString userName, password;
+	AvatarCache *avatarCache;
 	void setStatus(ClientStatus _status);
 public:
 	AbstractClient(QObject *parent = 0);
 	~AbstractClient();
 	
 	ClientStatus getStatus() const { return status; }
+	AvatarCache *getAvatarCache() const { return avatarCache; }
 	virtual void sendCommand(Command *cmd);
 	virtual void sendCommandContainer(CommandContainer *cont) = 0;
 };
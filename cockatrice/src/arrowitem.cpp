@@ -3,6 +3,7 @@
 #include "carditem.h"
 #include "cardzone.h"
 #include "player.h"
+#include "gamescene.h"
 #include "math.h"
 #include "protocol_items.h"
 #include <QPainter>
@@ -11,7 +12,7 @@
 #include <QDebug>
 
 ArrowItem::ArrowItem(Player *_player, int _id, ArrowTarget *_startItem, ArrowTarget *_targetItem, const QColor &_color)
-        : QGraphicsItem(), player(_player), id(_id), startItem(_startItem), targetItem(_targetItem), color(_color), fullColor(true)
+        : QGraphicsItem(), pathLength(-1), pathDirty(false), updatePending(false), player(_player), id(_id), startItem(_startItem), targetItem(_targetItem), color(_color), fullColor(true)
 {
 	qDebug() << "ArrowItem constructor: startItem=" << static_cast<QGraphicsItem *>(startItem);
 	setZValue(2000000005);
@@ -56,51 +57,106 @@ void ArrowItem::updatePath()
 	updatePath(endPoint);
 }
 
-void ArrowItem::updatePath(const QPointF &endPoint)
+void ArrowItem::scheduleUpdatePath()
+{
+	if (updatePending)
+		return;
+	updatePending = true;
+	QMetaObject::invokeMethod(this, "deferredUpdatePath", Qt::QueuedConnection);
+}
+
+void ArrowItem::deferredUpdatePath()
+{
+	GameScene *gameScene = qobject_cast<GameScene *>(scene());
+	if (gameScene && gameScene->getSuspended())
+		return;
+	processPendingUpdatePath();
+}
+
+void ArrowItem::processPendingUpdatePath()
+{
+	if (!updatePending)
+		return;
+	updatePending = false;
+	updatePath();
+}
+
+void ArrowItem::calculateGeometry(qreal lineLength)
 {
 	const double arrowWidth = 15.0;
 	const double headWidth = 40.0;
 	const double headLength = headWidth / sqrt(2);
 	const double phi = 15;
 	
-	if (!startItem)
+	prepareGeometryChange();
+	pathLength = lineLength;
+	pathDirty = true;
+	if (lineLength < 30) {
+		bRect = QRectF();
 		return;
+	}
 	
-	QPointF startPoint = startItem->mapToScene(QPointF(startItem->boundingRect().width() / 2, startItem->boundingRect().height() / 2));
-	QLineF line(startPoint, endPoint);
-	qreal lineLength = line.length();
+	// The center line is the quadratic bezier curve from (0, 0) through
+	// controlPoint to (lineLength, 0). Its points and tangents are
+	// evaluated directly instead of through a QPainterPath.
+	const QPointF endPoint(lineLength, 0);
+	controlPoint = QPointF(lineLength / 2, tan(phi * M_PI / 180) * lineLength);
 	
-	prepareGeometryChange();
-	if (lineLength < 30)
+	const double t = 1 - headLength / lineLength;
+	QPointF arrowBodyEndPoint = 2 * (1 - t) * t * controlPoint + t * t * endPoint;
+	QPointF tangent = 2 * (1 - t) * controlPoint + 2 * t * (endPoint - controlPoint);
+	qreal alpha = atan2(-tangent.y(), tangent.x()) * 180 / M_PI - 90;
+	QPointF normal(cos(alpha * M_PI / 180), -sin(alpha * M_PI / 180));
+	bodyEndPoint1 = arrowBodyEndPoint + arrowWidth / 2 * normal;
+	bodyEndPoint2 = arrowBodyEndPoint - arrowWidth / 2 * normal;
+	headPoint1 = bodyEndPoint1 + (headWidth - arrowWidth) / 2 * normal;
+	headPoint2 = bodyEndPoint2 - (headWidth - arrowWidth) / 2 * normal;
+	
+	startPoint2 = arrowWidth / 2 * QPointF(cos((phi - 90) * M_PI / 180), sin((phi - 90) * M_PI / 180));
+	startPoint1 = -startPoint2;
+	
+	// The curves lie within the convex hull of their control points.
+	QPolygonF hull;
+	hull << startPoint1 << startPoint2 << controlPoint << bodyEndPoint1 << bodyEndPoint2 << headPoint1 << headPoint2 << endPoint;
+	bRect = hull.boundingRect();
+}
+
+const QPainterPath &ArrowItem::getPath() const
+{
+	if (pathDirty) {
 		path = QPainterPath();
-	else {
-		QPointF c(lineLength / 2, tan(phi * M_PI / 180) * lineLength);
-		
-		QPainterPath centerLine;
-		centerLine.moveTo(0, 0);
-		centerLine.quadTo(c, QPointF(lineLength, 0));
-		
-		double percentage = 1 - headLength / lineLength;
-		QPointF arrowBodyEndPoint = centerLine.pointAtPercent(percentage);
-		QLineF testLine(arrowBodyEndPoint, centerLine.pointAtPercent(percentage + 0.001));
-		qreal alpha = testLine.angle() - 90;
-		QPointF endPoint1 = arrowBodyEndPoint + arrowWidth / 2 * QPointF(cos(alpha * M_PI / 180), -sin(alpha * M_PI / 180));
-		QPointF endPoint2 = arrowBodyEndPoint + arrowWidth / 2 * QPointF(-cos(alpha * M_PI / 180), sin(alpha * M_PI / 180));
-		QPointF point1 = endPoint1 + (headWidth - arrowWidth) / 2 * QPointF(cos(alpha * M_PI / 180), -sin(alpha * M_PI / 180));
-		QPointF point2 = endPoint2 + (headWidth - arrowWidth) / 2 * QPointF(-cos(alpha * M_PI / 180), sin(alpha * M_PI / 180));
-		
-		path = QPainterPath(-arrowWidth / 2 * QPointF(cos((phi - 90) * M_PI / 180), sin((phi - 90) * M_PI / 180)));
-		path.quadTo(c, endPoint1);
-		path.lineTo(point1);
-		path.lineTo(QPointF(lineLength, 0));
-		path.lineTo(point2);
-		path.lineTo(endPoint2);
-		path.quadTo(c, arrowWidth / 2 * QPointF(cos((phi - 90) * M_PI / 180), sin((phi - 90) * M_PI / 180)));
-		path.lineTo(-arrowWidth / 2 * QPointF(cos((phi - 90) * M_PI / 180), sin((phi - 90) * M_PI / 180)));
+		if (!bRect.isNull()) {
+			path.moveTo(startPoint1);
+			path.quadTo(controlPoint, bodyEndPoint1);
+			path.lineTo(headPoint1);
+			path.lineTo(QPointF(pathLength, 0));
+			path.lineTo(headPoint2);
+			path.lineTo(bodyEndPoint2);
+			path.quadTo(controlPoint, startPoint2);
+			path.lineTo(startPoint1);
+		}
+		pathDirty = false;
 	}
+	return path;
+}
+
+void ArrowItem::updatePath(const QPointF &endPoint)
+{
+	if (!startItem)
+		return;
+	
+	QPointF startPoint = startItem->mapToScene(QPointF(startItem->boundingRect().width() / 2, startItem->boundingRect().height() / 2));
+	QLineF line(startPoint, endPoint);
 	
-	setPos(startPoint);
-	setTransform(QTransform().rotate(-line.angle()));
+	// Nothing needs to be done if neither end of the arrow has moved,
+	// and the outline is kept as long as the length stays the same.
+	if (line.length() != pathLength)
+		calculateGeometry(line.length());
+	if (pos() != startPoint)
+		setPos(startPoint);
+	QTransform transform = QTransform().rotate(-line.angle());
+	if (transform != this->transform())
+		setTransform(transform);
 }
 
 void ArrowItem::paint(QPainter *painter, const QStyleOptionGraphicsItem * /*option*/, QWidget * /*widget*/)
@@ -111,7 +167,7 @@ void ArrowItem::paint(QPainter *painter, const QStyleOptionGraphicsItem * /*opti
 	else
 		paintColor.setAlpha(150);
 	painter->setBrush(paintColor);
-	painter->drawPath(path);
+	painter->drawPath(getPath());
 }
 
 void ArrowItem::mousePressEvent(QGraphicsSceneMouseEvent *event)
@@ -11,9 +11,22 @@ class ArrowTarget;
 
 class ArrowItem : public QObject, public QGraphicsItem {
 	Q_OBJECT
+private slots:
+	void deferredUpdatePath();
 private:
-	QPainterPath path;
+	// The shape of the arrow only depends on its length; position and
+	// direction are applied through the item transformation. The outline
+	// is described by a few points and is only turned into a QPainterPath
+	// when it is painted or hit-tested.
+	qreal pathLength;
+	QPointF controlPoint, startPoint1, startPoint2, bodyEndPoint1, bodyEndPoint2, headPoint1, headPoint2;
+	QRectF bRect;
+	mutable QPainterPath path;
+	mutable bool pathDirty;
+	bool updatePending;
 	QMenu *menu;
+	void calculateGeometry(qreal lineLength);
+	const QPainterPath &getPath() const;
 protected:
 	Player *player;
 	int id;
@@ -25,10 +38,13 @@ public:
 	ArrowItem(Player *_player, int _id, ArrowTarget *_startItem, ArrowTarget *_targetItem, const QColor &color);
 	~ArrowItem();
 	void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget);
-	QRectF boundingRect() const { return path.boundingRect(); }
-	QPainterPath shape() const { return path; }
+	QRectF boundingRect() const { return bRect; }
+	QPainterPath shape() const { return getPath(); }
 	void updatePath();
 	void updatePath(const QPointF &endPoint);
+	// Updates the path once control returns to the event loop.
+	void scheduleUpdatePath();
+	void processPendingUpdatePath();
 	
 	int getId() const { return id; }
 	Player *getPlayer() const { return player; }
@@ -0,0 +1,110 @@
+#include "avatarcache.h"
+#include "protocol.h"
+#include "protocol_items.h"
+#include "protocol_datastructures.h"
+#include <QDesktopServices>
+#include <QDir>
+#include <QFile>
+
+AvatarCache::AvatarCache(AbstractClient *_client)
+	: QObject(_client), client(_client), memoryCache(4 * 1024 * 1024)
+{
+	cacheDir = QDesktopServices::storageLocation(QDesktopServices::DataLocation) + "/avatars";
+	connect(client, SIGNAL(statusChanged(ClientStatus)), this, SLOT(clientStatusChanged(ClientStatus)));
+}
+
+void AvatarCache::clientStatusChanged(ClientStatus status)
+{
+	// Outstanding requests die with the connection, and a different server may know different avatars.
+	if (status == StatusDisconnected) {
+		pendingHashes.clear();
+		unavailableHashes.clear();
+	}
+}
+
+bool AvatarCache::isValidHash(const QString &avatarHash)
+{
+	// The hash is used as a file name, so only accept what calculateAvatarHash() can produce.
+	if (avatarHash.size() != 40)
+		return false;
+	for (int i = 0; i < avatarHash.size(); ++i) {
+		const QChar c = avatarHash[i];
+		if (!(((c >= '0') && (c <= '9')) || ((c >= 'a') && (c <= 'f'))))
+			return false;
+	}
+	return true;
+}
+
+QString AvatarCache::getFileName(const QString &avatarHash) const
+{
+	return cacheDir + "/" + avatarHash;
+}
+
+void AvatarCache::insertIntoMemoryCache(const QString &avatarHash, const QByteArray &avatarBmp)
+{
+	memoryCache.insert(avatarHash, new QByteArray(avatarBmp), avatarBmp.size());
+}
+
+void AvatarCache::saveToDisk(const QString &avatarHash, const QByteArray &avatarBmp)
+{
+	if (!QDir().mkpath(cacheDir))
+		return;
+	
+	// Write to a temporary file first so that an interrupted write never leaves a truncated avatar behind.
+	QFile file(getFileName(avatarHash) + ".part");
+	if (!file.open(QIODevice::WriteOnly))
+		return;
+	const bool ok = (file.write(avatarBmp) == avatarBmp.size());
+	file.close();
+	if (ok) {
+		QFile::remove(getFileName(avatarHash));
+		file.rename(getFileName(avatarHash));
+	} else
+		file.remove();
+}
+
+QByteArray AvatarCache::getAvatar(const QString &avatarHash)
+{
+	if (!isValidHash(avatarHash))
+		return QByteArray();
+	
+	QByteArray *cached = memoryCache.object(avatarHash);
+	if (cached)
+		return *cached;
+	
+	QFile file(getFileName(avatarHash));
+	if (file.open(QIODevice::ReadOnly)) {
+		QByteArray avatarBmp = file.readAll();
+		if (ServerInfo_User::calculateAvatarHash(avatarBmp) == avatarHash) {
+			insertIntoMemoryCache(avatarHash, avatarBmp);
+			return avatarBmp;
+		}
+		file.close();
+		file.remove();
+	}
+	
+	if (!pendingHashes.contains(avatarHash) && !unavailableHashes.contains(avatarHash)) {
+		pendingHashes.insert(avatarHash);
+		Command_GetAvatar *command = new Command_GetAvatar(avatarHash);
+		connect(command, SIGNAL(finished(ProtocolResponse *)), this, SLOT(avatarResponse(ProtocolResponse *)));
+		client->sendCommand(command);
+	}
+	return QByteArray();
+}
+
+void AvatarCache::avatarResponse(ProtocolResponse *r)
+{
+	Command_GetAvatar *command = static_cast<Command_GetAvatar *>(sender());
+	const QString avatarHash = command->getAvatarHash();
+	pendingHashes.remove(avatarHash);
+	
+	Response_GetAvatar *response = qobject_cast<Response_GetAvatar *>(r);
+	if (!response || (ServerInfo_User::calculateAvatarHash(response->getAvatarBmp()) != avatarHash)) {
+		unavailableHashes.insert(avatarHash);
+		return;
+	}
+	
+	insertIntoMemoryCache(avatarHash, response->getAvatarBmp());
+	saveToDisk(avatarHash, response->getAvatarBmp());
+	emit avatarLoaded(avatarHash);
+}
@@ -0,0 +1,39 @@
+#ifndef AVATARCACHE_H
+#define AVATARCACHE_H
+
+#include <QObject>
+#include <QCache>
+#include <QSet>
+#include <QByteArray>
+#include "abstractclient.h"
+
+class ProtocolResponse;
+
+// User records only carry the SHA-1 hash of the avatar image. This class
+// resolves such hashes to image data, first from memory, then from the disk
+// cache shared by all clients, and finally by asking the server.
+class AvatarCache : public QObject {
+	Q_OBJECT
+private:
+	AbstractClient *client;
+	QString cacheDir;
+	QCache<QString, QByteArray> memoryCache;
+	QSet<QString> pendingHashes, unavailableHashes;
+	
+	static bool isValidHash(const QString &avatarHash);
+	QString getFileName(const QString &avatarHash) const;
+	void insertIntoMemoryCache(const QString &avatarHash, const QByteArray &avatarBmp);
+	void saveToDisk(const QString &avatarHash, const QByteArray &avatarBmp);
+private slots:
+	void clientStatusChanged(ClientStatus status);
+	void avatarResponse(ProtocolResponse *r);
+signals:
+	void avatarLoaded(const QString &avatarHash);
+public:
+	AvatarCache(AbstractClient *_client);
+	// Returns an empty array if the avatar is not available yet. In that case it is requested
+	// from the server and avatarLoaded() is emitted once it has arrived.
+	QByteArray getAvatar(const QString &avatarHash);
+};
+
+#endif
@@ -79,23 +79,22 @@ void PictureLoadingThread::run()
 			mutex.unlock();
 			return;
 		}
-                QPair<CardInfo*, bool> queueItem = loadQueue.takeFirst();
-                CardInfo *card = queueItem.first;
-                bool stripped = queueItem.second;
-		QString correctedName = card->getCorrectedName();
+		PictureToLoad queueItem = loadQueue.takeFirst();
+		CardInfo *card = queueItem.card;
+		bool stripped = queueItem.stripped;
+		const QString &correctedName = queueItem.correctedName;
+		const QStringList &setNames = queueItem.setNames;
 		QString picsPath = _picsPath;
-		SetList sortedSets = card->getSets();
 		mutex.unlock();
 		
-		sortedSets.sortByKey();
                 QString suffix = "";
                 if (!stripped)
                     suffix = ".full";
 		QImage image;
-		for (int i = 0; i < sortedSets.size(); i++) {
-                        if (image.load(QString("%1/%2/%3%4.jpg").arg(picsPath).arg(sortedSets[i]->getShortName()).arg(correctedName).arg(suffix)))
+		for (int i = 0; i < setNames.size(); i++) {
+                        if (image.load(QString("%1/%2/%3%4.jpg").arg(picsPath).arg(setNames[i]).arg(correctedName).arg(suffix)))
 				break;
-                        if (image.load(QString("%1/%2/%3%4%5.jpg").arg(picsPath).arg(sortedSets[i]->getShortName()).arg(correctedName).arg(1).arg(suffix)))
+                        if (image.load(QString("%1/%2/%3%4%5.jpg").arg(picsPath).arg(setNames[i]).arg(correctedName).arg(1).arg(suffix)))
 				break;
 		}
 		if (image.isNull())
@@ -107,11 +106,17 @@ void PictureLoadingThread::run()
 
 void PictureLoadingThread::loadImage(CardInfo *card, bool stripped)
 {
+	PictureToLoad item;
+	item.card = card;
+	item.stripped = stripped;
+	item.correctedName = card->getCorrectedName();
+	SetList sortedSets = card->getSets();
+	sortedSets.sortByKey();
+	for (int i = 0; i < sortedSets.size(); i++)
+		item.setNames.append(sortedSets[i]->getShortName());
+	
 	QMutexLocker locker(&mutex);
-        QPair<CardInfo*, bool> pair;
-        pair.first = card;
-        pair.second = stripped;
-        loadQueue.append(pair);
+        loadQueue.append(item);
 	
 	if (!isRunning())
 		start(LowPriority);
@@ -123,22 +128,43 @@ void PictureLoadingThread::setPicsPath(const QString &path)
 	_picsPath = path;
 }
 
-CardInfo::CardInfo(CardDatabase *_db, const QString &_name, const QString &_manacost, const QString &_cardtype, const QString &_powtough, const QString &_text, const QStringList &_colors, bool _cipt, int _tableRow, const SetList &_sets, const QString &_picURL, const QString &_picHqURL, const QString &_picStURL)
-        : db(_db), name(_name), sets(_sets), manacost(_manacost), cardtype(_cardtype), powtough(_powtough), text(_text), colors(_colors), picURL(_picURL), picHqURL(_picHqURL), picStURL(_picStURL), cipt(_cipt), tableRow(_tableRow), pixmap(NULL), pixmapSt(NULL)
-{
-	for (int i = 0; i < sets.size(); i++)
-		sets[i]->append(this);
-}
-
-CardInfo::~CardInfo()
+CardInfoData CardInfoData::readFromXml(QXmlStreamReader &xml)
 {
-	clearPixmapCache();
-        clearPixmapStCache();
+	CardInfoData data;
+	while (!xml.atEnd()) {
+		if (xml.readNext() == QXmlStreamReader::EndElement)
+			break;
+		if (xml.name() == "name")
+			data.name = xml.readElementText();
+		else if (xml.name() == "manacost")
+			data.manacost = xml.readElementText();
+		else if (xml.name() == "type")
+			data.cardtype = xml.readElementText();
+		else if (xml.name() == "pt")
+			data.powtough = xml.readElementText();
+		else if (xml.name() == "text")
+			data.text = xml.readElementText();
+		else if (xml.name() == "set")
+			data.setNames << xml.readElementText();
+		else if (xml.name() == "color")
+			data.colors << xml.readElementText();
+		else if (xml.name() == "tablerow")
+			data.tableRow = xml.readElementText().toInt();
+		else if (xml.name() == "picURL")
+			data.picURL = xml.readElementText();
+		else if (xml.name() == "picHqURL")
+			data.picHqURL = xml.readElementText();
+		else if (xml.name() == "picStURL")
+			data.picStURL = xml.readElementText();
+		else if (xml.name() == "cipt")
+			data.cipt = (xml.readElementText() == "1");
+	}
+	return data;
 }
 
-QString CardInfo::getMainCardType() const
+QString CardInfoStore::parseMainCardType(const QString &cardType)
 {
-	QString result = getCardType();
+	QString result = cardType;
 	/*
 	Legendary Artifact Creature - Golem
 	Instant // Instant
@@ -165,9 +191,450 @@ QString CardInfo::getMainCardType() const
 	return result;
 }
 
+int CardInfoStore::parseConvertedManaCost(const QString &manaCost)
+{
+	// 2WW, XRR, (W/U)(W/U), (2/B)
+	int result = 0;
+	int i = 0;
+	while (i < manaCost.size()) {
+		const QChar c = manaCost[i];
+		if (c.isDigit()) {
+			int number = 0;
+			while ((i < manaCost.size()) && manaCost[i].isDigit())
+				number = number * 10 + manaCost[i++].digitValue();
+			result += number;
+			continue;
+		}
+		if (c == '(') {
+			int end = manaCost.indexOf(')', i);
+			if (end == -1)
+				end = manaCost.size();
+			int hybrid = 1;
+			const QStringList parts = manaCost.mid(i + 1, end - i - 1).split('/');
+			for (int j = 0; j < parts.size(); ++j) {
+				bool ok;
+				int number = parts[j].toInt(&ok);
+				if (ok && (number > hybrid))
+					hybrid = number;
+			}
+			result += hybrid;
+			i = end + 1;
+			continue;
+		}
+		const QChar upper = c.toUpper();
+		if ((upper != 'X') && (upper != 'Y') && (upper != 'Z') && upper.isLetter())
+			++result;
+		++i;
+	}
+	return result;
+}
+
+uint CardInfoStore::parseColorMask(const QStringList &colors)
+{
+	uint result = 0;
+	for (int i = 0; i < colors.size(); ++i) {
+		if (colors[i] == "W")
+			result |= ColorWhite;
+		else if (colors[i] == "U")
+			result |= ColorBlue;
+		else if (colors[i] == "B")
+			result |= ColorBlack;
+		else if (colors[i] == "R")
+			result |= ColorRed;
+		else if (colors[i] == "G")
+			result |= ColorGreen;
+	}
+	return result;
+}
+
+uint CardInfoStore::typeFlagFromName(const QString &typeName)
+{
+	const QString name = typeName.toLower();
+	if (name == "artifact")
+		return TypeArtifact;
+	if (name == "creature")
+		return TypeCreature;
+	if (name == "enchantment")
+		return TypeEnchantment;
+	if (name == "instant")
+		return TypeInstant;
+	if (name == "land")
+		return TypeLand;
+	if (name == "planeswalker")
+		return TypePlaneswalker;
+	if (name == "sorcery")
+		return TypeSorcery;
+	if (name == "tribal")
+		return TypeTribal;
+	if (name == "legendary")
+		return TypeLegendary;
+	if (name == "basic")
+		return TypeBasic;
+	if (name == "snow")
+		return TypeSnow;
+	return 0;
+}
+
+uint CardInfoStore::parseTypeMask(const QString &cardType)
+{
+	// Only the part before the subtypes counts: Legendary Artifact Creature - Golem
+	QString types = cardType;
+	int pos;
+	if ((pos = types.indexOf('-')) != -1)
+		types.truncate(pos);
+	
+	uint result = 0;
+	const QStringList words = types.split(' ', QString::SkipEmptyParts);
+	for (int i = 0; i < words.size(); ++i)
+		result |= typeFlagFromName(words[i]);
+	return result;
+}
+
+int CardInfoStore::parsePowTough(const QString &value)
+{
+	bool ok;
+	int result = value.trimmed().toInt(&ok);
+	return ok ? result : NoValue;
+}
+
+const int CardInfoStore::NoValue;
+
+CardInfoStore::CardInfoStore()
+{
+	clear();
+}
+
+void CardInfoStore::clear()
+{
+	strings.clear();
+	stringIds.clear();
+	colorLists.clear();
+	colorListIds.clear();
+	names.clear();
+	texts.clear();
+	picURLs.clear();
+	picHqURLs.clear();
+	picStURLs.clear();
+	manaCostIds.clear();
+	cardTypeIds.clear();
+	mainCardTypeIds.clear();
+	powToughIds.clear();
+	colorListIdColumn.clear();
+	convertedManaCosts.clear();
+	powers.clear();
+	toughnesses.clear();
+	tableRows.clear();
+	colorMasks.clear();
+	typeMasks.clear();
+	cipts.clear();
+}
+
+int CardInfoStore::intern(const QString &str)
+{
+	QHash<QString, int>::const_iterator it = stringIds.constFind(str);
+	if (it != stringIds.constEnd())
+		return it.value();
+	int id = strings.size();
+	strings.append(str);
+	stringIds.insert(str, id);
+	return id;
+}
+
+int CardInfoStore::internColors(const QStringList &colors)
+{
+	const QString key = colors.join(",");
+	QHash<QString, int>::const_iterator it = colorListIds.constFind(key);
+	if (it != colorListIds.constEnd())
+		return it.value();
+	int id = colorLists.size();
+	colorLists.append(colors);
+	colorListIds.insert(key, id);
+	return id;
+}
+
+int CardInfoStore::addCard(const CardInfoData &data)
+{
+	int row = names.size();
+	names.append(data.name);
+	texts.append(QString());
+	picURLs.append(QString());
+	picHqURLs.append(QString());
+	picStURLs.append(QString());
+	manaCostIds.append(0);
+	cardTypeIds.append(0);
+	mainCardTypeIds.append(0);
+	powToughIds.append(0);
+	colorListIdColumn.append(0);
+	convertedManaCosts.append(0);
+	powers.append(NoValue);
+	toughnesses.append(NoValue);
+	tableRows.append(0);
+	colorMasks.append(0);
+	typeMasks.append(0);
+	cipts.append(false);
+	setData(row, data);
+	return row;
+}
+
+void CardInfoStore::setData(int row, const CardInfoData &data)
+{
+	texts[row] = data.text;
+	picURLs[row] = data.picURL;
+	picHqURLs[row] = data.picHqURL;
+	picStURLs[row] = data.picStURL;
+	manaCostIds[row] = intern(data.manacost);
+	cardTypeIds[row] = intern(data.cardtype);
+	mainCardTypeIds[row] = intern(parseMainCardType(data.cardtype));
+	powToughIds[row] = intern(data.powtough);
+	colorListIdColumn[row] = internColors(data.colors);
+	convertedManaCosts[row] = parseConvertedManaCost(data.manacost);
+	int slash = data.powtough.indexOf('/');
+	if (slash == -1) {
+		powers[row] = NoValue;
+		toughnesses[row] = NoValue;
+	} else {
+		powers[row] = parsePowTough(data.powtough.left(slash));
+		toughnesses[row] = parsePowTough(data.powtough.mid(slash + 1));
+	}
+	tableRows[row] = data.tableRow;
+	colorMasks[row] = parseColorMask(data.colors);
+	typeMasks[row] = parseTypeMask(data.cardtype);
+	cipts[row] = data.cipt;
+}
+
+QStringList CardInfoStore::getAllColors() const
+{
+	QSet<QString> colors;
+	QSet<int> seenLists;
+	for (int row = 0; row < names.size(); ++row) {
+		// The card back has no name and does not count.
+		if (names[row].isEmpty())
+			continue;
+		const int listId = colorListIdColumn[row];
+		if (seenLists.contains(listId))
+			continue;
+		seenLists.insert(listId);
+		const QStringList &cardColors = colorLists[listId];
+		if (cardColors.isEmpty())
+			colors.insert("X");
+		else
+			for (int i = 0; i < cardColors.size(); ++i)
+				colors.insert(cardColors[i]);
+	}
+	return colors.toList();
+}
+
+QStringList CardInfoStore::getAllMainCardTypes() const
+{
+	QSet<int> typeIds;
+	for (int row = 0; row < names.size(); ++row)
+		if (!names[row].isEmpty())
+			typeIds.insert(mainCardTypeIds[row]);
+	
+	QStringList result;
+	QSetIterator<int> i(typeIds);
+	while (i.hasNext())
+		result.append(strings[i.next()]);
+	return result;
+}
+
+CardDatabaseLoadingThread::CardDatabaseLoadingThread(QObject *parent)
+	: QThread(parent), generation(0), abortRequested(false)
+{
+}
+
+CardDatabaseLoadingThread::~CardDatabaseLoadingThread()
+{
+	abort();
+}
+
+void CardDatabaseLoadingThread::loadFile(const QString &_fileName, int _generation)
+{
+	abort();
+	
+	QMutexLocker locker(&mutex);
+	fileName = _fileName;
+	generation = _generation;
+	abortRequested = false;
+	start(LowPriority);
+}
+
+void CardDatabaseLoadingThread::abort()
+{
+	mutex.lock();
+	abortRequested = true;
+	mutex.unlock();
+	wait();
+	
+	QMutexLocker locker(&mutex);
+	loadedSets.clear();
+	loadedNames.clear();
+	loadedCards.clear();
+}
+
+bool CardDatabaseLoadingThread::isAborted()
+{
+	QMutexLocker locker(&mutex);
+	return abortRequested;
+}
+
+QList<QPair<QString, QString> > CardDatabaseLoadingThread::takeLoadedSets()
+{
+	QMutexLocker locker(&mutex);
+	QList<QPair<QString, QString> > result = loadedSets;
+	loadedSets.clear();
+	return result;
+}
+
+QStringList CardDatabaseLoadingThread::takeLoadedNames()
+{
+	QMutexLocker locker(&mutex);
+	QStringList result = loadedNames;
+	loadedNames.clear();
+	return result;
+}
+
+QList<CardInfoData> CardDatabaseLoadingThread::takeLoadedCards()
+{
+	QMutexLocker locker(&mutex);
+	QList<CardInfoData> result = loadedCards;
+	loadedCards.clear();
+	return result;
+}
+
+bool CardDatabaseLoadingThread::readIndex(QXmlStreamReader &xml)
+{
+	// First pass: only sets and card names, so that getCard() can hand out
+	// the final CardInfo pointers before the full card data is available.
+	QList<QPair<QString, QString> > sets;
+	QStringList names;
+	while (!xml.atEnd()) {
+		if (xml.readNext() != QXmlStreamReader::StartElement)
+			continue;
+		if (xml.name() == "sets") {
+			while (!xml.atEnd()) {
+				if (xml.readNext() == QXmlStreamReader::EndElement)
+					break;
+				if (xml.name() != "set")
+					continue;
+				QString shortName, longName;
+				while (!xml.atEnd()) {
+					if (xml.readNext() == QXmlStreamReader::EndElement)
+						break;
+					if (xml.name() == "name")
+						shortName = xml.readElementText();
+					else if (xml.name() == "longname")
+						longName = xml.readElementText();
+				}
+				sets.append(qMakePair(shortName, longName));
+			}
+		} else if (xml.name() == "card") {
+			while (!xml.atEnd()) {
+				if (xml.readNext() == QXmlStreamReader::EndElement)
+					break;
+				if (xml.name() == "name")
+					names.append(xml.readElementText());
+				else if (xml.isStartElement())
+					xml.readElementText();
+			}
+			if (isAborted())
+				return false;
+		}
+	}
+	if (xml.hasError())
+		return false;
+	
+	QMutexLocker locker(&mutex);
+	loadedSets = sets;
+	loadedNames = names;
+	return true;
+}
+
+int CardDatabaseLoadingThread::readCards(QXmlStreamReader &xml)
+{
+	int cardCount = 0;
+	QList<CardInfoData> chunk;
+	while (!xml.atEnd()) {
+		if (xml.readNext() != QXmlStreamReader::StartElement)
+			continue;
+		if (xml.name() != "card")
+			continue;
+		chunk.append(CardInfoData::readFromXml(xml));
+		++cardCount;
+		if (chunk.size() == chunkSize) {
+			if (isAborted())
+				return -1;
+			mutex.lock();
+			loadedCards += chunk;
+			mutex.unlock();
+			chunk.clear();
+			emit cardsLoaded(generation);
+		}
+	}
+	if (isAborted())
+		return -1;
+	mutex.lock();
+	loadedCards += chunk;
+	mutex.unlock();
+	emit cardsLoaded(generation);
+	
+	return cardCount;
+}
+
+void CardDatabaseLoadingThread::run()
+{
+	QFile file(fileName);
+	if (!file.open(QIODevice::ReadOnly)) {
+		emit loadingFinished(generation, 0);
+		return;
+	}
+	
+	QXmlStreamReader indexXml(&file);
+	if (!readIndex(indexXml)) {
+		if (!isAborted())
+			emit loadingFinished(generation, 0);
+		return;
+	}
+	emit indexLoaded(generation);
+	
+	file.seek(0);
+	QXmlStreamReader cardXml(&file);
+	int cardCount = readCards(cardXml);
+	if (cardCount == -1)
+		return;
+	emit loadingFinished(generation, cardCount);
+}
+
+CardInfo::CardInfo(CardDatabase *_db, const QString &_name, const QString &_manacost, const QString &_cardtype, const QString &_powtough, const QString &_text, const QStringList &_colors, bool _cipt, int _tableRow, const SetList &_sets, const QString &_picURL, const QString &_picHqURL, const QString &_picStURL)
+        : db(_db), store(_db->getStore()), sets(_sets), pixmap(NULL), pixmapSt(NULL)
+{
+	CardInfoData data;
+	data.name = _name;
+	data.manacost = _manacost;
+	data.cardtype = _cardtype;
+	data.powtough = _powtough;
+	data.text = _text;
+	data.colors = _colors;
+	data.cipt = _cipt;
+	data.tableRow = _tableRow;
+	data.picURL = _picURL;
+	data.picHqURL = _picHqURL;
+	data.picStURL = _picStURL;
+	row = store->addCard(data);
+	
+	for (int i = 0; i < sets.size(); i++)
+		sets[i]->append(this);
+}
+
+CardInfo::~CardInfo()
+{
+	clearPixmapCache();
+        clearPixmapStCache();
+}
+
 QString CardInfo::getCorrectedName() const
 {
-	QString result = name;
+	QString result = getName();
 	// Fire // Ice, Circle of Protection: Red
 	return result.remove(" // ").remove(":");
 }
@@ -178,6 +645,27 @@ void CardInfo::addToSet(CardSet *set)
 	sets << set;
 }
 
+void CardInfo::setData(const CardInfoData &data, const SetList &_sets)
+{
+	store->setData(row, data);
+	// Cards requested before the index was complete were put into the
+	// placeholder set "TK"; only the sets from the database count now.
+	for (int i = sets.size() - 1; i >= 0; --i)
+		if (!_sets.contains(sets[i])) {
+			sets[i]->removeAll(this);
+			sets.removeAt(i);
+		}
+	for (int i = 0; i < _sets.size(); i++)
+		if (!sets.contains(_sets[i]))
+			addToSet(_sets[i]);
+	
+	// The picture may have been requested before the set list was known.
+	bool pixmapMissing = (pixmap && pixmap->isNull()) || (pixmapSt && pixmapSt->isNull());
+	clearPixmapCacheMiss();
+	if (pixmapMissing)
+		emit pixmapUpdated();
+}
+
 QPixmap *CardInfo::loadPixmap(bool stripped)
 {
     if (stripped) {
@@ -222,7 +710,6 @@ void CardInfo::imageLoaded(const QImage &image, bool stripped)
 
 QPixmap *CardInfo::getPixmap(QSize size, bool stripped)
 {
-	qDebug(QString("CardInfo::getPixmap(%1, %2) for %3").arg(size.width()).arg(size.height()).arg(getName()).toLatin1());
         QPixmap *cachedPixmap;
         if (stripped)
             cachedPixmap = scaledPixmapStCache.value(size.width());
@@ -245,16 +732,16 @@ QPixmap *CardInfo::getPixmap(QSize size, bool stripped)
 	} else
 		result = new QPixmap(bigPixmap->scaled(size, Qt::IgnoreAspectRatio, Qt::SmoothTransformation));
         if (stripped)
-            scaledPixmapCache.insert(size.width(), result);
-        else
             scaledPixmapStCache.insert(size.width(), result);
+        else
+            scaledPixmapCache.insert(size.width(), result);
 	return result;
 }
 
 void CardInfo::clearPixmapCache()
 {
 	if (pixmap) {
-		qDebug(QString("Deleting pixmap for %1").arg(name).toLatin1());
+		qDebug(QString("Deleting pixmap for %1").arg(getName()).toLatin1());
 		delete pixmap;
 		pixmap = 0;
 		QMapIterator<int, QPixmap *> i(scaledPixmapCache);
@@ -271,7 +758,7 @@ void CardInfo::clearPixmapCache()
 void CardInfo::clearPixmapStCache()
 {
         if (pixmapSt) {
-                qDebug(QString("Deleting pixmap stripped for %1").arg(name).toLatin1());
+                qDebug(QString("Deleting pixmap stripped for %1").arg(getName()).toLatin1());
                 delete pixmapSt;
                 pixmapSt = 0;
                 QMapIterator<int, QPixmap *> i(scaledPixmapStCache);
@@ -298,7 +785,7 @@ void CardInfo::clearPixmapCacheMiss()
 
 void CardInfo::updatePixmapCache(bool stripped)
 {
-	qDebug(QString("Updating pixmap cache for %1").arg(name).toLatin1());
+	qDebug(QString("Updating pixmap cache for %1").arg(getName()).toLatin1());
         if (stripped)
             clearPixmapStCache();
         else
@@ -337,7 +824,7 @@ QXmlStreamWriter &operator<<(QXmlStreamWriter &xml, const CardInfo *info)
 }
 
 CardDatabase::CardDatabase(QObject *parent)
-        : QObject(parent), downloadRunning(false), failLQ(false), loadSuccess(false), noCard(0)
+        : QObject(parent), downloadRunning(false), loadSuccess(false), failLQ(false), noCard(0), loadGeneration(0), loading(false)
 {
 	connect(settingsCache, SIGNAL(picsPathChanged()), this, SLOT(clearPixmapCache()));
         connect(settingsCache, SIGNAL(picsPathChanged()), this, SLOT(clearPixmapStCache()));
@@ -347,6 +834,11 @@ CardDatabase::CardDatabase(QObject *parent)
 	networkManager = new QNetworkAccessManager(this);
 	connect(networkManager, SIGNAL(finished(QNetworkReply *)), this, SLOT(picDownloadFinished(QNetworkReply *)));
 
+	cardLoadingThread = new CardDatabaseLoadingThread(this);
+	connect(cardLoadingThread, SIGNAL(indexLoaded(int)), this, SLOT(cardIndexLoaded(int)));
+	connect(cardLoadingThread, SIGNAL(cardsLoaded(int)), this, SLOT(cardChunkLoaded(int)));
+	connect(cardLoadingThread, SIGNAL(loadingFinished(int, int)), this, SLOT(cardLoadingFinished(int, int)));
+	
 	loadCardDatabase();
 	
 	loadingThread = new PictureLoadingThread(this);
@@ -361,6 +853,7 @@ CardDatabase::CardDatabase(QObject *parent)
 
 CardDatabase::~CardDatabase()
 {
+	abortLoading();
 	clear();
 	delete noCard;
 }
@@ -380,6 +873,10 @@ void CardDatabase::clear()
 		delete i.value();
 	}
 	cardHash.clear();
+	
+	store.clear();
+	if (noCard)
+		noCard->row = store.addCard(CardInfoData());
 }
 
 CardInfo *CardDatabase::getCard(const QString &cardName)
@@ -526,7 +1023,8 @@ void CardDatabase::loadSetsFromXml(QXmlStreamReader &xml)
 				else if (xml.name() == "longname")
 					longName = xml.readElementText();
 			}
-			setHash.insert(shortName, new CardSet(shortName, longName));
+			if (!setHash.contains(shortName))
+				setHash.insert(shortName, new CardSet(shortName, longName));
 		}
 	}
 }
@@ -537,40 +1035,11 @@ void CardDatabase::loadCardsFromXml(QXmlStreamReader &xml)
 		if (xml.readNext() == QXmlStreamReader::EndElement)
 			break;
 		if (xml.name() == "card") {
-                        QString name, manacost, type, pt, text, picURL, picHqURL, picStURL;
-			QStringList colors;
+			CardInfoData data = CardInfoData::readFromXml(xml);
 			SetList sets;
-			int tableRow = 0;
-			bool cipt = false;
-			while (!xml.atEnd()) {
-				if (xml.readNext() == QXmlStreamReader::EndElement)
-					break;
-				if (xml.name() == "name")
-					name = xml.readElementText();
-				else if (xml.name() == "manacost")
-					manacost = xml.readElementText();
-				else if (xml.name() == "type")
-					type = xml.readElementText();
-				else if (xml.name() == "pt")
-					pt = xml.readElementText();
-				else if (xml.name() == "text")
-					text = xml.readElementText();
-				else if (xml.name() == "set")
-					sets << getSet(xml.readElementText());
-				else if (xml.name() == "color")
-					colors << xml.readElementText();
-				else if (xml.name() == "tablerow")
-					tableRow = xml.readElementText().toInt();
-				else if (xml.name() == "picURL")
-					picURL = xml.readElementText();
-                                else if (xml.name() == "picHqURL")
-                                        picHqURL = xml.readElementText();
-                                else if (xml.name() == "picStURL")
-                                        picStURL = xml.readElementText();
-				else if (xml.name() == "cipt")
-					cipt = (xml.readElementText() == "1");
-			}
-                        cardHash.insert(name, new CardInfo(this, name, manacost, type, pt, text, colors, cipt, tableRow, sets, picURL, picHqURL, picStURL));
+			for (int i = 0; i < data.setNames.size(); i++)
+				sets << getSet(data.setNames[i]);
+			cardHash.insert(data.name, new CardInfo(this, data.name, data.manacost, data.cardtype, data.powtough, data.text, data.colors, data.cipt, data.tableRow, sets, data.picURL, data.picHqURL, data.picStURL));
 		}
 	}
 }
@@ -582,6 +1051,7 @@ bool CardDatabase::loadFromFile(const QString &fileName)
 	if (!file.isOpen())
 		return false;
 	QXmlStreamReader xml(&file);
+	abortLoading();
 	clear();
 	while (!xml.atEnd()) {
 		if (xml.readNext() == QXmlStreamReader::StartElement) {
@@ -598,6 +1068,7 @@ bool CardDatabase::loadFromFile(const QString &fileName)
 		}
 	}
 	qDebug(QString("%1 cards in %2 sets loaded").arg(cardHash.size()).arg(setHash.size()).toLatin1());
+	emit cardListChanged();
 	return !cardHash.isEmpty();
 }
 
@@ -640,12 +1111,101 @@ void CardDatabase::picDownloadChanged()
 	}
 }
 
+void CardDatabase::abortLoading()
+{
+	if (!loading)
+		return;
+	cardLoadingThread->abort();
+	++loadGeneration;
+	loading = false;
+}
+
 bool CardDatabase::loadCardDatabase(const QString &path)
 {
-	if (!path.isEmpty())
-		loadSuccess = loadFromFile(path);
-	else loadSuccess = false;
-	return loadSuccess;
+	abortLoading();
+	
+	// Only the root element is checked here, the cards themselves are
+	// read by cardLoadingThread. The name index arrives first, so that
+	// getCard() works before the full card data is available.
+	loadSuccess = false;
+	if (!path.isEmpty()) {
+		QFile file(path);
+		if (file.open(QIODevice::ReadOnly)) {
+			QXmlStreamReader xml(&file);
+			while (!xml.atEnd())
+				if (xml.readNext() == QXmlStreamReader::StartElement)
+					break;
+			loadSuccess = (xml.name() == "cockatrice_carddatabase");
+		}
+	}
+	if (!loadSuccess)
+		return false;
+	
+	clear();
+	emit cardListChanged();
+	
+	loading = true;
+	cardLoadingThread->loadFile(path, ++loadGeneration);
+	return true;
+}
+
+void CardDatabase::cardIndexLoaded(int generation)
+{
+	if (generation != loadGeneration)
+		return;
+	
+	QList<QPair<QString, QString> > sets = cardLoadingThread->takeLoadedSets();
+	for (int i = 0; i < sets.size(); i++)
+		if (!setHash.contains(sets[i].first))
+			setHash.insert(sets[i].first, new CardSet(sets[i].first, sets[i].second));
+	
+	const QStringList names = cardLoadingThread->takeLoadedNames();
+	for (int i = 0; i < names.size(); i++)
+		if (!cardHash.contains(names[i]))
+			cardHash.insert(names[i], new CardInfo(this, names[i]));
+	
+	qDebug(QString("CardDatabase: index of %1 cards in %2 sets loaded").arg(cardHash.size()).arg(setHash.size()).toLatin1());
+	emit cardListChanged();
+}
+
+void CardDatabase::cardChunkLoaded(int generation)
+{
+	if (generation != loadGeneration)
+		return;
+	
+	const QList<CardInfoData> cards = cardLoadingThread->takeLoadedCards();
+	QList<CardInfo *> loadedCards;
+	bool newCards = false;
+	for (int i = 0; i < cards.size(); i++) {
+		const CardInfoData &data = cards[i];
+		SetList sets;
+		for (int j = 0; j < data.setNames.size(); j++)
+			sets << getSet(data.setNames[j]);
+		
+		CardInfo *card = cardHash.value(data.name);
+		if (card) {
+			card->setData(data, sets);
+			loadedCards.append(card);
+		} else {
+			cardHash.insert(data.name, new CardInfo(this, data.name, data.manacost, data.cardtype, data.powtough, data.text, data.colors, data.cipt, data.tableRow, sets, data.picURL, data.picHqURL, data.picStURL));
+			newCards = true;
+		}
+	}
+	if (newCards)
+		emit cardListChanged();
+	else
+		emit cardsLoaded(loadedCards);
+}
+
+void CardDatabase::cardLoadingFinished(int generation, int cardCount)
+{
+	if (generation != loadGeneration)
+		return;
+	
+	loading = false;
+	loadSuccess = cardCount > 0;
+	qDebug(QString("%1 cards in %2 sets loaded").arg(cardCount).arg(setHash.size()).toLatin1());
+	emit loadingFinished(loadSuccess);
 }
 
 bool CardDatabase::loadCardDatabase()
@@ -655,26 +1215,12 @@ bool CardDatabase::loadCardDatabase()
 
 QStringList CardDatabase::getAllColors() const
 {
-	QSet<QString> colors;
-	QHashIterator<QString, CardInfo *> cardIterator(cardHash);
-	while (cardIterator.hasNext()) {
-		const QStringList &cardColors = cardIterator.next().value()->getColors();
-		if (cardColors.isEmpty())
-			colors.insert("X");
-		else
-			for (int i = 0; i < cardColors.size(); ++i)
-				colors.insert(cardColors[i]);
-	}
-	return colors.toList();
+	return store.getAllColors();
 }
 
 QStringList CardDatabase::getAllMainCardTypes() const
 {
-	QSet<QString> types;
-	QHashIterator<QString, CardInfo *> cardIterator(cardHash);
-	while (cardIterator.hasNext())
-		types.insert(cardIterator.next().value()->getMainCardType());
-	return types.toList();
+	return store.getAllMainCardTypes();
 }
 
 void CardDatabase::cacheCardPixmaps(const QStringList &cardNames)
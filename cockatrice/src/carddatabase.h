@@ -6,6 +6,8 @@
 #include <QMap>
 #include <QDataStream>
 #include <QList>
+#include <QVector>
+#include <QStringList>
 #include <QXmlStreamReader>
 #include <QNetworkRequest>
 #include <QThread>
@@ -37,11 +39,138 @@ public:
 	void sortByKey();
 };
 
+// Plain copy of a <card> element, filled by the loading thread.
+// Sets are referenced by short name, they are resolved on the GUI thread.
+class CardInfoData {
+public:
+	QString name;
+	QString manacost;
+	QString cardtype;
+	QString powtough;
+	QString text;
+	QStringList colors;
+	QStringList setNames;
+	QString picURL, picHqURL, picStURL;
+	bool cipt;
+	int tableRow;
+	CardInfoData() : cipt(false), tableRow(0) { }
+	static CardInfoData readFromXml(QXmlStreamReader &xml);
+};
+
+// Column store behind CardInfo. Each card is a dense row index, strings
+// that repeat across cards are interned and the values derived from them
+// are computed once on insertion, so that scans over the whole card pool
+// touch contiguous arrays.
+class CardInfoStore {
+public:
+	enum ColorFlag { ColorWhite = 0x01, ColorBlue = 0x02, ColorBlack = 0x04, ColorRed = 0x08, ColorGreen = 0x10 };
+	enum TypeFlag {
+		TypeArtifact = 0x001, TypeCreature = 0x002, TypeEnchantment = 0x004, TypeInstant = 0x008,
+		TypeLand = 0x010, TypePlaneswalker = 0x020, TypeSorcery = 0x040, TypeTribal = 0x080,
+		TypeLegendary = 0x100, TypeBasic = 0x200, TypeSnow = 0x400
+	};
+	// P/T values such as "*" or "1+*" are stored as this.
+	static const int NoValue = -1000;
+	
+	static QString parseMainCardType(const QString &cardType);
+	static int parseConvertedManaCost(const QString &manaCost);
+	static uint parseColorMask(const QStringList &colors);
+	static uint parseTypeMask(const QString &cardType);
+	static uint typeFlagFromName(const QString &typeName);
+private:
+	QStringList strings;
+	QHash<QString, int> stringIds;
+	QList<QStringList> colorLists;
+	QHash<QString, int> colorListIds;
+	
+	QVector<QString> names, texts, picURLs, picHqURLs, picStURLs;
+	QVector<int> manaCostIds, cardTypeIds, mainCardTypeIds, powToughIds, colorListIdColumn;
+	QVector<int> convertedManaCosts, powers, toughnesses, tableRows;
+	QVector<uint> colorMasks, typeMasks;
+	QVector<bool> cipts;
+	
+	int intern(const QString &str);
+	int internColors(const QStringList &colors);
+	static int parsePowTough(const QString &value);
+public:
+	CardInfoStore();
+	void clear();
+	int size() const { return names.size(); }
+	int addCard(const CardInfoData &data);
+	void setData(int row, const CardInfoData &data);
+	
+	QString getName(int row) const { return names[row]; }
+	QString getManaCost(int row) const { return strings[manaCostIds[row]]; }
+	QString getCardType(int row) const { return strings[cardTypeIds[row]]; }
+	QString getMainCardType(int row) const { return strings[mainCardTypeIds[row]]; }
+	QString getPowTough(int row) const { return strings[powToughIds[row]]; }
+	QString getText(int row) const { return texts[row]; }
+	QStringList getColors(int row) const { return colorLists[colorListIdColumn[row]]; }
+	QString getPicURL(int row) const { return picURLs[row]; }
+	QString getPicHqURL(int row) const { return picHqURLs[row]; }
+	QString getPicStURL(int row) const { return picStURLs[row]; }
+	bool getCipt(int row) const { return cipts[row]; }
+	int getTableRow(int row) const { return tableRows[row]; }
+	int getConvertedManaCost(int row) const { return convertedManaCosts[row]; }
+	int getPower(int row) const { return powers[row]; }
+	int getToughness(int row) const { return toughnesses[row]; }
+	uint getColorMask(int row) const { return colorMasks[row]; }
+	uint getTypeMask(int row) const { return typeMasks[row]; }
+	
+	void setText(int row, const QString &text) { texts[row] = text; }
+	void setTableRow(int row, int tableRow) { tableRows[row] = tableRow; }
+	void setPicURL(int row, const QString &picURL) { picURLs[row] = picURL; }
+	void setPicHqURL(int row, const QString &picHqURL) { picHqURLs[row] = picHqURL; }
+	void setPicStURL(int row, const QString &picStURL) { picStURLs[row] = picStURL; }
+	
+	QStringList getAllColors() const;
+	QStringList getAllMainCardTypes() const;
+};
+
+class CardDatabaseLoadingThread : public QThread {
+	Q_OBJECT
+private:
+	static const int chunkSize = 500;
+	QString fileName;
+	int generation;
+	bool abortRequested;
+	QList<QPair<QString, QString> > loadedSets;
+	QStringList loadedNames;
+	QList<CardInfoData> loadedCards;
+	QMutex mutex;
+	bool isAborted();
+	bool readIndex(QXmlStreamReader &xml);
+	int readCards(QXmlStreamReader &xml);
+protected:
+	void run();
+public:
+	CardDatabaseLoadingThread(QObject *parent);
+	~CardDatabaseLoadingThread();
+	void loadFile(const QString &_fileName, int _generation);
+	void abort();
+	QList<QPair<QString, QString> > takeLoadedSets();
+	QStringList takeLoadedNames();
+	QList<CardInfoData> takeLoadedCards();
+signals:
+	void indexLoaded(int generation);
+	void cardsLoaded(int generation);
+	void loadingFinished(int generation, int cardCount);
+};
+
 class PictureLoadingThread : public QThread {
 	Q_OBJECT
 private:
+	// Everything the thread needs is copied on the GUI thread, so that
+	// it never reads from the card store while it is being modified.
+	class PictureToLoad {
+	public:
+		CardInfo *card;
+		bool stripped;
+		QString correctedName;
+		QStringList setNames;
+	};
 	QString _picsPath;
-        QList<QPair<CardInfo*, bool> > loadQueue;
+        QList<PictureToLoad> loadQueue;
 	QMutex mutex;
 protected:
 	void run();
@@ -56,19 +185,13 @@ signals:
 
 class CardInfo : public QObject {
 	Q_OBJECT
+	friend class CardDatabase;
 private:
 	CardDatabase *db;
+	CardInfoStore *store;
+	int row;
 
-	QString name;
 	SetList sets;
-	QString manacost;
-	QString cardtype;
-	QString powtough;
-	QString text;
-	QStringList colors;
-        QString picURL, picHqURL, picStURL;
-	bool cipt;
-	int tableRow;
 	QPixmap *pixmap;
         QPixmap *pixmapSt;
 	QMap<int, QPixmap *> scaledPixmapCache;
@@ -88,25 +211,32 @@ public:
                 const QString &_picHqURL = QString(),
                 const QString &_picStURL = QString());
 	~CardInfo();
-	const QString &getName() const { return name; }
+	int getRow() const { return row; }
+	QString getName() const { return store->getName(row); }
 	const SetList &getSets() const { return sets; }
-	const QString &getManaCost() const { return manacost; }
-	const QString &getCardType() const { return cardtype; }
-	const QString &getPowTough() const { return powtough; }
-	const QString &getText() const { return text; }
-	bool getCipt() const { return cipt; }
-	void setText(const QString &_text) { text = _text; }
-	const QStringList &getColors() const { return colors; }
-	const QString &getPicURL() const { return picURL; }
-        const QString &getPicHqURL() const { return picHqURL; }
-        const QString &getPicStURL() const { return picStURL; }
-	QString getMainCardType() const;
+	QString getManaCost() const { return store->getManaCost(row); }
+	QString getCardType() const { return store->getCardType(row); }
+	QString getPowTough() const { return store->getPowTough(row); }
+	QString getText() const { return store->getText(row); }
+	bool getCipt() const { return store->getCipt(row); }
+	void setText(const QString &_text) { store->setText(row, _text); }
+	void setData(const CardInfoData &data, const SetList &_sets);
+	QStringList getColors() const { return store->getColors(row); }
+	QString getPicURL() const { return store->getPicURL(row); }
+	QString getPicHqURL() const { return store->getPicHqURL(row); }
+	QString getPicStURL() const { return store->getPicStURL(row); }
+	QString getMainCardType() const { return store->getMainCardType(row); }
+	int getConvertedManaCost() const { return store->getConvertedManaCost(row); }
+	int getPower() const { return store->getPower(row); }
+	int getToughness() const { return store->getToughness(row); }
+	uint getColorMask() const { return store->getColorMask(row); }
+	uint getTypeMask() const { return store->getTypeMask(row); }
 	QString getCorrectedName() const;
-	int getTableRow() const { return tableRow; }
-	void setTableRow(int _tableRow) { tableRow = _tableRow; }
-	void setPicURL(const QString &_picURL) { picURL = _picURL; }
-        void setPicHqURL(const QString &_picHqURL) { picHqURL = _picHqURL; }
-        void setPicStURL(const QString &_picStURL) { picStURL = _picStURL; }
+	int getTableRow() const { return store->getTableRow(row); }
+	void setTableRow(int _tableRow) { store->setTableRow(row, _tableRow); }
+	void setPicURL(const QString &_picURL) { store->setPicURL(row, _picURL); }
+	void setPicHqURL(const QString &_picHqURL) { store->setPicHqURL(row, _picHqURL); }
+	void setPicStURL(const QString &_picStURL) { store->setPicStURL(row, _picStURL); }
         void addToSet(CardSet *set);
         QPixmap *loadPixmap(bool stripped);
         QPixmap *getPixmap(QSize size, bool stripped);
@@ -125,6 +255,7 @@ class CardDatabase : public QObject {
 protected:
 	QHash<QString, CardInfo *> cardHash;
 	QHash<QString, CardSet *> setHash;
+	CardInfoStore store;
 	QNetworkAccessManager *networkManager;
         QList<QPair<CardInfo *, bool> > cardsToDownload;
         QPair<CardInfo *, bool> cardBeingDownloaded;
@@ -133,14 +264,19 @@ protected:
         bool failLQ;
 	CardInfo *noCard;
 	PictureLoadingThread *loadingThread;
+	CardDatabaseLoadingThread *cardLoadingThread;
+	int loadGeneration;
+	bool loading;
 private:
 	void loadCardsFromXml(QXmlStreamReader &xml);
 	void loadSetsFromXml(QXmlStreamReader &xml);
 	void startNextPicDownload();
+	void abortLoading();
 public:
 	CardDatabase(QObject *parent = 0);
 	~CardDatabase();
 	void clear();
+	CardInfoStore *getStore() { return &store; }
 	CardInfo *getCard(const QString &cardName = QString());
 	CardSet *getSet(const QString &setName);
 	QList<CardInfo *> getCardList() const { return cardHash.values(); }
@@ -151,6 +287,7 @@ public:
 	QStringList getAllColors() const;
 	QStringList getAllMainCardTypes() const;
 	bool getLoadSuccess() const { return loadSuccess; }
+	bool isLoading() const { return loading; }
         void cacheCardPixmaps(const QStringList &cardNames);
         void loadImage(CardInfo *card, bool stripped);
 public slots:
@@ -162,6 +299,14 @@ private slots:
 	void picDownloadFinished(QNetworkReply *reply);
 	void picDownloadChanged();
         void imageLoaded(CardInfo *card, QImage image, bool stripped);
+	void cardIndexLoaded(int generation);
+	void cardChunkLoaded(int generation);
+	void cardLoadingFinished(int generation, int cardCount);
+signals:
+	void cardListChanged();
+	// The data of these cards has been filled in.
+	void cardsLoaded(const QList<CardInfo *> &cards);
+	void loadingFinished(bool success);
 };
 
 #endif
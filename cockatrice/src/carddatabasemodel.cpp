@@ -3,7 +3,9 @@
 CardDatabaseModel::CardDatabaseModel(CardDatabase *_db, QObject *parent)
 	: QAbstractListModel(parent), db(_db)
 {
-	cardList = db->getCardList();
+	updateCardList();
+	connect(db, SIGNAL(cardListChanged()), this, SLOT(updateCardList()));
+	connect(db, SIGNAL(cardsLoaded(const QList<CardInfo *> &)), this, SLOT(cardsLoaded(const QList<CardInfo *> &)));
 }
 
 CardDatabaseModel::~CardDatabaseModel()
@@ -11,6 +13,35 @@ CardDatabaseModel::~CardDatabaseModel()
 
 }
 
+void CardDatabaseModel::updateCardList()
+{
+	cardList = db->getCardList();
+	rowByCard.clear();
+	for (int i = 0; i < cardList.size(); ++i)
+		rowByCard.insert(cardList[i], i);
+	reset();
+}
+
+void CardDatabaseModel::cardsLoaded(const QList<CardInfo *> &cards)
+{
+	// The card pointers stay the same while the database fills them in,
+	// only the rows of this chunk change.
+	QList<int> rows;
+	for (int i = 0; i < cards.size(); ++i) {
+		int row = rowByCard.value(cards[i], -1);
+		if (row != -1)
+			rows.append(row);
+	}
+	qSort(rows);
+	for (int i = 0; i < rows.size(); ) {
+		int first = rows[i];
+		int last = first;
+		while ((++i < rows.size()) && (rows[i] <= last + 1))
+			last = rows[i];
+		emit dataChanged(index(first, 0), index(last, columnCount() - 1));
+	}
+}
+
 int CardDatabaseModel::rowCount(const QModelIndex &/*parent*/) const
 {
 	return cardList.size();
@@ -64,37 +95,84 @@ QVariant CardDatabaseModel::headerData(int section, Qt::Orientation orientation,
 }
 
 CardDatabaseDisplayModel::CardDatabaseDisplayModel(QObject *parent)
-	: QSortFilterProxyModel(parent)
+	: QSortFilterProxyModel(parent), searchIndexDirty(true), filterActive(false)
 {
 	setFilterCaseSensitivity(Qt::CaseInsensitive);
 	setSortCaseSensitivity(Qt::CaseInsensitive);
+	// Rows whose card data changes are filtered again by the proxy itself.
+	setDynamicSortFilter(true);
 }
 
-bool CardDatabaseDisplayModel::filterAcceptsRow(int sourceRow, const QModelIndex & /*sourceParent*/) const
+void CardDatabaseDisplayModel::setSourceModel(QAbstractItemModel *sourceModel)
+{
+	// Connected before the proxy's own handlers, so that the index and the
+	// accepted rows are current when the proxy looks at the changed rows.
+	connect(sourceModel, SIGNAL(modelReset()), this, SLOT(sourceCardsReset()));
+	connect(sourceModel, SIGNAL(dataChanged(const QModelIndex &, const QModelIndex &)), this, SLOT(sourceCardsChanged(const QModelIndex &, const QModelIndex &)));
+	QSortFilterProxyModel::setSourceModel(sourceModel);
+	sourceCardsReset();
+}
+
+void CardDatabaseDisplayModel::sourceCardsReset()
+{
+	searchIndexDirty = true;
+	if (filterActive)
+		updateFilter();
+}
+
+void CardDatabaseDisplayModel::sourceCardsChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight)
 {
-	CardInfo *info = static_cast<CardDatabaseModel *>(sourceModel())->getCard(sourceRow);
+	// An index that has not been built yet picks up the new data when
+	// it is needed.
+	if (searchIndexDirty)
+		return;
+	searchIndex.updateRows(static_cast<CardDatabaseModel *>(sourceModel())->getCardList(), topLeft.row(), bottomRight.row());
+	if (filterActive)
+		evaluateFilter();
+}
+
+void CardDatabaseDisplayModel::updateFilter()
+{
+	filterActive = !cardNameBeginning.isEmpty() || !cardName.isEmpty() || !cardText.isEmpty() || !cardColors.isEmpty() || !cardTypes.isEmpty() || !cardQuery.isEmpty();
+	if (!filterActive) {
+		acceptedRows.clear();
+		invalidateFilter();
+		return;
+	}
 	
-	if (!cardNameBeginning.isEmpty())
-		if (!info->getName().startsWith(cardNameBeginning, Qt::CaseInsensitive))
-			return false;
+	// The index is only rebuilt when a search actually needs it, so that
+	// loading the card database does not pay for it.
+	if (searchIndexDirty) {
+		searchIndex.build(static_cast<CardDatabaseModel *>(sourceModel())->getCardList());
+		searchIndexDirty = false;
+	}
 	
+	evaluateFilter();
+	invalidateFilter();
+}
+
+void CardDatabaseDisplayModel::evaluateFilter()
+{
+	acceptedRows = searchIndex.allRows();
+	if (!cardNameBeginning.isEmpty())
+		acceptedRows &= searchIndex.matchPrefix(CardSearchIndex::NameField, cardNameBeginning);
 	if (!cardName.isEmpty())
-		if (!info->getName().contains(cardName, Qt::CaseInsensitive))
-			return false;
-	
+		acceptedRows &= searchIndex.matchSubstring(CardSearchIndex::NameField, cardName);
 	if (!cardText.isEmpty())
-		if (!info->getText().contains(cardText, Qt::CaseInsensitive))
-			return false;
-	
+		acceptedRows &= searchIndex.matchSubstring(CardSearchIndex::TextField, cardText);
 	if (!cardColors.isEmpty())
-		if (QSet<QString>::fromList(info->getColors()).intersect(cardColors).isEmpty() && !(info->getColors().isEmpty() && cardColors.contains("X")))
-			return false;
-		
+		acceptedRows &= searchIndex.matchColors(cardColors);
 	if (!cardTypes.isEmpty())
-		if (!cardTypes.contains(info->getMainCardType()))
-			return false;
+		acceptedRows &= searchIndex.matchTypes(cardTypes);
+	if (!cardQuery.isEmpty())
+		acceptedRows &= cardQuery.evaluate(searchIndex);
+}
 
-	return true;
+bool CardDatabaseDisplayModel::filterAcceptsRow(int sourceRow, const QModelIndex & /*sourceParent*/) const
+{
+	if (!filterActive)
+		return true;
+	return (sourceRow < acceptedRows.size()) && acceptedRows.testBit(sourceRow);
 }
 
 void CardDatabaseDisplayModel::clearSearch()
@@ -103,5 +181,6 @@ void CardDatabaseDisplayModel::clearSearch()
 	cardText.clear();
 	cardTypes.clear();
 	cardColors.clear();
-	invalidateFilter();
+	cardQuery = CardQuery();
+	updateFilter();
 }
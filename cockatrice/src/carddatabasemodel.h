@@ -5,7 +5,11 @@
 #include <QSortFilterProxyModel>
 #include <QList>
 #include <QSet>
+#include <QHash>
+#include <QBitArray>
 #include "carddatabase.h"
+#include "cardsearchindex.h"
+#include "cardquery.h"
 
 class CardDatabaseModel : public QAbstractListModel {
 	Q_OBJECT
@@ -17,8 +21,13 @@ public:
 	QVariant data(const QModelIndex &index, int role) const;
 	QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const;
 	CardInfo *getCard(int index) const { return cardList[index]; }
+	const QList<CardInfo *> &getCardList() const { return cardList; }
+private slots:
+	void updateCardList();
+	void cardsLoaded(const QList<CardInfo *> &cards);
 private:
 	QList<CardInfo *> cardList;
+	QHash<CardInfo *, int> rowByCard;
 	CardDatabase *db;
 };
 
@@ -27,13 +36,25 @@ class CardDatabaseDisplayModel : public QSortFilterProxyModel {
 private:
 	QString cardNameBeginning, cardName, cardText;
 	QSet<QString> cardTypes, cardColors;
+	CardQuery cardQuery;
+	CardSearchIndex searchIndex;
+	bool searchIndexDirty;
+	bool filterActive;
+	QBitArray acceptedRows;
+	void updateFilter();
+	void evaluateFilter();
+private slots:
+	void sourceCardsReset();
+	void sourceCardsChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight);
 public:
 	CardDatabaseDisplayModel(QObject *parent = 0);
-	void setCardNameBeginning(const QString &_beginning) { cardNameBeginning = _beginning; invalidateFilter(); }
-	void setCardName(const QString &_cardName) { cardName = _cardName; invalidateFilter(); }
-	void setCardText(const QString &_cardText) { cardText = _cardText; invalidateFilter(); }
-	void setCardTypes(const QSet<QString> &_cardTypes) { cardTypes = _cardTypes; invalidateFilter(); }
-	void setCardColors(const QSet<QString> &_cardColors) { cardColors = _cardColors; invalidateFilter(); }
+	void setSourceModel(QAbstractItemModel *sourceModel);
+	void setCardNameBeginning(const QString &_beginning) { cardNameBeginning = _beginning; updateFilter(); }
+	void setCardName(const QString &_cardName) { cardName = _cardName; updateFilter(); }
+	void setCardText(const QString &_cardText) { cardText = _cardText; updateFilter(); }
+	void setCardTypes(const QSet<QString> &_cardTypes) { cardTypes = _cardTypes; updateFilter(); }
+	void setCardColors(const QSet<QString> &_cardColors) { cardColors = _cardColors; updateFilter(); }
+	void setCardQuery(const CardQuery &_cardQuery) { cardQuery = _cardQuery; updateFilter(); }
 	void clearSearch();
 protected:
 	bool filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const;
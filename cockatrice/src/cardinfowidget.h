@@ -34,6 +34,7 @@ private:
 public:
 	CardInfoWidget(ResizeMode _mode, QWidget *parent = 0, Qt::WindowFlags f = 0);
 	void retranslateUi();
+	CardInfo *getCard() const { return info; }
 public slots:
 	void setCard(CardInfo *card);
 	void setCard(const QString &cardName);
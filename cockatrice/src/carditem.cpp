@@ -278,23 +278,39 @@ void CardItem::setPT(const QString &_pt)
 	update();
 }
 
+void CardItem::setId(int _id)
+{
+	int oldId = id;
+	id = _id;
+	if (zone && (oldId != id))
+		zone->cardIdChanged(this, oldId);
+}
+
+void CardItem::setGridPoint(const QPoint &_gridPoint)
+{
+	QPoint oldGridPoint = gridPoint;
+	gridPoint = _gridPoint;
+	if (zone && (oldGridPoint != gridPoint))
+		zone->cardGridPointChanged(this, oldGridPoint);
+}
+
 void CardItem::setAttachedTo(CardItem *_attachedTo)
 {
 	if (attachedTo)
 		attachedTo->removeAttachedCard(this);
 	
-	gridPoint.setX(-1);
+	setGridPoint(QPoint(-1, gridPoint.y()));
 	attachedTo = _attachedTo;
 	if (attachedTo) {
 		setParentItem(attachedTo->getZone());
 		attachedTo->addAttachedCard(this);
 		if (zone != attachedTo->getZone())
-			attachedTo->getZone()->reorganizeCards();
+			attachedTo->getZone()->scheduleReorganize();
 	} else
 		setParentItem(zone);
 
 	if (zone)
-		zone->reorganizeCards();
+		zone->scheduleReorganize();
 	
 	updateCardMenu();
 }
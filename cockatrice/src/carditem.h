@@ -61,12 +61,12 @@ public:
 	QMenu *getCardMenu() const { return cardMenu; }
 	void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget);
 	QPoint getGridPoint() const { return gridPoint; }
-	void setGridPoint(const QPoint &_gridPoint) { gridPoint = _gridPoint; }
+	void setGridPoint(const QPoint &_gridPoint);
 	QPoint getGridPos() const { return gridPoint; }
 	Player *getOwner() const { return owner; }
 	void setOwner(Player *_owner) { owner = _owner; }
 	int getId() const { return id; }
-	void setId(int _id) { id = _id; }
+	void setId(int _id);
 	bool getAttacking() const { return attacking; }
 	void setAttacking(bool _attacking);
 	bool getFaceDown() const { return facedown; }
@@ -0,0 +1,181 @@
+#include "cardquery.h"
+#include "carddatabase.h"
+#include <QRegExp>
+#include <QStringList>
+
+CardQuery::CardQuery(const QString &query)
+{
+	QList<Term> terms;
+	const QStringList tokens = tokenize(query);
+	for (int i = 0; i < tokens.size(); ++i) {
+		if (tokens[i].compare("or", Qt::CaseInsensitive) == 0) {
+			if (!terms.isEmpty())
+				alternatives.append(terms);
+			terms.clear();
+			continue;
+		}
+		Term term;
+		if (!compileTerm(tokens[i], term)) {
+			alternatives.clear();
+			return;
+		}
+		terms.append(term);
+	}
+	if (!terms.isEmpty())
+		alternatives.append(terms);
+}
+
+QStringList CardQuery::tokenize(const QString &query)
+{
+	// Whitespace separates tokens except inside double quotes, which are dropped.
+	QStringList result;
+	QString current;
+	bool quoted = false, hasToken = false;
+	for (int i = 0; i < query.size(); ++i) {
+		const QChar c = query[i];
+		if (c == '"') {
+			quoted = !quoted;
+			hasToken = true;
+		} else if (c.isSpace() && !quoted) {
+			if (hasToken)
+				result.append(current);
+			current.clear();
+			hasToken = false;
+		} else {
+			current.append(c);
+			hasToken = true;
+		}
+	}
+	if (hasToken)
+		result.append(current);
+	return result;
+}
+
+bool CardQuery::compileTerm(const QString &token, Term &term)
+{
+	QString expr = token;
+	if ((expr.size() > 1) && expr.startsWith('-')) {
+		term.negated = true;
+		expr.remove(0, 1);
+	}
+	
+	QRegExp rx("^([a-zA-Z]+)(<=|>=|!=|:|=|<|>)(.*)$");
+	if (!rx.exactMatch(expr)) {
+		term.kind = Term::Substring;
+		term.field = CardSearchIndex::NameField;
+		term.text = expr;
+		return true;
+	}
+	const QString key = rx.cap(1).toLower();
+	const QString op = rx.cap(2);
+	const QString value = rx.cap(3);
+	const bool textOp = (op == ":") || (op == "=");
+	
+	if ((key == "n") || (key == "name") || (key == "o") || (key == "text")) {
+		if (!textOp) {
+			error = tr("Operator %1 cannot be used with %2.").arg(op).arg(key);
+			return false;
+		}
+		term.kind = Term::Substring;
+		term.field = ((key == "n") || (key == "name")) ? CardSearchIndex::NameField : CardSearchIndex::TextField;
+		term.text = value;
+	} else if ((key == "t") || (key == "type")) {
+		if (!textOp) {
+			error = tr("Operator %1 cannot be used with %2.").arg(op).arg(key);
+			return false;
+		}
+		// Card types and supertypes have their own column, subtypes are looked up in the type line.
+		term.mask = CardInfoStore::typeFlagFromName(value);
+		if (term.mask)
+			term.kind = Term::TypeMask;
+		else {
+			term.kind = Term::Substring;
+			term.field = CardSearchIndex::TypeField;
+			term.text = value;
+		}
+	} else if ((key == "c") || (key == "color")) {
+		if (!textOp) {
+			error = tr("Operator %1 cannot be used with %2.").arg(op).arg(key);
+			return false;
+		}
+		term.kind = Term::ColorMask;
+		term.exact = (op == "=");
+		const QString colors = value.toLower();
+		for (int i = 0; i < colors.size(); ++i) {
+			switch (colors[i].toLatin1()) {
+				case 'w': term.mask |= CardInfoStore::ColorWhite; break;
+				case 'u': term.mask |= CardInfoStore::ColorBlue; break;
+				case 'b': term.mask |= CardInfoStore::ColorBlack; break;
+				case 'r': term.mask |= CardInfoStore::ColorRed; break;
+				case 'g': term.mask |= CardInfoStore::ColorGreen; break;
+				case 'c': term.exact = true; break;
+				default:
+					error = tr("Unknown color: %1").arg(colors[i]);
+					return false;
+			}
+		}
+	} else if ((key == "cmc") || (key == "pow") || (key == "power") || (key == "tou") || (key == "toughness")) {
+		term.kind = Term::Number;
+		if (key == "cmc")
+			term.column = CardSearchIndex::ConvertedManaCostColumn;
+		else if ((key == "pow") || (key == "power"))
+			term.column = CardSearchIndex::PowerColumn;
+		else
+			term.column = CardSearchIndex::ToughnessColumn;
+		
+		if (op == "<")
+			term.op = CardSearchIndex::Less;
+		else if (op == "<=")
+			term.op = CardSearchIndex::LessOrEqual;
+		else if (op == "!=")
+			term.op = CardSearchIndex::NotEqual;
+		else if (op == ">=")
+			term.op = CardSearchIndex::GreaterOrEqual;
+		else if (op == ">")
+			term.op = CardSearchIndex::Greater;
+		else
+			term.op = CardSearchIndex::Equal;
+		
+		bool ok;
+		term.value = value.toInt(&ok);
+		if (!ok) {
+			error = tr("Not a number: %1").arg(value);
+			return false;
+		}
+	} else {
+		error = tr("Unknown search field: %1").arg(key);
+		return false;
+	}
+	return true;
+}
+
+QBitArray CardQuery::Term::evaluate(const CardSearchIndex &index) const
+{
+	switch (kind) {
+		case Substring: return index.matchSubstring(field, text);
+		case Number: return index.matchNumber(column, op, value);
+		case ColorMask: return index.matchColorMask(mask, exact);
+		case TypeMask: return index.matchTypeMask(mask);
+		default: return index.allRows();
+	}
+}
+
+QBitArray CardQuery::evaluate(const CardSearchIndex &index) const
+{
+	if (alternatives.isEmpty())
+		return index.allRows();
+	
+	QBitArray result(index.size());
+	for (int i = 0; i < alternatives.size(); ++i) {
+		const QList<Term> &terms = alternatives[i];
+		QBitArray matches = index.allRows();
+		for (int j = 0; j < terms.size(); ++j) {
+			if (terms[j].negated)
+				matches &= ~terms[j].evaluate(index);
+			else
+				matches &= terms[j].evaluate(index);
+		}
+		result |= matches;
+	}
+	return result;
+}
@@ -0,0 +1,46 @@
+#ifndef CARDQUERY_H
+#define CARDQUERY_H
+
+#include <QList>
+#include <QString>
+#include <QBitArray>
+#include <QCoreApplication>
+#include "cardsearchindex.h"
+
+// Compiles a search string like
+//   t:creature c:ug cmc<=3 o:"draw a card"
+// into a plan of index lookups and column scans.
+// Terms are combined with AND, "or" separates alternatives and a leading
+// "-" negates a term. Bare words are matched against the card name.
+class CardQuery {
+	Q_DECLARE_TR_FUNCTIONS(CardQuery)
+private:
+	class Term {
+	public:
+		enum Kind { Substring, Number, ColorMask, TypeMask };
+		Kind kind;
+		bool negated;
+		CardSearchIndex::Field field;
+		QString text;
+		CardSearchIndex::NumberColumn column;
+		CardSearchIndex::CompareOp op;
+		int value;
+		uint mask;
+		bool exact;
+		Term() : kind(Substring), negated(false), field(CardSearchIndex::NameField), column(CardSearchIndex::ConvertedManaCostColumn), op(CardSearchIndex::Equal), value(0), mask(0), exact(false) { }
+		QBitArray evaluate(const CardSearchIndex &index) const;
+	};
+	QList<QList<Term> > alternatives;
+	QString error;
+	
+	static QStringList tokenize(const QString &query);
+	bool compileTerm(const QString &token, Term &term);
+public:
+	CardQuery(const QString &query = QString());
+	bool isEmpty() const { return alternatives.isEmpty(); }
+	bool isValid() const { return error.isEmpty(); }
+	const QString &getError() const { return error; }
+	QBitArray evaluate(const CardSearchIndex &index) const;
+};
+
+#endif
@@ -0,0 +1,301 @@
+#include "cardsearchindex.h"
+#include "carddatabase.h"
+
+CardSearchIndex::CardSearchIndex()
+	: cardCount(0)
+{
+}
+
+quint64 CardSearchIndex::trigramKey(const QChar *c)
+{
+	return ((quint64) c[0].unicode() << 32) | ((quint64) c[1].unicode() << 16) | (quint64) c[2].unicode();
+}
+
+void CardSearchIndex::addTrigrams(TrigramHash &index, const QString &str, int row)
+{
+	const QChar *data = str.constData();
+	for (int i = 0; i + 3 <= str.size(); ++i) {
+		QVector<int> &rows = index[trigramKey(data + i)];
+		// While the index is built, rows arrive in ascending order and
+		// are simply appended; updated rows are inserted in place.
+		if (rows.isEmpty() || (rows.last() < row))
+			rows.append(row);
+		else {
+			QVector<int>::iterator pos = qLowerBound(rows.begin(), rows.end(), row);
+			if (*pos != row)
+				rows.insert(pos, row);
+		}
+	}
+}
+
+void CardSearchIndex::removeTrigrams(TrigramHash &index, const QString &str, int row)
+{
+	const QChar *data = str.constData();
+	for (int i = 0; i + 3 <= str.size(); ++i) {
+		TrigramHash::iterator it = index.find(trigramKey(data + i));
+		if (it == index.end())
+			continue;
+		QVector<int> &rows = it.value();
+		QVector<int>::iterator pos = qLowerBound(rows.begin(), rows.end(), row);
+		if ((pos != rows.end()) && (*pos == row))
+			rows.erase(pos);
+		if (rows.isEmpty())
+			index.erase(it);
+	}
+}
+
+const QStringList &CardSearchIndex::fieldStrings(Field field) const
+{
+	switch (field) {
+		case NameField: return lowerNames;
+		case TextField: return lowerTexts;
+		default: return lowerTypes;
+	}
+}
+
+QVector<int> CardSearchIndex::intersect(const QVector<int> &a, const QVector<int> &b)
+{
+	QVector<int> result;
+	result.reserve(qMin(a.size(), b.size()));
+	int i = 0, j = 0;
+	while ((i < a.size()) && (j < b.size())) {
+		if (a[i] < b[j])
+			++i;
+		else if (b[j] < a[i])
+			++j;
+		else {
+			result.append(a[i]);
+			++i;
+			++j;
+		}
+	}
+	return result;
+}
+
+void CardSearchIndex::clear()
+{
+	cardCount = 0;
+	lowerNames.clear();
+	lowerTexts.clear();
+	lowerTypes.clear();
+	nameTrigrams.clear();
+	textTrigrams.clear();
+	colorBits.clear();
+	typeBits.clear();
+	cmcColumn.clear();
+	powerColumn.clear();
+	toughnessColumn.clear();
+	colorMaskColumn.clear();
+	typeMaskColumn.clear();
+}
+
+void CardSearchIndex::build(const QList<CardInfo *> &cards)
+{
+	clear();
+	cardCount = cards.size();
+	cmcColumn.resize(cardCount);
+	powerColumn.resize(cardCount);
+	toughnessColumn.resize(cardCount);
+	colorMaskColumn.resize(cardCount);
+	typeMaskColumn.resize(cardCount);
+	for (int row = 0; row < cardCount; ++row) {
+		lowerNames.append(QString());
+		lowerTexts.append(QString());
+		lowerTypes.append(QString());
+	}
+	for (int row = 0; row < cardCount; ++row)
+		setRow(row, cards[row]);
+}
+
+void CardSearchIndex::updateRows(const QList<CardInfo *> &cards, int firstRow, int lastRow)
+{
+	Q_ASSERT(cards.size() == cardCount);
+	for (int row = firstRow; row <= lastRow; ++row) {
+		clearRow(row);
+		setRow(row, cards[row]);
+	}
+}
+
+void CardSearchIndex::setRow(int row, CardInfo *info)
+{
+	const QString name = info->getName().toLower();
+	const QString text = info->getText().toLower();
+	lowerNames[row] = name;
+	lowerTexts[row] = text;
+	addTrigrams(nameTrigrams, name, row);
+	addTrigrams(textTrigrams, text, row);
+	lowerTypes[row] = info->getCardType().toLower();
+	
+	cmcColumn[row] = info->getConvertedManaCost();
+	powerColumn[row] = info->getPower();
+	toughnessColumn[row] = info->getToughness();
+	colorMaskColumn[row] = info->getColorMask();
+	typeMaskColumn[row] = info->getTypeMask();
+	
+	QStringList colors = info->getColors();
+	if (colors.isEmpty())
+		colors.append("X");
+	for (int i = 0; i < colors.size(); ++i) {
+		QBitArray &bits = colorBits[colors[i]];
+		if (bits.isEmpty())
+			bits.resize(cardCount);
+		bits.setBit(row);
+	}
+	
+	QBitArray &bits = typeBits[info->getMainCardType()];
+	if (bits.isEmpty())
+		bits.resize(cardCount);
+	bits.setBit(row);
+}
+
+void CardSearchIndex::clearRow(int row)
+{
+	removeTrigrams(nameTrigrams, lowerNames[row], row);
+	removeTrigrams(textTrigrams, lowerTexts[row], row);
+	lowerNames[row].clear();
+	lowerTexts[row].clear();
+	lowerTypes[row].clear();
+	
+	QMutableHashIterator<QString, QBitArray> colorIterator(colorBits);
+	while (colorIterator.hasNext())
+		colorIterator.next().value().clearBit(row);
+	QMutableHashIterator<QString, QBitArray> typeIterator(typeBits);
+	while (typeIterator.hasNext())
+		typeIterator.next().value().clearBit(row);
+}
+
+bool CardSearchIndex::candidateRows(Field field, const QString &lowerNeedle, QVector<int> &result) const
+{
+	// Needles shorter than a trigram cannot be looked up, the caller
+	// has to check every row instead.
+	if ((lowerNeedle.size() < 3) || (field == TypeField))
+		return false;
+	
+	const TrigramHash &index = (field == NameField) ? nameTrigrams : textTrigrams;
+	QList<const QVector<int> *> postings;
+	const QChar *data = lowerNeedle.constData();
+	for (int i = 0; i + 3 <= lowerNeedle.size(); ++i) {
+		TrigramHash::const_iterator it = index.constFind(trigramKey(data + i));
+		if (it == index.constEnd()) {
+			result.clear();
+			return true;
+		}
+		postings.append(&it.value());
+	}
+	
+	// Start with the shortest list so that the intermediate results stay small.
+	int shortest = 0;
+	for (int i = 1; i < postings.size(); ++i)
+		if (postings[i]->size() < postings[shortest]->size())
+			shortest = i;
+	result = *postings[shortest];
+	for (int i = 0; (i < postings.size()) && !result.isEmpty(); ++i)
+		if (i != shortest)
+			result = intersect(result, *postings[i]);
+	return true;
+}
+
+QBitArray CardSearchIndex::matchSubstring(Field field, const QString &needle) const
+{
+	const QString lowerNeedle = needle.toLower();
+	const QStringList &strings = fieldStrings(field);
+	QBitArray result(cardCount);
+	
+	QVector<int> candidates;
+	if (candidateRows(field, lowerNeedle, candidates)) {
+		// All trigrams matching does not imply a match, so verify.
+		for (int i = 0; i < candidates.size(); ++i)
+			if (strings[candidates[i]].contains(lowerNeedle))
+				result.setBit(candidates[i]);
+	} else
+		for (int row = 0; row < cardCount; ++row)
+			if (strings[row].contains(lowerNeedle))
+				result.setBit(row);
+	return result;
+}
+
+QBitArray CardSearchIndex::matchPrefix(Field field, const QString &needle) const
+{
+	const QString lowerNeedle = needle.toLower();
+	const QStringList &strings = fieldStrings(field);
+	QBitArray result(cardCount);
+	
+	QVector<int> candidates;
+	if (candidateRows(field, lowerNeedle, candidates)) {
+		for (int i = 0; i < candidates.size(); ++i)
+			if (strings[candidates[i]].startsWith(lowerNeedle))
+				result.setBit(candidates[i]);
+	} else
+		for (int row = 0; row < cardCount; ++row)
+			if (strings[row].startsWith(lowerNeedle))
+				result.setBit(row);
+	return result;
+}
+
+QBitArray CardSearchIndex::matchColors(const QSet<QString> &colors) const
+{
+	QBitArray result(cardCount);
+	QSetIterator<QString> i(colors);
+	while (i.hasNext()) {
+		QHash<QString, QBitArray>::const_iterator it = colorBits.constFind(i.next());
+		if (it != colorBits.constEnd())
+			result |= it.value();
+	}
+	return result;
+}
+
+QBitArray CardSearchIndex::matchTypes(const QSet<QString> &types) const
+{
+	QBitArray result(cardCount);
+	QSetIterator<QString> i(types);
+	while (i.hasNext()) {
+		QHash<QString, QBitArray>::const_iterator it = typeBits.constFind(i.next());
+		if (it != typeBits.constEnd())
+			result |= it.value();
+	}
+	return result;
+}
+
+QBitArray CardSearchIndex::matchNumber(NumberColumn column, CompareOp op, int value) const
+{
+	const QVector<int> &values = (column == ConvertedManaCostColumn) ? cmcColumn : ((column == PowerColumn) ? powerColumn : toughnessColumn);
+	const int *data = values.constData();
+	QBitArray result(cardCount);
+	for (int row = 0; row < cardCount; ++row) {
+		const int v = data[row];
+		if (v == CardInfoStore::NoValue)
+			continue;
+		bool match;
+		switch (op) {
+			case Less: match = v < value; break;
+			case LessOrEqual: match = v <= value; break;
+			case Equal: match = v == value; break;
+			case NotEqual: match = v != value; break;
+			case GreaterOrEqual: match = v >= value; break;
+			default: match = v > value;
+		}
+		if (match)
+			result.setBit(row);
+	}
+	return result;
+}
+
+QBitArray CardSearchIndex::matchColorMask(uint mask, bool exact) const
+{
+	const uint *data = colorMaskColumn.constData();
+	QBitArray result(cardCount);
+	for (int row = 0; row < cardCount; ++row)
+		if (exact ? (data[row] == mask) : ((data[row] & mask) == mask))
+			result.setBit(row);
+	return result;
+}
+
+QBitArray CardSearchIndex::matchTypeMask(uint mask) const
+{
+	const uint *data = typeMaskColumn.constData();
+	QBitArray result(cardCount);
+	for (int row = 0; row < cardCount; ++row)
+		if ((data[row] & mask) == mask)
+			result.setBit(row);
+	return result;
+}
@@ -0,0 +1,58 @@
+#ifndef CARDSEARCHINDEX_H
+#define CARDSEARCHINDEX_H
+
+#include <QHash>
+#include <QVector>
+#include <QBitArray>
+#include <QStringList>
+#include <QSet>
+
+class CardInfo;
+
+// Inverted index over a fixed list of cards, addressed by row number.
+// Names and texts are indexed by trigrams, colors and main card types
+// by bitsets. Converted mana cost, colors, card types and P/T are copied
+// from the card store into columns in row order that queries scan linearly.
+// Every query returns the set of matching rows as a bit array
+// that can be combined with the others.
+class CardSearchIndex {
+public:
+	enum Field { NameField, TextField, TypeField };
+	enum NumberColumn { ConvertedManaCostColumn, PowerColumn, ToughnessColumn };
+	enum CompareOp { Less, LessOrEqual, Equal, NotEqual, GreaterOrEqual, Greater };
+private:
+	typedef QHash<quint64, QVector<int> > TrigramHash;
+	int cardCount;
+	QStringList lowerNames, lowerTexts, lowerTypes;
+	TrigramHash nameTrigrams, textTrigrams;
+	QHash<QString, QBitArray> colorBits, typeBits;
+	QVector<int> cmcColumn, powerColumn, toughnessColumn;
+	QVector<uint> colorMaskColumn, typeMaskColumn;
+	
+	static quint64 trigramKey(const QChar *c);
+	static void addTrigrams(TrigramHash &index, const QString &str, int row);
+	static void removeTrigrams(TrigramHash &index, const QString &str, int row);
+	static QVector<int> intersect(const QVector<int> &a, const QVector<int> &b);
+	const QStringList &fieldStrings(Field field) const;
+	bool candidateRows(Field field, const QString &lowerNeedle, QVector<int> &result) const;
+	void setRow(int row, CardInfo *info);
+	void clearRow(int row);
+public:
+	CardSearchIndex();
+	void build(const QList<CardInfo *> &cards);
+	// Reindexes rows whose card data has changed; the list of cards
+	// itself must be the one the index was built from.
+	void updateRows(const QList<CardInfo *> &cards, int firstRow, int lastRow);
+	void clear();
+	int size() const { return cardCount; }
+	QBitArray allRows() const { return QBitArray(cardCount, true); }
+	QBitArray matchSubstring(Field field, const QString &needle) const;
+	QBitArray matchPrefix(Field field, const QString &needle) const;
+	QBitArray matchColors(const QSet<QString> &colors) const;
+	QBitArray matchTypes(const QSet<QString> &types) const;
+	QBitArray matchNumber(NumberColumn column, CompareOp op, int value) const;
+	QBitArray matchColorMask(uint mask, bool exact) const;
+	QBitArray matchTypeMask(uint mask) const;
+};
+
+#endif
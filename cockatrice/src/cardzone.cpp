@@ -6,10 +6,11 @@
 #include "carditem.h"
 #include "player.h"
 #include "zoneviewzone.h"
+#include "gamescene.h"
 #include "protocol_items.h"
 
 CardZone::CardZone(Player *_p, const QString &_name, bool _hasCardAttr, bool _isShufflable, bool _contentsKnown, QGraphicsItem *parent, bool isView)
-	: AbstractGraphicsItem(parent), player(_p), name(_name), cards(_contentsKnown), view(NULL), menu(NULL), doubleClickAction(0), hasCardAttr(_hasCardAttr), isShufflable(_isShufflable)
+	: AbstractGraphicsItem(parent), player(_p), name(_name), cards(_contentsKnown), view(NULL), menu(NULL), doubleClickAction(0), hasCardAttr(_hasCardAttr), isShufflable(_isShufflable), reorganizePending(false)
 {
 	if (!isView)
 		player->addZone(this);
@@ -37,6 +38,7 @@ void CardZone::clearContents()
 		for (int j = 0; j < attachedCards.size(); ++j)
 			attachedCards[j]->setParentItem(attachedCards[j]->getZone());
 		
+		unindexCard(cards.at(i));
 		player->deleteCard(cards.at(i));
 	}
 	cards.clear();
@@ -105,16 +107,19 @@ void CardZone::addCard(CardItem *card, bool reorganize, int x, int y)
 
 	card->setZone(this);
 	addCardImpl(card, x, y);
+	indexCard(card);
 
 	if (reorganize)
-		reorganizeCards();
+		scheduleReorganize();
 	
 	emit cardCountChanged();
 }
 
 CardItem *CardZone::getCard(int cardId, const QString &cardName)
 {
-	CardItem *c = cards.findCard(cardId, false);
+	CardItem *c = cardsById.value(cardId);
+	if (!c)
+		c = cards.findCard(cardId, false);
 	if (!c) {
 		qDebug() << "CardZone::getCard: card id=" << cardId << "not found";
 		return 0;
@@ -134,37 +139,92 @@ CardItem *CardZone::takeCard(int position, int cardId, bool /*canResize*/)
 	if (position == -1) {
 		// position == -1 means either that the zone is indexed by card id
 		// or that it doesn't matter which card you take.
-		for (int i = 0; i < cards.size(); ++i)
-			if (cards[i]->getId() == cardId) {
-				position = i;
-				break;
-			}
+		CardItem *indexedCard = cardsById.value(cardId);
+		if (indexedCard)
+			position = cardPosition(indexedCard);
+		else
+			for (int i = 0; i < cards.size(); ++i)
+				if (cards[i]->getId() == cardId) {
+					position = i;
+					break;
+				}
 		if (position == -1)
 			position = 0;
 	}
 	if (position >= cards.size())
 		return 0;
 
-	CardItem *c = cards.takeAt(position);
+	CardItem *c = takeCardAt(position);
+	unindexCard(c);
 
 	if (view)
 		view->removeCard(position);
 
 	c->setId(cardId);
 
-	reorganizeCards();
+	scheduleReorganize();
 	emit cardCountChanged();
 	return c;
 }
 
 void CardZone::removeCard(CardItem *card)
 {
-	cards.removeAt(cards.indexOf(card));
-	reorganizeCards();
+	const int position = cardPosition(card);
+	if (position != -1)
+		takeCardAt(position);
+	unindexCard(card);
+	scheduleReorganize();
 	emit cardCountChanged();
 	player->deleteCard(card);
 }
 
+void CardZone::indexCard(CardItem *card)
+{
+	if (cards.getContentsKnown() && (card->getId() != -1))
+		cardsById.insert(card->getId(), card);
+}
+
+void CardZone::unindexCard(CardItem *card)
+{
+	if (cardsById.value(card->getId()) == card)
+		cardsById.remove(card->getId());
+}
+
+void CardZone::cardIdChanged(CardItem *card, int oldId)
+{
+	// Only cards that are currently indexed are moved to their new id.
+	if (cardsById.value(oldId) != card)
+		return;
+	cardsById.remove(oldId);
+	if (card->getId() != -1)
+		cardsById.insert(card->getId(), card);
+}
+
+void CardZone::scheduleReorganize()
+{
+	if (reorganizePending)
+		return;
+	reorganizePending = true;
+	QMetaObject::invokeMethod(this, "deferredReorganize", Qt::QueuedConnection);
+}
+
+void CardZone::deferredReorganize()
+{
+	// Zones of a game in a background tab stay pending until it is shown.
+	GameScene *gameScene = qobject_cast<GameScene *>(scene());
+	if (gameScene && gameScene->getSuspended())
+		return;
+	processPendingReorganize();
+}
+
+void CardZone::processPendingReorganize()
+{
+	if (!reorganizePending)
+		return;
+	reorganizePending = false;
+	reorganizeCards();
+}
+
 void CardZone::moveAllToZone()
 {
 	QList<QVariant> data = static_cast<QAction *>(sender())->data().toList();
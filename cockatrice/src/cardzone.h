@@ -2,6 +2,7 @@
 #define CARDZONE_H
 
 #include <QString>
+#include <QHash>
 #include "cardlist.h"
 #include "carditem.h"
 #include "abstractgraphicsitem.h"
@@ -25,6 +26,15 @@ protected:
 	QAction *doubleClickAction;
 	bool hasCardAttr;
 	bool isShufflable;
+	bool reorganizePending;
+	// Cards of zones with known contents, by id.
+	QHash<int, CardItem *> cardsById;
+	virtual void indexCard(CardItem *card);
+	virtual void unindexCard(CardItem *card);
+	// Where a card is in the list and how it is taken out of it. Zones
+	// whose order does not matter can do both without searching the list.
+	virtual int cardPosition(CardItem *card) const { return cards.indexOf(card); }
+	virtual CardItem *takeCardAt(int position) { return cards.takeAt(position); }
 	void mouseDoubleClickEvent(QGraphicsSceneMouseEvent *event);
 	void mousePressEvent(QGraphicsSceneMouseEvent *event);
 	virtual void addCardImpl(CardItem *card, int x, int y) = 0;
@@ -32,9 +42,13 @@ signals:
 	void cardCountChanged();
 public slots:
 	void moveAllToZone();
+private slots:
+	void deferredReorganize();
 public:
 	enum { Type = typeZone };
 	int type() const { return Type; }
+	// Lays out the zone now if a deferred pass is still outstanding.
+	void processPendingReorganize();
 	virtual void handleDropEvent(const QList<CardDragItem *> &dragItem, CardZone *startZone, const QPoint &dropPoint, bool faceDown) = 0;
 	CardZone(Player *_player, const QString &_name, bool _hasCardAttr, bool _isShufflable, bool _contentsKnown, QGraphicsItem *parent = 0, bool isView = false);
 	~CardZone();
@@ -55,9 +69,15 @@ public:
 	// takeCard() finds a card by position and removes it from the zone and from all of its views.
 	virtual CardItem *takeCard(int position, int cardId, bool canResize = true);
 	void removeCard(CardItem *card);
+	// Called by CardItem to keep the indexes of the zone up to date.
+	void cardIdChanged(CardItem *card, int oldId);
+	virtual void cardGridPointChanged(CardItem * /*card*/, const QPoint & /*oldGridPoint*/) { }
 	ZoneViewZone *getView() const { return view; }
 	void setView(ZoneViewZone *_view) { view = _view; }
 	virtual void reorganizeCards() = 0;
+	// Lays out the zone once control returns to the event loop, so that all
+	// changes caused by one batch of game events result in a single pass.
+	void scheduleReorganize();
 	virtual QPointF closestGridPoint(const QPointF &point);
 };
 
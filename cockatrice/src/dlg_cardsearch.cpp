@@ -18,6 +18,10 @@ DlgCardSearch::DlgCardSearch(QWidget *parent)
 	QLabel *cardTextLabel = new QLabel(tr("Card text:"));
 	cardTextEdit = new QLineEdit;
 	
+	QLabel *cardQueryLabel = new QLabel(tr("Query:"));
+	cardQueryEdit = new QLineEdit;
+	cardQueryEdit->setToolTip(tr("Example: t:creature c:ug cmc<=3 o:\"draw a card\""));
+	
 	QLabel *cardTypesLabel = new QLabel(tr("Card type (OR):"));
 	const QStringList &cardTypes = db->getAllMainCardTypes();
 	QVBoxLayout *cardTypesLayout = new QVBoxLayout;
@@ -58,6 +62,8 @@ DlgCardSearch::DlgCardSearch(QWidget *parent)
 	optionsLayout->addLayout(cardTypesLayout, 2, 1);
 	optionsLayout->addWidget(cardColorsLabel, 3, 0);
 	optionsLayout->addLayout(cardColorsLayout, 3, 1);
+	optionsLayout->addWidget(cardQueryLabel, 4, 0);
+	optionsLayout->addWidget(cardQueryEdit, 4, 1);
 	
 	QVBoxLayout *mainLayout = new QVBoxLayout;
 	mainLayout->addLayout(optionsLayout);
@@ -76,6 +82,11 @@ QString DlgCardSearch::getCardText() const
 	return cardTextEdit->text();
 }
 
+QString DlgCardSearch::getCardQuery() const
+{
+	return cardQueryEdit->text();
+}
+
 QSet<QString> DlgCardSearch::getCardTypes() const
 {
 	QStringList result;
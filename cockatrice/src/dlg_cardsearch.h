@@ -11,12 +11,13 @@ class QCheckBox;
 class DlgCardSearch : public QDialog {
 	Q_OBJECT
 private:
-	QLineEdit *cardNameEdit, *cardTextEdit;
+	QLineEdit *cardNameEdit, *cardTextEdit, *cardQueryEdit;
 	QList<QCheckBox *> cardTypeCheckBoxes, cardColorCheckBoxes;
 public:
 	DlgCardSearch(QWidget *parent = 0);
 	QString getCardName() const;
 	QString getCardText() const;
+	QString getCardQuery() const;
 	QSet<QString> getCardTypes() const;
 	QSet<QString> getCardColors() const;
 };
@@ -384,11 +384,20 @@ UserInterfaceSettingsPage::UserInterfaceSettingsPage()
         cardInfoStrippedCheckBox->setChecked(settingsCache->getCardInfoStripped());
         connect(cardInfoStrippedCheckBox, SIGNAL(stateChanged(int)), settingsCache, SLOT(setCardInfoStripped(int)));
 
+	messageLogSizeLabel = new QLabel;
+	messageLogSizeSpinBox = new QSpinBox;
+	messageLogSizeSpinBox->setRange(100, 100000);
+	messageLogSizeSpinBox->setSingleStep(100);
+	messageLogSizeSpinBox->setValue(settingsCache->getMessageLogSize());
+	connect(messageLogSizeSpinBox, SIGNAL(valueChanged(int)), settingsCache, SLOT(setMessageLogSize(int)));
+
 	QGridLayout *generalGrid = new QGridLayout;
 	generalGrid->addWidget(doubleClickToPlayCheckBox, 0, 0);
         generalGrid->addWidget(cardInfoFontSizeLabel, 1, 0);
         generalGrid->addWidget(cardInfoFontSizeSpinBox, 1, 1);
         generalGrid->addWidget(cardInfoStrippedCheckBox, 2, 0);
+	generalGrid->addWidget(messageLogSizeLabel, 3, 0);
+	generalGrid->addWidget(messageLogSizeSpinBox, 3, 1);
 	
 	generalGroupBox = new QGroupBox;
 	generalGroupBox->setLayout(generalGrid);
@@ -417,6 +426,7 @@ void UserInterfaceSettingsPage::retranslateUi()
 	animationGroupBox->setTitle(tr("Animation settings"));
 	tapAnimationCheckBox->setText(tr("&Tap/untap animation"));
         cardInfoFontSizeLabel->setText(tr("Card info font size:"));
+	messageLogSizeLabel->setText(tr("Number of chat and game log lines to keep:"));
         cardInfoStrippedCheckBox->setText(tr("Show stripped card picture on card info frame"));
 }
 
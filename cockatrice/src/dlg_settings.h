@@ -82,6 +82,8 @@ private:
 	QCheckBox *tapAnimationCheckBox;
         QLabel *cardInfoFontSizeLabel;
         QSpinBox *cardInfoFontSizeSpinBox;
+	QLabel *messageLogSizeLabel;
+	QSpinBox *messageLogSizeSpinBox;
         QCheckBox *cardInfoStrippedCheckBox;
 	QGroupBox *generalGroupBox, *animationGroupBox;
 public:
@@ -2,12 +2,13 @@
 #include "player.h"
 #include "zoneviewwidget.h"
 #include "zoneviewzone.h"
+#include "arrowitem.h"
 #include <QAction>
 #include <QGraphicsSceneMouseEvent>
 #include <QSet>
 
 GameScene::GameScene(QObject *parent)
-	: QGraphicsScene(parent)
+	: QGraphicsScene(parent), rearrangePending(false), suspended(false)
 {
 }
 
@@ -23,7 +24,7 @@ void GameScene::addPlayer(Player *player)
 	players << player;
 	addItem(player);
 	rearrange();
-	connect(player, SIGNAL(sizeChanged()), this, SLOT(rearrange()));
+	connect(player, SIGNAL(sizeChanged()), this, SLOT(scheduleRearrange()));
 }
 
 void GameScene::removePlayer(Player *player)
@@ -34,8 +35,54 @@ void GameScene::removePlayer(Player *player)
 	rearrange();
 }
 
+void GameScene::scheduleRearrange()
+{
+	// Players change their size once for every zone that is laid out again,
+	// so the scene is only rearranged after all of them are done.
+	if (rearrangePending)
+		return;
+	rearrangePending = true;
+	QMetaObject::invokeMethod(this, "deferredRearrange", Qt::QueuedConnection);
+}
+
+void GameScene::deferredRearrange()
+{
+	if (!rearrangePending || suspended)
+		return;
+	rearrange();
+}
+
+void GameScene::setSuspended(bool _suspended)
+{
+	if (suspended == _suspended)
+		return;
+	suspended = _suspended;
+	if (suspended)
+		return;
+	
+	for (int i = 0; i < players.size(); ++i) {
+		const QVector<CardZone *> &zones = players[i]->getZones();
+		for (int j = 0; j < zones.size(); ++j)
+			if (zones[j])
+				zones[j]->processPendingReorganize();
+	}
+	for (int i = 0; i < views.size(); ++i)
+		views[i]->getZone()->processPendingReorganize();
+	
+	if (rearrangePending)
+		rearrange();
+	
+	// Arrows are placed last, when all cards have reached their positions.
+	for (int i = 0; i < players.size(); ++i) {
+		QMapIterator<int, ArrowItem *> arrowIterator(players[i]->getArrows());
+		while (arrowIterator.hasNext())
+			arrowIterator.next().value()->processPendingUpdatePath();
+	}
+}
+
 void GameScene::rearrange()
 {
+	rearrangePending = false;
 	struct PlayerProcessor {
 		static void processPlayer(Player *p, qreal &w, qreal &h, QPointF &b, bool singlePlayer)
 		{
@@ -82,7 +129,7 @@ void GameScene::toggleZoneView(Player *player, const QString &zoneName, int numb
                 }
         }
 
-	ZoneViewWidget *item = new ZoneViewWidget(player, player->getZones().value(zoneName), numberCards, false);
+	ZoneViewWidget *item = new ZoneViewWidget(player, player->getZone(zoneName), numberCards, false);
         views.append(item);
         connect(item, SIGNAL(closePressed(ZoneViewWidget *)), this, SLOT(removeZoneView(ZoneViewWidget *)));
 	addItem(item);
@@ -18,8 +18,14 @@ private:
 	QRectF playersRect;
 	QList<ZoneViewWidget *> views;
 	QSize viewSize;
+	bool rearrangePending;
+	bool suspended;
 public:
 	GameScene(QObject *parent = 0);
+	bool getSuspended() const { return suspended; }
+	// While suspended, zone layout, arrow updates and rearranging are
+	// deferred and then done in one go when the scene is resumed.
+	void setSuspended(bool _suspended);
 	void retranslateUi();
 	const QRectF &getPlayersRect() const { return playersRect; }
 	void processViewSizeChange(const QSize &newSize);
@@ -37,6 +43,8 @@ public slots:
 	void closeMostRecentZoneView();
 private slots:
 	void rearrange();
+	void scheduleRearrange();
+	void deferredRearrange();
 protected:
 	bool event(QEvent *event);
 signals:
@@ -1,15 +1,9 @@
 #include "gamesmodel.h"
 #include "protocol_datastructures.h"
 
-GamesModel::~GamesModel()
+GamesModel::GameEntry::GameEntry(ServerInfo_Game *game)
+	: gameId(game->getGameId()), description(game->getDescription()), hasPassword(game->getHasPassword()), playerCount(game->getPlayerCount()), maxPlayers(game->getMaxPlayers()), creatorName(game->getCreatorInfo()->getName()), spectatorsAllowed(game->getSpectatorsAllowed()), spectatorsNeedPassword(game->getSpectatorsNeedPassword()), spectatorCount(game->getSpectatorCount())
 {
-	if (!gameList.isEmpty()) {
-		beginRemoveRows(QModelIndex(), 0, gameList.size() - 1);
-		for (int i = 0; i < gameList.size(); ++i)
-			delete gameList[i];
-		gameList.clear();
-		endRemoveRows();
-	}
 }
 
 QVariant GamesModel::data(const QModelIndex &index, int role) const
@@ -23,13 +17,13 @@ QVariant GamesModel::data(const QModelIndex &index, int role) const
 	if ((index.row() >= gameList.size()) || (index.column() >= columnCount()))
 		return QVariant();
 	
-	ServerInfo_Game *g = gameList[index.row()];
+	const GameEntry &g = gameList[index.row()];
 	switch (index.column()) {
-		case 0: return g->getDescription();
-		case 1: return g->getCreatorInfo()->getName();
-		case 2: return g->getHasPassword() ? (g->getSpectatorsNeedPassword() ? tr("yes") : tr("yes, free for spectators")) : tr("no");
-		case 3: return QString("%1/%2").arg(g->getPlayerCount()).arg(g->getMaxPlayers());
-		case 4: return g->getSpectatorsAllowed() ? QVariant(g->getSpectatorCount()) : QVariant(tr("not allowed"));
+		case 0: return g.description;
+		case 1: return g.creatorName;
+		case 2: return g.hasPassword ? (g.spectatorsNeedPassword ? tr("yes") : tr("yes, free for spectators")) : tr("no");
+		case 3: return QString("%1/%2").arg(g.playerCount).arg(g.maxPlayers);
+		case 4: return g.spectatorsAllowed ? QVariant(g.spectatorCount) : QVariant(tr("not allowed"));
 		default: return QVariant();
 	}
 }
@@ -48,33 +42,90 @@ QVariant GamesModel::headerData(int section, Qt::Orientation orientation, int ro
 	}
 }
 
-ServerInfo_Game *GamesModel::getGame(int row)
+const GamesModel::GameEntry &GamesModel::getGame(int row) const
 {
 	Q_ASSERT(row < gameList.size());
 	return gameList[row];
 }
 
-void GamesModel::updateGameList(ServerInfo_Game *_game)
+void GamesModel::updateGameList(ServerInfo_Game *game)
+{
+	// A room can announce many games in one go; they are applied together
+	// once control returns to the event loop.
+	pendingUpdates.insert(game->getGameId(), GameEntry(game));
+	if (!updatePending) {
+		updatePending = true;
+		QMetaObject::invokeMethod(this, "applyPendingUpdates", Qt::QueuedConnection);
+	}
+}
+
+void GamesModel::applyPendingUpdates()
 {
-	ServerInfo_Game *game = new ServerInfo_Game(_game->getGameId(), _game->getDescription(), _game->getHasPassword(), _game->getPlayerCount(), _game->getMaxPlayers(), new ServerInfo_User(_game->getCreatorInfo()), _game->getSpectatorsAllowed(), _game->getSpectatorsNeedPassword(), _game->getSpectatorCount());
-	for (int i = 0; i < gameList.size(); i++)
-		if (gameList[i]->getGameId() == game->getGameId()) {
-			if (game->getPlayerCount() == 0) {
-				beginRemoveRows(QModelIndex(), i, i);
-				delete gameList.takeAt(i);
-				endRemoveRows();
-			} else {
-				delete gameList[i];
-				gameList[i] = game;
-				emit dataChanged(index(i, 0), index(i, 4));
-			}
-			return;
+	updatePending = false;
+	
+	QList<int> changedRows, removedRows;
+	QList<GameEntry> newGames;
+	QMapIterator<int, GameEntry> updateIterator(pendingUpdates);
+	while (updateIterator.hasNext()) {
+		const GameEntry &game = updateIterator.next().value();
+		int row = rowByGameId.value(game.gameId, -1);
+		if (row == -1) {
+			if (game.playerCount != 0)
+				newGames.append(game);
+		} else if (game.playerCount == 0)
+			removedRows.append(row);
+		else {
+			gameList[row] = game;
+			changedRows.append(row);
 		}
-	if (game->getPlayerCount() == 0)
+	}
+	pendingUpdates.clear();
+	
+	// Only the changed rows are reported, so the proxy model does not
+	// have to filter the whole list again.
+	qSort(changedRows);
+	for (int i = 0; i < changedRows.size(); ) {
+		int first = changedRows[i];
+		int last = first;
+		while ((++i < changedRows.size()) && (changedRows[i] == last + 1))
+			++last;
+		emit dataChanged(index(first, 0), index(last, columnCount() - 1));
+	}
+	
+	removeGameRows(removedRows);
+	
+	if (!newGames.isEmpty()) {
+		beginInsertRows(QModelIndex(), gameList.size(), gameList.size() + newGames.size() - 1);
+		for (int i = 0; i < newGames.size(); ++i) {
+			rowByGameId.insert(newGames[i].gameId, gameList.size());
+			gameList.append(newGames[i]);
+		}
+		endInsertRows();
+	}
+}
+
+void GamesModel::removeGameRows(QList<int> rows)
+{
+	if (rows.isEmpty())
 		return;
-	beginInsertRows(QModelIndex(), gameList.size(), gameList.size());
-	gameList.append(game);
-	endInsertRows();
+	
+	// Remove contiguous runs from the bottom up, so that the remaining
+	// row numbers stay valid, and rebuild the index once afterwards.
+	qSort(rows);
+	for (int i = rows.size() - 1; i >= 0; ) {
+		int last = rows[i];
+		int first = last;
+		while ((--i >= 0) && (rows[i] == first - 1))
+			--first;
+		beginRemoveRows(QModelIndex(), first, last);
+		for (int row = last; row >= first; --row)
+			gameList.removeAt(row);
+		endRemoveRows();
+	}
+	
+	rowByGameId.clear();
+	for (int i = 0; i < gameList.size(); ++i)
+		rowByGameId.insert(gameList[i].gameId, i);
 }
 
 GamesProxyModel::GamesProxyModel(QObject *parent)
@@ -98,8 +149,8 @@ bool GamesProxyModel::filterAcceptsRow(int sourceRow, const QModelIndex &/*sourc
 	if (!model)
 		return false;
 	
-	ServerInfo_Game *game = model->getGame(sourceRow);
-	if (game->getPlayerCount() == game->getMaxPlayers())
+	const GamesModel::GameEntry &game = model->getGame(sourceRow);
+	if (game.playerCount == game.maxPlayers)
 		return false;
 	
 	return true;
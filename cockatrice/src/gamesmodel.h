@@ -4,23 +4,46 @@
 #include <QAbstractTableModel>
 #include <QSortFilterProxyModel>
 #include <QList>
+#include <QHash>
+#include <QMap>
 
 class ServerInfo_Game;
 
 class GamesModel : public QAbstractTableModel {
 	Q_OBJECT
 public:
-	GamesModel(QObject *parent = 0) : QAbstractTableModel(parent) { }
-	~GamesModel();
+	class GameEntry {
+	public:
+		int gameId;
+		QString description;
+		bool hasPassword;
+		int playerCount;
+		int maxPlayers;
+		QString creatorName;
+		bool spectatorsAllowed;
+		bool spectatorsNeedPassword;
+		int spectatorCount;
+		GameEntry() { }
+		GameEntry(ServerInfo_Game *game);
+	};
+private:
+	QList<GameEntry> gameList;
+	QHash<int, int> rowByGameId;
+	// Updates received since the last pass, by game id.
+	QMap<int, GameEntry> pendingUpdates;
+	bool updatePending;
+	void removeGameRows(QList<int> rows);
+private slots:
+	void applyPendingUpdates();
+public:
+	GamesModel(QObject *parent = 0) : QAbstractTableModel(parent), updatePending(false) { }
 	int rowCount(const QModelIndex &parent = QModelIndex()) const { return parent.isValid() ? 0 : gameList.size(); }
 	int columnCount(const QModelIndex &/*parent*/ = QModelIndex()) const { return 5; }
 	QVariant data(const QModelIndex &index, int role) const;
 	QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const;
 	
-	ServerInfo_Game *getGame(int row);
+	const GameEntry &getGame(int row) const;
 	void updateGameList(ServerInfo_Game *game);
-private:
-	QList<ServerInfo_Game *> gameList;
 };
 
 class GamesProxyModel : public QSortFilterProxyModel {
@@ -114,6 +114,8 @@ int main(int argc, char *argv[])
 	}
 	
 	if (startMainProgram) {
+		SvgSpriteCache::getInstance()->preloadCommonSizes();
+		
 		MainWindow ui;
 		qDebug("main(): MainWindow constructor finished");
 		
@@ -130,8 +132,7 @@ int main(int argc, char *argv[])
 	delete settingsCache;
 	delete rng;
 	PingPixmapGenerator::clear();
-	CountryPixmapGenerator::clear();
-	UserLevelPixmapGenerator::clear();
+	SvgSpriteCache::destroy();
 	
 	return 0;
 }
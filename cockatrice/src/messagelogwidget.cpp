@@ -2,6 +2,7 @@
 #include "player.h"
 #include "cardzone.h"
 #include "cardinfowidget.h"
+#include "settingscache.h"
 #include <QDebug>
 #include <QMouseEvent>
 #include <QTextBlock>
@@ -16,126 +17,126 @@ QString MessageLogWidget::sanitizeHtml(QString dirty) const
 
 void MessageLogWidget::logConnecting(QString hostname)
 {
-	append(tr("Connecting to %1...").arg(sanitizeHtml(hostname)));
+	appendHtml(tr("Connecting to %1...").arg(sanitizeHtml(hostname)));
 }
 
 void MessageLogWidget::logConnected()
 {
-	append(tr("Connected."));
+	appendHtml(tr("Connected."));
 }
 
 void MessageLogWidget::logDisconnected()
 {
-	append(tr("Disconnected from server."));
+	appendHtml(tr("Disconnected from server."));
 }
 
 void MessageLogWidget::logSocketError(const QString &errorString)
 {
-	append(sanitizeHtml(errorString));
+	appendHtml(sanitizeHtml(errorString));
 }
 
 void MessageLogWidget::logServerError(ResponseCode response)
 {
 	switch (response) {
-		case RespWrongPassword: append(tr("Invalid password.")); break;
+		case RespWrongPassword: appendHtml(tr("Invalid password.")); break;
 		default: ;
 	}
 }
 
 void MessageLogWidget::logProtocolVersionMismatch(int clientVersion, int serverVersion)
 {
-	append(tr("Protocol version mismatch. Client: %1, Server: %2").arg(clientVersion).arg(serverVersion));
+	appendHtml(tr("Protocol version mismatch. Client: %1, Server: %2").arg(clientVersion).arg(serverVersion));
 }
 
 void MessageLogWidget::logProtocolError()
 {
-	append(tr("Protocol error."));
+	appendHtml(tr("Protocol error."));
 }
 
 void MessageLogWidget::logGameJoined(int gameId)
 {
-	append(tr("You have joined game #%1.").arg(gameId));
+	appendHtml(tr("You have joined game #%1.").arg(gameId));
 }
 
 void MessageLogWidget::logJoin(Player *player)
 {
-	append(tr("%1 has joined the game.").arg(sanitizeHtml(player->getName())));
+	appendHtml(tr("%1 has joined the game.").arg(sanitizeHtml(player->getName())));
 }
 
 void MessageLogWidget::logLeave(Player *player)
 {
-	append(tr("%1 has left the game.").arg(sanitizeHtml(player->getName())));
+	appendHtml(tr("%1 has left the game.").arg(sanitizeHtml(player->getName())));
 }
 
 void MessageLogWidget::logGameClosed()
 {
-	append(tr("The game has been closed."));
+	appendHtml(tr("The game has been closed."));
 }
 
 void MessageLogWidget::logJoinSpectator(QString name)
 {
-	append(tr("%1 is now watching the game.").arg(sanitizeHtml(name)));
+	appendHtml(tr("%1 is now watching the game.").arg(sanitizeHtml(name)));
 }
 
 void MessageLogWidget::logLeaveSpectator(QString name)
 {
-	append(tr("%1 is not watching the game any more.").arg(sanitizeHtml(name)));
+	appendHtml(tr("%1 is not watching the game any more.").arg(sanitizeHtml(name)));
 }
 
 void MessageLogWidget::logDeckSelect(Player *player, int deckId)
 {
 	if (deckId == -1)
-		append(tr("%1 has loaded a local deck.").arg(sanitizeHtml(player->getName())));
+		appendHtml(tr("%1 has loaded a local deck.").arg(sanitizeHtml(player->getName())));
 	else
-		append(tr("%1 has loaded deck #%2.").arg(sanitizeHtml(player->getName())).arg(deckId));
+		appendHtml(tr("%1 has loaded deck #%2.").arg(sanitizeHtml(player->getName())).arg(deckId));
 }
 
 void MessageLogWidget::logReadyStart(Player *player)
 {
-	append(tr("%1 is ready to start the game.").arg(sanitizeHtml(player->getName())));
+	appendHtml(tr("%1 is ready to start the game.").arg(sanitizeHtml(player->getName())));
 }
 
 void MessageLogWidget::logNotReadyStart(Player *player)
 {
-	append(tr("%1 is not ready to start the game any more.").arg(sanitizeHtml(player->getName())));
+	appendHtml(tr("%1 is not ready to start the game any more.").arg(sanitizeHtml(player->getName())));
 }
 
 void MessageLogWidget::logConcede(Player *player)
 {
-	append(tr("%1 has conceded the game.").arg(sanitizeHtml(player->getName())));
+	appendHtml(tr("%1 has conceded the game.").arg(sanitizeHtml(player->getName())));
 }
 
 void MessageLogWidget::logGameStart()
 {
-	append(tr("The game has started."));
+	appendHtml(tr("The game has started."));
 }
 
 void MessageLogWidget::logSay(Player *player, QString message)
 {
-	append(QString("<b><font color=\"") + (player->getLocal() ? "red" : "#0000fe") + QString("\">%1:</font></b> %2").arg(sanitizeHtml(player->getName())).arg(sanitizeHtml(message)));
+	appendHtml(QString("<b><font color=\"") + (player->getLocal() ? "red" : "#0000fe") + QString("\">%1:</font></b> %2").arg(sanitizeHtml(player->getName())).arg(sanitizeHtml(message)));
 }
 
 void MessageLogWidget::logSpectatorSay(QString spectatorName, QString message)
 {
-	append(QString("<font color=\"red\">%1:</font> %2").arg(sanitizeHtml(spectatorName)).arg(sanitizeHtml(message)));
+	appendHtml(QString("<font color=\"red\">%1:</font> %2").arg(sanitizeHtml(spectatorName)).arg(sanitizeHtml(message)));
 }
 
 void MessageLogWidget::logShuffle(Player *player)
 {
-	append(tr("%1 shuffles his library.").arg(sanitizeHtml(player->getName())));
+	appendHtml(tr("%1 shuffles his library.").arg(sanitizeHtml(player->getName())));
 }
 
 void MessageLogWidget::logRollDie(Player *player, int sides, int roll)
 {
-	append(tr("%1 rolls a %2 with a %3-sided die.").arg(sanitizeHtml(player->getName())).arg(roll).arg(sides));
+	appendHtml(tr("%1 rolls a %2 with a %3-sided die.").arg(sanitizeHtml(player->getName())).arg(roll).arg(sides));
 }
 
 void MessageLogWidget::logDrawCards(Player *player, int number)
 {
 	if (number == 1)
-		append(tr("%1 draws a card.").arg(sanitizeHtml(player->getName())));
+		appendHtml(tr("%1 draws a card.").arg(sanitizeHtml(player->getName())));
 	else
-		append(tr("%1 draws %2 cards.").arg(sanitizeHtml(player->getName())).arg(number));
+		appendHtml(tr("%1 draws %2 cards.").arg(sanitizeHtml(player->getName())).arg(number));
 }
 
 QPair<QString, QString> MessageLogWidget::getFromStr(CardZone *zone, QString cardName, int position) const
@@ -199,7 +200,7 @@ void MessageLogWidget::logMoveCard(Player *player, QString cardName, CardZone *s
 		cardStr = QString("<font color=\"blue\">%1</font>").arg(sanitizeHtml(cardName));
 
 	if (startZone->getPlayer() != targetZone->getPlayer()) {
-		append(tr("%1 gives %2 control over %3.").arg(sanitizeHtml(player->getName())).arg(sanitizeHtml(targetZone->getPlayer()->getName())).arg(cardStr));
+		appendHtml(tr("%1 gives %2 control over %3.").arg(sanitizeHtml(player->getName())).arg(sanitizeHtml(targetZone->getPlayer()->getName())).arg(cardStr));
 		return;
 	}
 	
@@ -226,48 +227,48 @@ void MessageLogWidget::logMoveCard(Player *player, QString cardName, CardZone *s
 	else if (targetName == "stack")
 		finalStr = tr("%1 plays %2%3.");
 	
-	append(finalStr.arg(sanitizeHtml(player->getName())).arg(cardStr).arg(fromStr).arg(newX));
+	appendHtml(finalStr.arg(sanitizeHtml(player->getName())).arg(cardStr).arg(fromStr).arg(newX));
 }
 
 void MessageLogWidget::logFlipCard(Player *player, QString cardName, bool faceDown)
 {
 	if (faceDown)
-		append(tr("%1 flips %2 face-down.").arg(sanitizeHtml(player->getName())).arg(cardName));
+		appendHtml(tr("%1 flips %2 face-down.").arg(sanitizeHtml(player->getName())).arg(cardName));
 	else
-		append(tr("%1 flips %2 face-up.").arg(sanitizeHtml(player->getName())).arg(cardName));
+		appendHtml(tr("%1 flips %2 face-up.").arg(sanitizeHtml(player->getName())).arg(cardName));
 }
 
 void MessageLogWidget::logDestroyCard(Player *player, QString cardName)
 {
-	append(tr("%1 destroys %2.").arg(sanitizeHtml(player->getName())).arg(QString("<font color=\"blue\">%1</font>").arg(sanitizeHtml(cardName))));
+	appendHtml(tr("%1 destroys %2.").arg(sanitizeHtml(player->getName())).arg(QString("<font color=\"blue\">%1</font>").arg(sanitizeHtml(cardName))));
 }
 
 void MessageLogWidget::logAttachCard(Player *player, QString cardName, Player *targetPlayer, QString targetCardName)
 {
-	append(tr("%1 attaches %2 to %3's %4.").arg(sanitizeHtml(player->getName())).arg(QString("<font color=\"blue\">%1</font>").arg(sanitizeHtml(cardName))).arg(sanitizeHtml(targetPlayer->getName())).arg(QString("<font color=\"blue\">%1</font>").arg(sanitizeHtml(targetCardName))));
+	appendHtml(tr("%1 attaches %2 to %3's %4.").arg(sanitizeHtml(player->getName())).arg(QString("<font color=\"blue\">%1</font>").arg(sanitizeHtml(cardName))).arg(sanitizeHtml(targetPlayer->getName())).arg(QString("<font color=\"blue\">%1</font>").arg(sanitizeHtml(targetCardName))));
 }
 
 void MessageLogWidget::logUnattachCard(Player *player, QString cardName)
 {
-	append(tr("%1 unattaches %2.").arg(sanitizeHtml(player->getName())).arg(QString("<font color=\"blue\">%1</font>").arg(sanitizeHtml(cardName))));
+	appendHtml(tr("%1 unattaches %2.").arg(sanitizeHtml(player->getName())).arg(QString("<font color=\"blue\">%1</font>").arg(sanitizeHtml(cardName))));
 }
 
 void MessageLogWidget::logCreateToken(Player *player, QString cardName, QString pt)
 {
-	append(tr("%1 creates token: %2%3.").arg(sanitizeHtml(player->getName())).arg(QString("<font color=\"blue\"><a name=\"foo\">%1</a></font>").arg(sanitizeHtml(cardName))).arg(pt.isEmpty() ? QString() : QString(" (%1)").arg(sanitizeHtml(pt))));
+	appendHtml(tr("%1 creates token: %2%3.").arg(sanitizeHtml(player->getName())).arg(QString("<font color=\"blue\"><a name=\"foo\">%1</a></font>").arg(sanitizeHtml(cardName))).arg(pt.isEmpty() ? QString() : QString(" (%1)").arg(sanitizeHtml(pt))));
 }
 
 void MessageLogWidget::logCreateArrow(Player *player, Player *startPlayer, QString startCard, Player *targetPlayer, QString targetCard, bool playerTarget)
 {
 	if (playerTarget)
-		append(tr("%1 points from %2's %3 to %4.")
+		appendHtml(tr("%1 points from %2's %3 to %4.")
 			.arg(sanitizeHtml(player->getName()))
 			.arg(sanitizeHtml(startPlayer->getName()))
 			.arg(sanitizeHtml(startCard))
 			.arg(sanitizeHtml(targetPlayer->getName()))
 		);
 	else
-		append(tr("%1 points from %2's %3 to %4's %5.")
+		appendHtml(tr("%1 points from %2's %3 to %4's %5.")
 			.arg(sanitizeHtml(player->getName()))
 			.arg(sanitizeHtml(startPlayer->getName()))
 			.arg(sanitizeHtml(startCard))
@@ -293,7 +294,7 @@ void MessageLogWidget::logSetCardCounter(Player *player, QString cardName, int c
 		default: ;
 	}
 	
-	append(finalStr.arg(sanitizeHtml(player->getName())).arg(colorStr).arg(QString("<font color=\"blue\">%1</font>").arg(sanitizeHtml(cardName))).arg(value));
+	appendHtml(finalStr.arg(sanitizeHtml(player->getName())).arg(colorStr).arg(QString("<font color=\"blue\">%1</font>").arg(sanitizeHtml(cardName))).arg(value));
 }
 
 void MessageLogWidget::logSetTapped(Player *player, QString cardName, bool tapped)
@@ -303,12 +304,12 @@ void MessageLogWidget::logSetTapped(Player *player, QString cardName, bool tappe
 		cardStr = tr("his permanents");
 	else
 		cardStr = QString("<font color=\"blue\">%1</font>").arg(sanitizeHtml(cardName));
-	append(tr("%1 %2 %3.").arg(sanitizeHtml(player->getName())).arg(tapped ? tr("taps") : tr("untaps")).arg(cardStr));
+	appendHtml(tr("%1 %2 %3.").arg(sanitizeHtml(player->getName())).arg(tapped ? tr("taps") : tr("untaps")).arg(cardStr));
 }
 
 void MessageLogWidget::logSetCounter(Player *player, QString counterName, int value, int oldValue)
 {
-	append(tr("%1 sets counter %2 to %3 (%4%5).").arg(sanitizeHtml(player->getName())).arg(QString("<font color=\"blue\">%1</font>").arg(sanitizeHtml(counterName))).arg(QString("<font color=\"blue\">%1</font>").arg(value)).arg(value > oldValue ? "+" : "").arg(value - oldValue));
+	appendHtml(tr("%1 sets counter %2 to %3 (%4%5).").arg(sanitizeHtml(player->getName())).arg(QString("<font color=\"blue\">%1</font>").arg(sanitizeHtml(counterName))).arg(QString("<font color=\"blue\">%1</font>").arg(value)).arg(value > oldValue ? "+" : "").arg(value - oldValue));
 }
 
 void MessageLogWidget::logSetDoesntUntap(Player *player, QString cardName, bool doesntUntap)
@@ -318,31 +319,31 @@ void MessageLogWidget::logSetDoesntUntap(Player *player, QString cardName, bool
 		finalStr = tr("%1 sets %2 to not untap normally.");
 	else
 		finalStr = tr("%1 sets %2 to untap normally.");
-	append(finalStr.arg(sanitizeHtml(player->getName())).arg(QString("<font color=\"blue\">%1</font>").arg(sanitizeHtml(cardName))));
+	appendHtml(finalStr.arg(sanitizeHtml(player->getName())).arg(QString("<font color=\"blue\">%1</font>").arg(sanitizeHtml(cardName))));
 }
 
 void MessageLogWidget::logSetPT(Player *player, QString cardName, QString newPT)
 {
-	append(tr("%1 sets PT of %2 to %3.").arg(sanitizeHtml(player->getName())).arg(QString("<font color=\"blue\">%1</font>").arg(sanitizeHtml(cardName))).arg(QString("<font color=\"blue\">%1</font>").arg(sanitizeHtml(newPT))));
+	appendHtml(tr("%1 sets PT of %2 to %3.").arg(sanitizeHtml(player->getName())).arg(QString("<font color=\"blue\">%1</font>").arg(sanitizeHtml(cardName))).arg(QString("<font color=\"blue\">%1</font>").arg(sanitizeHtml(newPT))));
 }
 
 void MessageLogWidget::logSetAnnotation(Player *player, QString cardName, QString newAnnotation)
 {
-	append(tr("%1 sets annotation of %2 to %3.").arg(sanitizeHtml(player->getName())).arg(QString("<font color=\"blue\">%1</font>").arg(sanitizeHtml(cardName))).arg(QString("<font color=\"blue\">%1</font>").arg(sanitizeHtml(newAnnotation))));
+	appendHtml(tr("%1 sets annotation of %2 to %3.").arg(sanitizeHtml(player->getName())).arg(QString("<font color=\"blue\">%1</font>").arg(sanitizeHtml(cardName))).arg(QString("<font color=\"blue\">%1</font>").arg(sanitizeHtml(newAnnotation))));
 }
 
 void MessageLogWidget::logDumpZone(Player *player, CardZone *zone, int numberCards)
 {
 	if (numberCards != -1)
-		append(tr("%1 is looking at the top %2 cards %3.").arg(sanitizeHtml(player->getName())).arg(numberCards).arg(zone->getTranslatedName(zone->getPlayer() == player, CaseGenitive)));
+		appendHtml(tr("%1 is looking at the top %2 cards %3.").arg(sanitizeHtml(player->getName())).arg(numberCards).arg(zone->getTranslatedName(zone->getPlayer() == player, CaseGenitive)));
 	else
-		append(tr("%1 is looking at %2.").arg(sanitizeHtml(player->getName())).arg(zone->getTranslatedName(zone->getPlayer() == player, CaseAccusative)));
+		appendHtml(tr("%1 is looking at %2.").arg(sanitizeHtml(player->getName())).arg(zone->getTranslatedName(zone->getPlayer() == player, CaseAccusative)));
 }
 
 void MessageLogWidget::logStopDumpZone(Player *player, CardZone *zone)
 {
 	QString zoneName = zone->getTranslatedName(zone->getPlayer() == player, CaseAccusative);
-	append(tr("%1 stops looking at %2.").arg(sanitizeHtml(player->getName())).arg(zoneName));
+	appendHtml(tr("%1 stops looking at %2.").arg(sanitizeHtml(player->getName())).arg(zoneName));
 }
 
 void MessageLogWidget::logRevealCards(Player *player, CardZone *zone, int cardId, QString cardName, Player *otherPlayer)
@@ -365,27 +366,27 @@ void MessageLogWidget::logRevealCards(Player *player, CardZone *zone, int cardId
 
 	if (cardId == -1) {
 		if (otherPlayer)
-			append(tr("%1 reveals %2 to %3.").arg(sanitizeHtml(player->getName())).arg(zone->getTranslatedName(true, CaseAccusative)).arg(sanitizeHtml(otherPlayer->getName())));
+			appendHtml(tr("%1 reveals %2 to %3.").arg(sanitizeHtml(player->getName())).arg(zone->getTranslatedName(true, CaseAccusative)).arg(sanitizeHtml(otherPlayer->getName())));
 		else
-			append(tr("%1 reveals %2.").arg(sanitizeHtml(player->getName())).arg(zone->getTranslatedName(true, CaseAccusative)));
+			appendHtml(tr("%1 reveals %2.").arg(sanitizeHtml(player->getName())).arg(zone->getTranslatedName(true, CaseAccusative)));
 	} else if (cardId == -2) {
 		if (otherPlayer)
-			append(tr("%1 randomly reveals %2%3 to %4.").arg(sanitizeHtml(player->getName())).arg(cardStr).arg(fromStr).arg(sanitizeHtml(otherPlayer->getName())));
+			appendHtml(tr("%1 randomly reveals %2%3 to %4.").arg(sanitizeHtml(player->getName())).arg(cardStr).arg(fromStr).arg(sanitizeHtml(otherPlayer->getName())));
 		else
-			append(tr("%1 randomly reveals %2%3.").arg(sanitizeHtml(player->getName())).arg(cardStr).arg(fromStr));
+			appendHtml(tr("%1 randomly reveals %2%3.").arg(sanitizeHtml(player->getName())).arg(cardStr).arg(fromStr));
 	} else {
 		if (otherPlayer)
-			append(tr("%1 reveals %2%3 to %4.").arg(sanitizeHtml(player->getName())).arg(cardStr).arg(fromStr).arg(sanitizeHtml(otherPlayer->getName())));
+			appendHtml(tr("%1 reveals %2%3 to %4.").arg(sanitizeHtml(player->getName())).arg(cardStr).arg(fromStr).arg(sanitizeHtml(otherPlayer->getName())));
 		else
-			append(tr("%1 reveals %2%3.").arg(sanitizeHtml(player->getName())).arg(cardStr).arg(fromStr));
+			appendHtml(tr("%1 reveals %2%3.").arg(sanitizeHtml(player->getName())).arg(cardStr).arg(fromStr));
 	}
 }
 
 void MessageLogWidget::logSetActivePlayer(Player *player)
 {
-	append(QString());
-	append("<font color=\"green\"><b>" + tr("It is now %1's turn.").arg(player->getName()) + "</b></font>");
-	append(QString());
+	appendHtml(QString());
+	appendHtml("<font color=\"green\"><b>" + tr("It is now %1's turn.").arg(player->getName()) + "</b></font>");
+	appendHtml(QString());
 }
 
 void MessageLogWidget::logSetActivePhase(int phase)
@@ -404,7 +405,7 @@ void MessageLogWidget::logSetActivePhase(int phase)
 		case 9: phaseName = tr("second main phase"); break;
 		case 10: phaseName = tr("ending phase"); break;
 	}
-	append("<font color=\"green\"><b>" + tr("It is now the %1.").arg(phaseName) + "</b></font>");
+	appendHtml("<font color=\"green\"><b>" + tr("It is now the %1.").arg(phaseName) + "</b></font>");
 }
 
 void MessageLogWidget::connectToPlayer(Player *player)
@@ -432,14 +433,23 @@ void MessageLogWidget::connectToPlayer(Player *player)
 }
 
 MessageLogWidget::MessageLogWidget(QWidget *parent)
-	: QTextEdit(parent)
+	: QPlainTextEdit(parent)
 {
 	setReadOnly(true);
+	// Only the visible part of the log is laid out, and the oldest
+	// messages are dropped once the configured size is reached.
+	setMaximumBlockCount(settingsCache->getMessageLogSize());
+	connect(settingsCache, SIGNAL(messageLogSizeChanged()), this, SLOT(updateMaximumBlockCount()));
 	QFont f;
 	f.setPixelSize(11);
 	setFont(f);
 }
 
+void MessageLogWidget::updateMaximumBlockCount()
+{
+	setMaximumBlockCount(settingsCache->getMessageLogSize());
+}
+
 void MessageLogWidget::enterEvent(QEvent * /*event*/)
 {
 	setMouseTracking(true);
@@ -477,7 +487,7 @@ void MessageLogWidget::mouseMoveEvent(QMouseEvent *event)
 	} else
 		viewport()->setCursor(Qt::IBeamCursor);
 
-	QTextEdit::mouseMoveEvent(event);
+	QPlainTextEdit::mouseMoveEvent(event);
 }
 
 void MessageLogWidget::mousePressEvent(QMouseEvent *event)
@@ -488,12 +498,12 @@ void MessageLogWidget::mousePressEvent(QMouseEvent *event)
 			emit showCardInfoPopup(event->globalPos(), cardName);
 	}
 		
-	QTextEdit::mousePressEvent(event);
+	QPlainTextEdit::mousePressEvent(event);
 }
 
 void MessageLogWidget::mouseReleaseEvent(QMouseEvent *event)
 {
 	emit deleteCardInfoPopup();
 	
-	QTextEdit::mouseReleaseEvent(event);
+	QPlainTextEdit::mouseReleaseEvent(event);
 }
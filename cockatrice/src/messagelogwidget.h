@@ -1,7 +1,7 @@
 #ifndef MESSAGELOGWIDGET_H
 #define MESSAGELOGWIDGET_H
 
-#include <QTextEdit>
+#include <QPlainTextEdit>
 #include <QAbstractSocket>
 #include "translation.h"
 #include "protocol_datastructures.h"
@@ -12,13 +12,15 @@ class QMouseEvent;
 class QEvent;
 class CardInfoWidget;
 
-class MessageLogWidget : public QTextEdit {
+class MessageLogWidget : public QPlainTextEdit {
 	Q_OBJECT
 private:
 	CardInfoWidget *infoWidget;
 	QString sanitizeHtml(QString dirty) const;
 	QPair<QString, QString> getFromStr(CardZone *zone, QString cardName, int position) const;
 	QString getCardNameUnderMouse(const QPoint &pos) const;
+private slots:
+	void updateMaximumBlockCount();
 signals:
 	void cardNameHovered(QString cardName);
 	void showCardInfoPopup(QPoint pos, QString cardName);
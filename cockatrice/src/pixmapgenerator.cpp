@@ -2,35 +2,219 @@
 #include "protocol_datastructures.h"
 #include <QPainter>
 #include <QSvgRenderer>
+#include <QDir>
 #include <math.h>
 #include <QDebug>
 
-QMap<QString, QPixmap> CounterPixmapGenerator::pmCache;
+SpriteSheetLoadingThread::SpriteSheetLoadingThread(QObject *parent)
+	: QThread(parent), abortRequested(false)
+{
+}
+
+SpriteSheetLoadingThread::~SpriteSheetLoadingThread()
+{
+	mutex.lock();
+	abortRequested = true;
+	loadQueue.clear();
+	mutex.unlock();
+	wait();
+}
+
+QImage SpriteSheetLoadingThread::renderSprite(const QString &fileName, int height, bool drawFrame)
+{
+	QSvgRenderer svg(fileName);
+	if (!svg.isValid() || svg.defaultSize().isEmpty())
+		return QImage();
+
+	int width = (int) round(height * (double) svg.defaultSize().width() / (double) svg.defaultSize().height());
+	QImage image(width, height, QImage::Format_ARGB32_Premultiplied);
+	image.fill(0);
+	QPainter painter(&image);
+	svg.render(&painter, QRectF(0, 0, width, height));
+	if (drawFrame) {
+		painter.setPen(Qt::black);
+		painter.drawRect(QRectF(0.5, 0.5, width - 1, height - 1));
+	}
+	return image;
+}
+
+void SpriteSheetLoadingThread::run()
+{
+	forever {
+		mutex.lock();
+		if (loadQueue.isEmpty() || abortRequested) {
+			mutex.unlock();
+			return;
+		}
+		SheetToLoad queueItem = loadQueue.takeFirst();
+		mutex.unlock();
+
+		QList<QImage> sprites;
+		int sheetWidth = 0;
+		for (int i = 0; i < queueItem.fileNames.size(); ++i) {
+			sprites.append(renderSprite(queueItem.fileNames[i], queueItem.height, queueItem.drawFrame));
+			sheetWidth += sprites.last().width();
+		}
+
+		Sheet sheet;
+		sheet.family = queueItem.family;
+		sheet.height = queueItem.height;
+		sheet.image = QImage(qMax(sheetWidth, 1), queueItem.height, QImage::Format_ARGB32_Premultiplied);
+		sheet.image.fill(0);
+		QPainter painter(&sheet.image);
+		int x = 0;
+		for (int i = 0; i < sprites.size(); ++i) {
+			painter.drawImage(x, 0, sprites[i]);
+			sheet.rects.append(QRect(x, 0, sprites[i].width(), sprites[i].height()));
+			x += sprites[i].width();
+		}
+		painter.end();
+
+		mutex.lock();
+		loadedSheets.append(sheet);
+		mutex.unlock();
+		emit sheetsLoaded();
+	}
+}
+
+void SpriteSheetLoadingThread::loadSheet(int family, int height, const QStringList &fileNames, bool drawFrame)
+{
+	SheetToLoad item;
+	item.family = family;
+	item.height = height;
+	item.fileNames = fileNames;
+	item.drawFrame = drawFrame;
+
+	QMutexLocker locker(&mutex);
+	loadQueue.append(item);
+
+	if (!isRunning())
+		start(LowPriority);
+}
+
+QList<SpriteSheetLoadingThread::Sheet> SpriteSheetLoadingThread::takeLoadedSheets()
+{
+	QMutexLocker locker(&mutex);
+	QList<Sheet> result = loadedSheets;
+	loadedSheets.clear();
+	return result;
+}
+
+SvgSpriteCache *SvgSpriteCache::instance = 0;
+
+SvgSpriteCache::SvgSpriteCache()
+	: QObject(), useCounter(0)
+{
+	initFamily(Counters, ":/resources/counters/", QStringList(), false);
+	initFamily(Countries, ":/resources/countries/", QStringList(), true);
+	initFamily(UserLevels, ":/resources/userlevels/", QStringList() << "normal" << "registered" << "judge" << "admin", false);
+
+	loadingThread = new SpriteSheetLoadingThread(this);
+	connect(loadingThread, SIGNAL(sheetsLoaded()), this, SLOT(sheetsLoaded()), Qt::QueuedConnection);
+}
+
+SvgSpriteCache::~SvgSpriteCache()
+{
+	delete loadingThread;
+}
+
+SvgSpriteCache *SvgSpriteCache::getInstance()
+{
+	if (!instance)
+		instance = new SvgSpriteCache;
+	return instance;
+}
+
+void SvgSpriteCache::destroy()
+{
+	delete instance;
+	instance = 0;
+}
+
+void SvgSpriteCache::initFamily(Family family, const QString &path, const QStringList &names, bool drawFrame)
+{
+	FamilyData &f = families[family];
+	QStringList spriteNames = names;
+	if (spriteNames.isEmpty()) {
+		QStringList fileNames = QDir(path).entryList(QStringList() << "*.svg", QDir::Files, QDir::Name);
+		for (int i = 0; i < fileNames.size(); ++i)
+			spriteNames.append(fileNames[i].left(fileNames[i].size() - 4));
+	}
+	for (int i = 0; i < spriteNames.size(); ++i) {
+		f.fileNames.append(path + spriteNames[i] + ".svg");
+		f.indexByName.insert(spriteNames[i], i);
+	}
+	f.drawFrame = drawFrame;
+}
+
+void SvgSpriteCache::preloadCommonSizes()
+{
+	// User lists and player lists use 12 pixels, the user info box 15.
+	const int heights[] = { 12, 15 };
+	for (int i = 0; i < 2; ++i) {
+		loadingThread->loadSheet(Countries, heights[i], families[Countries].fileNames, families[Countries].drawFrame);
+		loadingThread->loadSheet(UserLevels, heights[i], families[UserLevels].fileNames, families[UserLevels].drawFrame);
+	}
+}
+
+void SvgSpriteCache::sheetsLoaded()
+{
+	QList<SpriteSheetLoadingThread::Sheet> loadedSheets = loadingThread->takeLoadedSheets();
+	for (int i = 0; i < loadedSheets.size(); ++i) {
+		const SpriteSheetLoadingThread::Sheet &loadedSheet = loadedSheets[i];
+		Sheet &sheet = families[loadedSheet.family].sheets[loadedSheet.height];
+		sheet.pixmap = QPixmap::fromImage(loadedSheet.image);
+		sheet.rects = loadedSheet.rects;
+		if (!sheet.lastUse)
+			sheet.lastUse = ++useCounter;
+		evictSheets((Family) loadedSheet.family);
+	}
+}
+
+void SvgSpriteCache::evictSheets(Family family)
+{
+	QMap<int, Sheet> &sheets = families[family].sheets;
+	while (sheets.size() > maxHeightsPerFamily) {
+		QMap<int, Sheet>::iterator oldest = sheets.begin();
+		for (QMap<int, Sheet>::iterator i = sheets.begin(); i != sheets.end(); ++i)
+			if (i.value().lastUse < oldest.value().lastUse)
+				oldest = i;
+		sheets.erase(oldest);
+	}
+}
+
+QPixmap SvgSpriteCache::getPixmap(Family family, int index, int height)
+{
+	FamilyData &f = families[family];
+	if ((index < 0) || (index >= f.fileNames.size()) || (height <= 0))
+		return QPixmap();
+
+	QPixmap result;
+	{
+		Sheet &sheet = f.sheets[height];
+		sheet.lastUse = ++useCounter;
+		result = sheet.sprites.value(index);
+		if (result.isNull()) {
+			if (!sheet.pixmap.isNull())
+				result = sheet.pixmap.copy(sheet.rects[index]);
+			else
+				result = QPixmap::fromImage(SpriteSheetLoadingThread::renderSprite(f.fileNames[index], height, f.drawFrame));
+			sheet.sprites.insert(index, result);
+		}
+	}
+	evictSheets(family);
+	return result;
+}
 
 QPixmap CounterPixmapGenerator::generatePixmap(int height, QString name, bool highlight)
 {
 	if (highlight)
 		name.append("_highlight");
-	QString key = name + QString::number(height);
-	if (pmCache.contains(key))
-		return pmCache.value(key);
-	
-	QSvgRenderer svg(QString(":/resources/counters/" + name + ".svg"));
-	
-	if (!svg.isValid()) {
-		name = "general";
-		if (highlight)
-			name.append("_highlight");
-		svg.load(QString(":/resources/counters/" + name + ".svg"));
-	}
-	
-	int width = (int) round(height * (double) svg.defaultSize().width() / (double) svg.defaultSize().height());
-	QPixmap pixmap(width, height);
-	pixmap.fill(Qt::transparent);
-	QPainter painter(&pixmap);
-	svg.render(&painter, QRectF(0, 0, width, height));
-	pmCache.insert(key, pixmap);
-	return pixmap;
+	SvgSpriteCache *cache = SvgSpriteCache::getInstance();
+	int index = cache->getIndex(SvgSpriteCache::Counters, name);
+	if (index == -1)
+		index = cache->getIndex(SvgSpriteCache::Counters, highlight ? "general_highlight" : "general");
+	return cache->getPixmap(SvgSpriteCache::Counters, index, height);
 }
 
 QPixmap PingPixmapGenerator::generatePixmap(int size, int value, int max)
@@ -38,7 +222,7 @@ QPixmap PingPixmapGenerator::generatePixmap(int size, int value, int max)
 	int key = size * 1000000 + max * 1000 + value;
 	if (pmCache.contains(key))
 		return pmCache.value(key);
-	
+
 	QPixmap pixmap(size, size);
 	pixmap.fill(Qt::transparent);
 	QPainter painter(&pixmap);
@@ -47,12 +231,12 @@ QPixmap PingPixmapGenerator::generatePixmap(int size, int value, int max)
 		color = Qt::black;
 	else
 		color.setHsv(120 * (1.0 - ((double) value / max)), 255, 255);
-	
+
 	QRadialGradient g(QPointF((double) pixmap.width() / 2, (double) pixmap.height() / 2), qMin(pixmap.width(), pixmap.height()) / 2.0);
 	g.setColorAt(0, color);
 	g.setColorAt(1, Qt::transparent);
 	painter.fillRect(0, 0, pixmap.width(), pixmap.height(), QBrush(g));
-	
+
 	pmCache.insert(key, pixmap);
 
 	return pixmap;
@@ -64,31 +248,12 @@ QPixmap CountryPixmapGenerator::generatePixmap(int height, const QString &countr
 {
 	if (countryCode.size() != 2)
 		return QPixmap();
-	QString key = countryCode + QString::number(height);
-	if (pmCache.contains(key))
-		return pmCache.value(key);
-	
-	QSvgRenderer svg(QString(":/resources/countries/" + countryCode + ".svg"));
-	int width = (int) round(height * (double) svg.defaultSize().width() / (double) svg.defaultSize().height());
-	QPixmap pixmap(width, height);
-	pixmap.fill(Qt::transparent);
-	QPainter painter(&pixmap);
-	svg.render(&painter, QRectF(0, 0, width, height));
-	painter.setPen(Qt::black);
-	painter.drawRect(0.5, 0.5, width - 1, height - 1);
-	
-	pmCache.insert(key, pixmap);
-	return pixmap;
+	SvgSpriteCache *cache = SvgSpriteCache::getInstance();
+	return cache->getPixmap(SvgSpriteCache::Countries, cache->getIndex(SvgSpriteCache::Countries, countryCode), height);
 }
 
-QMap<QString, QPixmap> CountryPixmapGenerator::pmCache;
-
 QPixmap UserLevelPixmapGenerator::generatePixmap(int height, int userLevel)
 {
-	int key = height * 10000 + userLevel;
-	if (pmCache.contains(key))
-		return pmCache.value(key);
-	
 	QString levelString;
 	if (userLevel & ServerInfo_User::IsAdmin)
 		levelString = "admin";
@@ -98,15 +263,6 @@ QPixmap UserLevelPixmapGenerator::generatePixmap(int height, int userLevel)
 		levelString = "registered";
 	else
 		levelString = "normal";
-	QSvgRenderer svg(QString(":/resources/userlevels/" + levelString + ".svg"));
-	int width = (int) round(height * (double) svg.defaultSize().width() / (double) svg.defaultSize().height());
-	QPixmap pixmap(width, height);
-	pixmap.fill(Qt::transparent);
-	QPainter painter(&pixmap);
-	svg.render(&painter, QRectF(0, 0, width, height));
-	
-	pmCache.insert(key, pixmap);
-	return pixmap;
+	SvgSpriteCache *cache = SvgSpriteCache::getInstance();
+	return cache->getPixmap(SvgSpriteCache::UserLevels, cache->getIndex(SvgSpriteCache::UserLevels, levelString), height);
 }
-
-QMap<int, QPixmap> UserLevelPixmapGenerator::pmCache;
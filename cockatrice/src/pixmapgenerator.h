@@ -2,14 +2,95 @@
 #define PIXMAPGENERATOR_H
 
 #include <QPixmap>
+#include <QImage>
 #include <QMap>
+#include <QHash>
+#include <QStringList>
+#include <QThread>
+#include <QMutex>
 
-class CounterPixmapGenerator {
+class SpriteSheetLoadingThread : public QThread {
+	Q_OBJECT
+public:
+	class Sheet {
+	public:
+		int family;
+		int height;
+		QImage image;
+		QList<QRect> rects;
+	};
 private:
-	static QMap<QString, QPixmap> pmCache;
+	class SheetToLoad {
+	public:
+		int family;
+		int height;
+		QStringList fileNames;
+		bool drawFrame;
+	};
+	QList<SheetToLoad> loadQueue;
+	QList<Sheet> loadedSheets;
+	QMutex mutex;
+	bool abortRequested;
+protected:
+	void run();
+public:
+	SpriteSheetLoadingThread(QObject *parent);
+	~SpriteSheetLoadingThread();
+	void loadSheet(int family, int height, const QStringList &fileNames, bool drawFrame);
+	QList<Sheet> takeLoadedSheets();
+	// Rendering into a QImage is safe outside of the GUI thread.
+	static QImage renderSprite(const QString &fileName, int height, bool drawFrame);
+signals:
+	void sheetsLoaded();
+};
+
+// Rasterized SVG resources, kept as one sprite sheet per family and height.
+// The heights used by the user and player lists are rendered in the
+// background at startup; other heights are rasterized one sprite at a time
+// when they are first needed. Only the most recently used heights of each
+// family are kept.
+class SvgSpriteCache : public QObject {
+	Q_OBJECT
+public:
+	enum Family { Counters, Countries, UserLevels, FamilyCount };
+private:
+	static const int maxHeightsPerFamily = 8;
+	class Sheet {
+	public:
+		QPixmap pixmap;
+		QList<QRect> rects;
+		QHash<int, QPixmap> sprites;
+		int lastUse;
+		Sheet() : lastUse(0) { }
+	};
+	class FamilyData {
+	public:
+		QStringList fileNames;
+		QHash<QString, int> indexByName;
+		bool drawFrame;
+		QMap<int, Sheet> sheets;
+	};
+	static SvgSpriteCache *instance;
+	FamilyData families[FamilyCount];
+	int useCounter;
+	SpriteSheetLoadingThread *loadingThread;
+	SvgSpriteCache();
+	void initFamily(Family family, const QString &path, const QStringList &names, bool drawFrame);
+	void evictSheets(Family family);
+private slots:
+	void sheetsLoaded();
+public:
+	~SvgSpriteCache();
+	static SvgSpriteCache *getInstance();
+	static void destroy();
+	void preloadCommonSizes();
+	int getIndex(Family family, const QString &name) const { return families[family].indexByName.value(name, -1); }
+	QPixmap getPixmap(Family family, int index, int height);
+};
+
+class CounterPixmapGenerator {
 public:
 	static QPixmap generatePixmap(int size, QString name, bool highlight);
-	static void clear() { pmCache.clear(); }
 };
 
 class PingPixmapGenerator {
@@ -21,19 +102,13 @@ public:
 };
 
 class CountryPixmapGenerator {
-private:
-	static QMap<QString, QPixmap> pmCache;
 public:
 	static QPixmap generatePixmap(int height, const QString &countryCode);
-	static void clear() { pmCache.clear(); }
 };
 
 class UserLevelPixmapGenerator {
-private:
-	static QMap<int, QPixmap> pmCache;
 public:
 	static QPixmap generatePixmap(int height, int userLevel);
-	static void clear() { pmCache.clear(); }
 };
 
 #endif
@@ -263,9 +263,8 @@ Player::~Player()
 	
 	clearArrows();
 
-	QMapIterator<QString, CardZone *> i(zones);
-	while (i.hasNext())
-		delete i.next().value();
+	for (int i = 0; i < zones.size(); ++i)
+		delete zones[i];
 
 	clearCounters();
 	delete playerMenu;
@@ -438,9 +437,9 @@ void Player::retranslateUi()
 			allPlayersActions[i]->setText(tr("&All players"));
 	}
 	
-	QMapIterator<QString, CardZone *> zoneIterator(zones);
-	while (zoneIterator.hasNext())
-		zoneIterator.next().value()->retranslateUi();
+	for (int i = 0; i < zones.size(); ++i)
+		if (zones[i])
+			zones[i]->retranslateUi();
 }
 
 void Player::setShortcutsActive()
@@ -560,7 +559,7 @@ void Player::actMoveTopCardsToGrave()
 		return;
 
 	QList<Command *> commandList;
-	const int maxCards = zones.value("deck")->getCards().size();
+	const int maxCards = zones[DeckZoneId]->getCards().size();
 	if (number > maxCards)
 		number = maxCards;
 	QList<CardId *> idList;
@@ -576,7 +575,7 @@ void Player::actMoveTopCardsToExile()
 		return;
 
 	QList<Command *> commandList;
-	const int maxCards = zones.value("deck")->getCards().size();
+	const int maxCards = zones[DeckZoneId]->getCards().size();
 	if (number > maxCards)
 		number = maxCards;
 	QList<CardId *> idList;
@@ -695,7 +694,7 @@ void Player::eventDeleteArrow(Event_DeleteArrow *event)
 
 void Player::eventCreateToken(Event_CreateToken *event)
 {
-	CardZone *zone = zones.value(event->getZone(), 0);
+	CardZone *zone = getZone(event->getZoneRef());
 	if (!zone)
 		return;
 
@@ -712,7 +711,7 @@ void Player::eventCreateToken(Event_CreateToken *event)
 
 void Player::eventSetCardAttr(Event_SetCardAttr *event)
 {
-	CardZone *zone = zones.value(event->getZone(), 0);
+	CardZone *zone = getZone(event->getZoneRef());
 	if (!zone)
 		return;
 
@@ -734,7 +733,7 @@ void Player::eventSetCardAttr(Event_SetCardAttr *event)
 
 void Player::eventSetCardCounter(Event_SetCardCounter *event)
 {
-	CardZone *zone = zones.value(event->getZone(), 0);
+	CardZone *zone = getZone(event->getZoneRef());
 	if (!zone)
 		return;
 
@@ -774,7 +773,7 @@ void Player::eventDumpZone(Event_DumpZone *event)
 	Player *zoneOwner = static_cast<TabGame *>(parent())->getPlayers().value(event->getZoneOwnerId(), 0);
 	if (!zoneOwner)
 		return;
-	CardZone *zone = zoneOwner->getZones().value(event->getZone(), 0);
+	CardZone *zone = zoneOwner->getZone(event->getZoneRef());
 	if (!zone)
 		return;
 	emit logDumpZone(this, zone, event->getNumberCards());
@@ -785,7 +784,7 @@ void Player::eventStopDumpZone(Event_StopDumpZone *event)
 	Player *zoneOwner = static_cast<TabGame *>(parent())->getPlayers().value(event->getZoneOwnerId(), 0);
 	if (!zoneOwner)
 		return;
-	CardZone *zone = zoneOwner->getZones().value(event->getZone(), 0);
+	CardZone *zone = zoneOwner->getZone(event->getZoneRef());
 	if (!zone)
 		return;
 	emit logStopDumpZone(this, zone);
@@ -793,11 +792,11 @@ void Player::eventStopDumpZone(Event_StopDumpZone *event)
 
 void Player::eventMoveCard(Event_MoveCard *event)
 {
-	CardZone *startZone = zones.value(event->getStartZone(), 0);
+	CardZone *startZone = getZone(event->getStartZoneRef());
 	Player *targetPlayer = static_cast<TabGame *>(parent())->getPlayers().value(event->getTargetPlayerId());
 	if (!targetPlayer)
 		return;
-	CardZone *targetZone = targetPlayer->getZones().value(event->getTargetZone(), 0);
+	CardZone *targetZone = targetPlayer->getZone(event->getTargetZoneRef());
 	if (!startZone || !targetZone)
 		return;
 	
@@ -817,7 +816,7 @@ void Player::eventMoveCard(Event_MoveCard *event)
 	if (card->getAttachedTo() && (startZone != targetZone)) {
 		CardItem *parentCard = card->getAttachedTo();
 		card->setAttachedTo(0);
-		parentCard->getZone()->reorganizeCards();
+		parentCard->getZone()->scheduleReorganize();
 	}
 
 	card->deleteDragItem();
@@ -844,29 +843,20 @@ void Player::eventMoveCard(Event_MoveCard *event)
 
 	// Look at all arrows from and to the card.
 	// If the card was moved to another zone, delete the arrows, otherwise update them.
-	QMapIterator<int, Player *> playerIterator(static_cast<TabGame *>(parent())->getPlayers());
-	while (playerIterator.hasNext()) {
-		Player *p = playerIterator.next().value();
-
-		QList<ArrowItem *> arrowsToDelete;
-		QMapIterator<int, ArrowItem *> arrowIterator(p->getArrows());
-		while (arrowIterator.hasNext()) {
-			ArrowItem *arrow = arrowIterator.next().value();
-			if ((arrow->getStartItem() == card) || (arrow->getTargetItem() == card)) {
-				if (startZone == targetZone)
-					arrow->updatePath();
-				else
-					arrowsToDelete.append(arrow);
-			}
-		}
-		for (int i = 0; i < arrowsToDelete.size(); ++i)
-			arrowsToDelete[i]->delArrow();
+	// The arrows are copied because delArrow() removes them from the card.
+	QSetIterator<ArrowItem *> arrowIterator(QSet<ArrowItem *>::fromList(card->getArrowsFrom() + card->getArrowsTo()));
+	while (arrowIterator.hasNext()) {
+		ArrowItem *arrow = arrowIterator.next();
+		if (startZone == targetZone)
+			arrow->scheduleUpdatePath();
+		else
+			arrow->delArrow();
 	}
 }
 
 void Player::eventFlipCard(Event_FlipCard *event)
 {
-	CardZone *zone = zones.value(event->getZone(), 0);
+	CardZone *zone = getZone(event->getZoneRef());
 	if (!zone)
 		return;
 	CardItem *card = zone->getCard(event->getCardId(), event->getCardName());
@@ -878,7 +868,7 @@ void Player::eventFlipCard(Event_FlipCard *event)
 
 void Player::eventDestroyCard(Event_DestroyCard *event)
 {
-	CardZone *zone = zones.value(event->getZone(), 0);
+	CardZone *zone = getZone(event->getZoneRef());
 	if (!zone)
 		return;
 	
@@ -901,11 +891,11 @@ void Player::eventAttachCard(Event_AttachCard *event)
 	if (targetPlayerId != -1)
 		targetPlayer = playerList.value(targetPlayerId, 0);
 	if (targetPlayer)
-		targetZone = targetPlayer->getZones().value(event->getTargetZone(), 0);
+		targetZone = targetPlayer->getZone(event->getTargetZoneRef());
 	if (targetZone)
 		targetCard = targetZone->getCard(event->getTargetCardId(), QString());
 	
-	CardZone *startZone = getZones().value(event->getStartZone(), 0);
+	CardZone *startZone = getZone(event->getStartZoneRef());
 	if (!startZone)
 		return;
 	
@@ -917,11 +907,11 @@ void Player::eventAttachCard(Event_AttachCard *event)
 	
 	startCard->setAttachedTo(targetCard);
 	
-	startZone->reorganizeCards();
+	startZone->scheduleReorganize();
 	if ((startZone != targetZone) && targetZone)
-		targetZone->reorganizeCards();
+		targetZone->scheduleReorganize();
 	if (oldParent)
-		oldParent->getZone()->reorganizeCards();
+		oldParent->getZone()->scheduleReorganize();
 	
 	if (targetCard)
 		emit logAttachCard(this, startCard->getName(), targetPlayer, targetCard->getName());
@@ -931,8 +921,8 @@ void Player::eventAttachCard(Event_AttachCard *event)
 
 void Player::eventDrawCards(Event_DrawCards *event)
 {
-	CardZone *deck = zones.value("deck");
-	CardZone *hand = zones.value("hand");
+	CardZone *deck = zones[DeckZoneId];
+	CardZone *hand = zones[HandZoneId];
 	const QList<ServerInfo_Card *> &cardList = event->getCardList();
 	if (!cardList.isEmpty())
 		for (int i = 0; i < cardList.size(); ++i) {
@@ -944,15 +934,15 @@ void Player::eventDrawCards(Event_DrawCards *event)
 		for (int i = 0; i < event->getNumberCards(); ++i)
 			hand->addCard(deck->takeCard(0, -1), false, -1);
 	
-	hand->reorganizeCards();
-	deck->reorganizeCards();
+	hand->scheduleReorganize();
+	deck->scheduleReorganize();
 	
 	emit logDrawCards(this, event->getNumberCards());
 }
 
 void Player::eventRevealCards(Event_RevealCards *event)
 {
-	CardZone *zone = zones.value(event->getZoneName());
+	CardZone *zone = getZone(event->getZoneNameRef());
 	if (!zone)
 		return;
 	Player *otherPlayer = 0;
@@ -1027,14 +1017,14 @@ void Player::processPlayerInfo(ServerInfo_Player *info)
 	clearCounters();
 	clearArrows();
 	
-	QMapIterator<QString, CardZone *> zoneIt(zones);
-	while (zoneIt.hasNext())
-		zoneIt.next().value()->clearContents();
+	for (int i = 0; i < zones.size(); ++i)
+		if (zones[i])
+			zones[i]->clearContents();
 
 	QList<ServerInfo_Zone *> zl = info->getZoneList();
 	for (int i = 0; i < zl.size(); ++i) {
 		ServerInfo_Zone *zoneInfo = zl[i];
-		CardZone *zone = zones.value(zoneInfo->getName(), 0);
+		CardZone *zone = getZone(zoneInfo->getNameRef());
 		if (!zone)
 			continue;
 
@@ -1049,7 +1039,7 @@ void Player::processPlayerInfo(ServerInfo_Player *info)
 				zone->addCard(card, false, cardList[j]->getX(), cardList[j]->getY());
 			}
 		}
-		zone->reorganizeCards();
+		zone->scheduleReorganize();
 	}
 
 	QList<ServerInfo_Counter *> cl = info->getCounterList();
@@ -1067,7 +1057,7 @@ void Player::processCardAttachment(ServerInfo_Player *info)
 	QList<ServerInfo_Zone *> zl = info->getZoneList();
 	for (int i = 0; i < zl.size(); ++i) {
 		ServerInfo_Zone *zoneInfo = zl[i];
-		CardZone *zone = zones.value(zoneInfo->getName(), 0);
+		CardZone *zone = getZone(zoneInfo->getNameRef());
 		if (!zone)
 			continue;
 
@@ -1076,7 +1066,7 @@ void Player::processCardAttachment(ServerInfo_Player *info)
 			ServerInfo_Card *cardInfo = cardList[j];
 			if (cardInfo->getAttachPlayerId() != -1) {
 				CardItem *startCard = zone->getCard(cardInfo->getId(), QString());
-				CardItem *targetCard = static_cast<TabGame *>(parent())->getCard(cardInfo->getAttachPlayerId(), cardInfo->getAttachZone(), cardInfo->getAttachCardId());
+				CardItem *targetCard = static_cast<TabGame *>(parent())->getCard(cardInfo->getAttachPlayerId(), cardInfo->getAttachZoneRef(), cardInfo->getAttachCardId());
 				if (!targetCard)
 					continue;
 				
@@ -1112,7 +1102,18 @@ void Player::deleteCard(CardItem *c)
 
 void Player::addZone(CardZone *z)
 {
-	zones.insert(z->getName(), z);
+	if (zones.size() < StandardZoneCount)
+		zones.resize(StandardZoneCount);
+	ZoneId zoneId = ZoneNames::getZoneId(z->getName());
+	if (zoneId == CustomZoneId) {
+		CardZone *oldZone = customZones.value(z->getName());
+		if (oldZone)
+			zones[zones.indexOf(oldZone)] = z;
+		else
+			zones.append(z);
+		customZones.insert(z->getName(), z);
+	} else
+		zones[zoneId] = z;
 }
 
 AbstractCounter *Player::addCounter(ServerInfo_Counter *counter)
@@ -1169,8 +1170,8 @@ ArrowItem *Player::addArrow(ServerInfo_Arrow *arrow)
 	if (!startPlayer || !targetPlayer)
 		return 0;
 	
-	CardZone *startZone = startPlayer->getZones().value(arrow->getStartZone(), 0);
-	CardZone *targetZone = targetPlayer->getZones().value(arrow->getTargetZone(), 0);
+	CardZone *startZone = startPlayer->getZone(arrow->getStartZoneRef());
+	CardZone *targetZone = targetPlayer->getZone(arrow->getTargetZoneRef());
 	if (!startZone || (!targetZone && !arrow->getTargetZone().isEmpty()))
 		return 0;
 	
@@ -4,7 +4,10 @@
 #include <QInputDialog>
 #include <QPoint>
 #include <QMap>
+#include <QHash>
+#include <QVector>
 #include "carditem.h"
+#include "protocol_datastructures.h"
 
 class CardDatabase;
 class QMenu;
@@ -137,7 +140,8 @@ private:
 	bool clearCardsToDelete();
 	QList<CardItem *> cardsToDelete;
 	
-	QMap<QString, CardZone *> zones;
+	QVector<CardZone *> zones;
+	QHash<QString, CardZone *> customZones;
 	StackZone *stack;
 	TableZone *table;
 	HandZone *hand;
@@ -207,7 +211,12 @@ public:
 	ServerInfo_User *getUserInfo() const { return userInfo; }
 	bool getLocal() const { return local; }
 	bool getMirrored() const { return mirrored; }
-	const QMap<QString, CardZone *> &getZones() const { return zones; }
+	// The standard zones are indexed by ZoneId, custom zones follow them.
+	// Zone views are not registered here.
+	const QVector<CardZone *> &getZones() const { return zones; }
+	CardZone *getZone(ZoneId zoneId) const { return ((zoneId >= 0) && (zoneId < StandardZoneCount) && (zoneId < zones.size())) ? zones[zoneId] : 0; }
+	CardZone *getZone(const ZoneRef &zone) const { return (zone.getId() == CustomZoneId) ? customZones.value(zone.getName()) : getZone(zone.getId()); }
+	CardZone *getZone(const QString &zoneName) const { return getZone(ZoneRef(zoneName)); }
 	const QMap<int, ArrowItem *> &getArrows() const { return arrows; }
 	TableZone *getTable() const { return table; }
 	void setCardMenu(QMenu *menu);
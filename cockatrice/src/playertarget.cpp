@@ -2,6 +2,9 @@
 #include "player.h"
 #include "protocol_datastructures.h"
 #include "pixmapgenerator.h"
+#include "tab_game.h"
+#include "abstractclient.h"
+#include "avatarcache.h"
 #include <QPainter>
 #include <QPixmapCache>
 #include <QDebug>
@@ -51,10 +54,26 @@ PlayerTarget::PlayerTarget(Player *_owner)
 {
 	setCacheMode(DeviceCoordinateCache);
 
-	if (!fullPixmap.loadFromData(_owner->getUserInfo()->getAvatarBmp()))
+	avatarCache = static_cast<TabGame *>(_owner->parent())->getClientForPlayer(_owner->getId())->getAvatarCache();
+	connect(avatarCache, SIGNAL(avatarLoaded(const QString &)), this, SLOT(avatarLoaded(const QString &)));
+	loadAvatar();
+}
+
+void PlayerTarget::loadAvatar()
+{
+	if (!fullPixmap.loadFromData(avatarCache->getAvatar(owner->getUserInfo()->getAvatarHash())))
 		fullPixmap = QPixmap();
 }
 
+void PlayerTarget::avatarLoaded(const QString &avatarHash)
+{
+	if (avatarHash != owner->getUserInfo()->getAvatarHash())
+		return;
+	
+	loadAvatar();
+	update();
+}
+
 QRectF PlayerTarget::boundingRect() const
 {
 	return QRectF(0, 0, 160, 64);
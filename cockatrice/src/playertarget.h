@@ -7,6 +7,7 @@
 #include <QPixmap>
 
 class Player;
+class AvatarCache;
 
 class PlayerCounter : public AbstractCounter {
 	Q_OBJECT
@@ -21,6 +22,10 @@ class PlayerTarget : public ArrowTarget {
 private:
 	QPixmap fullPixmap;
 	PlayerCounter *playerCounter;
+	AvatarCache *avatarCache;
+	void loadAvatar();
+private slots:
+	void avatarLoaded(const QString &avatarHash);
 public slots:
 	void delCounter();
 public:
@@ -1,46 +1,111 @@
 #include <QTimer>
-#include <QXmlStreamReader>
+#include <QThread>
 #include <QXmlStreamWriter>
+#include <QBuffer>
 #include "remoteclient.h"
+#include "remoteclientconnection.h"
 #include "protocol.h"
 #include "protocol_items.h"
 
 RemoteClient::RemoteClient(QObject *parent)
-	: AbstractClient(parent), topLevelItem(0)
+	: AbstractClient(parent), connectionId(0)
 {
 	ProtocolItem::initializeHash();
-	
+	qRegisterMetaType<ProtocolItem *>("ProtocolItem *");
+
 	timer = new QTimer(this);
 	timer->setInterval(1000);
 	connect(timer, SIGNAL(timeout()), this, SLOT(ping()));
 
-	socket = new QTcpSocket(this);
-	connect(socket, SIGNAL(connected()), this, SLOT(slotConnected()));
-	connect(socket, SIGNAL(readyRead()), this, SLOT(readData()));
-	connect(socket, SIGNAL(error(QAbstractSocket::SocketError)), this, SLOT(slotSocketError(QAbstractSocket::SocketError)));
-	
-	xmlReader = new QXmlStreamReader;
+	// The socket and the decoding of incoming data live in their own thread.
+	networkThread = new QThread(this);
+	connection = new RemoteClientConnection(thread());
+	connection->moveToThread(networkThread);
+	connect(networkThread, SIGNAL(finished()), connection, SLOT(deleteLater()));
+
+	connect(this, SIGNAL(connectToHostRequested(const QString &, unsigned int, int)), connection, SLOT(connectToHost(const QString &, unsigned int, int)));
+	connect(this, SIGNAL(disconnectFromHostRequested()), connection, SLOT(disconnectFromHost()));
+	connect(this, SIGNAL(dataToServer(const QByteArray &)), connection, SLOT(sendData(const QByteArray &)));
+	connect(connection, SIGNAL(connected(int)), this, SLOT(slotConnected(int)));
+	connect(connection, SIGNAL(handshakeFinished(int)), this, SLOT(slotHandshakeFinished(int)));
+	connect(connection, SIGNAL(protocolItemReceived(int, ProtocolItem *)), this, SLOT(slotProtocolItemReceived(int, ProtocolItem *)));
+	connect(connection, SIGNAL(socketError(int, const QString &)), this, SLOT(slotSocketError(int, const QString &)));
+	connect(connection, SIGNAL(protocolVersionMismatch(int, int, int)), this, SLOT(slotProtocolVersionMismatch(int, int, int)));
+	connect(connection, SIGNAL(protocolError(int)), this, SLOT(slotProtocolError(int)));
+	networkThread->start();
+
+	outputBuffer = new QBuffer(this);
+	outputBuffer->open(QIODevice::WriteOnly);
+
 	xmlWriter = new QXmlStreamWriter;
-	xmlWriter->setDevice(socket);
+	xmlWriter->setDevice(outputBuffer);
 }
 
 RemoteClient::~RemoteClient()
 {
 	disconnectFromServer();
+
+	networkThread->quit();
+	networkThread->wait();
+	delete xmlWriter;
 }
 
-void RemoteClient::slotSocketError(QAbstractSocket::SocketError /*error*/)
+void RemoteClient::slotSocketError(int _connectionId, const QString &errorString)
 {
-	emit socketError(socket->errorString());
+	if (_connectionId != connectionId)
+		return;
+	emit socketError(errorString);
 	disconnectFromServer();
 }
 
-void RemoteClient::slotConnected()
+void RemoteClient::slotConnected(int _connectionId)
 {
+	if (_connectionId != connectionId)
+		return;
 	timer->start();
 	setStatus(StatusAwaitingWelcome);
 }
 
+void RemoteClient::slotHandshakeFinished(int _connectionId)
+{
+	if (_connectionId != connectionId)
+		return;
+	setStatus(StatusLoggingIn);
+	Command_Login *cmdLogin = new Command_Login(userName, password);
+	connect(cmdLogin, SIGNAL(finished(ProtocolResponse *)), this, SLOT(loginResponse(ProtocolResponse *)));
+	sendCommand(cmdLogin);
+}
+
+void RemoteClient::slotProtocolVersionMismatch(int _connectionId, int clientVersion, int serverVersion)
+{
+	if (_connectionId != connectionId)
+		return;
+	emit protocolVersionMismatch(clientVersion, serverVersion);
+	disconnectFromServer();
+}
+
+void RemoteClient::slotProtocolError(int _connectionId)
+{
+	if (_connectionId != connectionId)
+		return;
+	emit protocolError();
+	disconnectFromServer();
+}
+
+void RemoteClient::slotProtocolItemReceived(int _connectionId, ProtocolItem *item)
+{
+	// Items that were still queued when the connection was closed are dropped.
+	if (_connectionId != connectionId) {
+		delete item;
+		return;
+	}
+
+	processProtocolItem(item);
+
+	if (status == StatusDisconnecting)
+		disconnectFromServer();
+}
+
 void RemoteClient::loginResponse(ProtocolResponse *response)
 {
 	if (response->getResponseCode() == RespOk) {
@@ -57,63 +122,36 @@ void RemoteClient::loginResponse(ProtocolResponse *response)
 	}
 }
 
-void RemoteClient::readData()
-{
-	QByteArray data = socket->readAll();
-	qDebug() << data;
-	xmlReader->addData(data);
-
-	while (!xmlReader->atEnd()) {
-		xmlReader->readNext();
-		if (topLevelItem)
-			topLevelItem->readElement(xmlReader);
-		else if (xmlReader->isStartElement() && (xmlReader->name().toString() == "cockatrice_server_stream")) {
-			int serverVersion = xmlReader->attributes().value("version").toString().toInt();
-			if (serverVersion != ProtocolItem::protocolVersion) {
-				emit protocolVersionMismatch(ProtocolItem::protocolVersion, serverVersion);
-				disconnectFromServer();
-				return;
-			}
-			xmlWriter->writeStartDocument();
-			xmlWriter->writeStartElement("cockatrice_client_stream");
-			xmlWriter->writeAttribute("version", QString::number(ProtocolItem::protocolVersion));
-			
-			topLevelItem = new TopLevelProtocolItem;
-			connect(topLevelItem, SIGNAL(protocolItemReceived(ProtocolItem *)), this, SLOT(processProtocolItem(ProtocolItem *)));
-			
-			setStatus(StatusLoggingIn);
-			Command_Login *cmdLogin = new Command_Login(userName, password);
-			connect(cmdLogin, SIGNAL(finished(ProtocolResponse *)), this, SLOT(loginResponse(ProtocolResponse *)));
-			sendCommand(cmdLogin);
-		}
-	}
-	if (status == StatusDisconnecting)
-		disconnectFromServer();
-}
-
 void RemoteClient::sendCommandContainer(CommandContainer *cont)
 {
 	cont->write(xmlWriter);
+	QByteArray &data = outputBuffer->buffer();
+	emit dataToServer(data);
+	data.clear();
+	outputBuffer->seek(0);
 	pendingCommands.insert(cont->getCmdId(), cont);
 }
 
-void RemoteClient::connectToServer(const QString &hostname, unsigned int port, const QString &_userName, const QString &_password)
+void RemoteClient::connectToServer(const QString &_hostname, unsigned int port, const QString &_userName, const QString &_password)
 {
 	disconnectFromServer();
-	
+
+	hostname = _hostname;
 	userName = _userName;
 	password = _password;
-	socket->connectToHost(hostname, port);
+	emit connectToHostRequested(hostname, port, connectionId);
 	setStatus(StatusConnecting);
 }
 
 void RemoteClient::disconnectFromServer()
 {
-	delete topLevelItem;
-	topLevelItem = 0;
-	
-	xmlReader->clear();
-	
+	// Anything the network thread reports for the old connection is ignored.
+	++connectionId;
+	emit disconnectFromHostRequested();
+
+	outputBuffer->buffer().clear();
+	outputBuffer->seek(0);
+
 	timer->stop();
 
 	QList<CommandContainer *> pc = pendingCommands.values();
@@ -122,7 +160,6 @@ void RemoteClient::disconnectFromServer()
 	pendingCommands.clear();
 
 	setStatus(StatusDisconnected);
-	socket->close();
 }
 
 void RemoteClient::ping()
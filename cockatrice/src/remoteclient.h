@@ -1,12 +1,13 @@
 #ifndef REMOTECLIENT_H
 #define REMOTECLIENT_H
 
-#include <QTcpSocket>
 #include "abstractclient.h"
 
 class QTimer;
-class QXmlStreamReader;
+class QThread;
 class QXmlStreamWriter;
+class QBuffer;
+class RemoteClientConnection;
 
 class RemoteClient : public AbstractClient {
 	Q_OBJECT
@@ -16,28 +17,37 @@ signals:
 	void socketError(const QString &errorString);
 	void protocolVersionMismatch(int clientVersion, int serverVersion);
 	void protocolError();
+
+	void connectToHostRequested(const QString &hostname, unsigned int port, int connectionId);
+	void disconnectFromHostRequested();
+	void dataToServer(const QByteArray &data);
 private slots:
-	void slotConnected();
-	void readData();
-	void slotSocketError(QAbstractSocket::SocketError error);
+	void slotConnected(int _connectionId);
+	void slotHandshakeFinished(int _connectionId);
+	void slotProtocolItemReceived(int _connectionId, ProtocolItem *item);
+	void slotSocketError(int _connectionId, const QString &errorString);
+	void slotProtocolVersionMismatch(int _connectionId, int clientVersion, int serverVersion);
+	void slotProtocolError(int _connectionId);
 	void ping();
 	void loginResponse(ProtocolResponse *response);
 private:
 	static const int maxTimeout = 10;
-	
+
 	QTimer *timer;
-	QTcpSocket *socket;
-	QXmlStreamReader *xmlReader;
+	QThread *networkThread;
+	RemoteClientConnection *connection;
+	int connectionId;
+	QString hostname;
+	QBuffer *outputBuffer;
 	QXmlStreamWriter *xmlWriter;
-	TopLevelProtocolItem *topLevelItem;
 public:
 	RemoteClient(QObject *parent = 0);
 	~RemoteClient();
-	QString peerName() const { return socket->peerName(); }
+	QString peerName() const { return hostname; }
 
-	void connectToServer(const QString &hostname, unsigned int port, const QString &_userName, const QString &_password);
+	void connectToServer(const QString &_hostname, unsigned int port, const QString &_userName, const QString &_password);
 	void disconnectFromServer();
-	
+
 	void sendCommandContainer(CommandContainer *cont);
 };
 
@@ -0,0 +1,174 @@
+#include <QXmlStreamReader>
+#include "remoteclientconnection.h"
+#include "protocol.h"
+#include "stream_compression.h"
+
+RemoteClientConnection::RemoteClientConnection(QThread *_clientThread)
+	: QObject(), clientThread(_clientThread), connectionId(-1), topLevelItem(0), deflater(0), inflater(0), awaitingCompression(false)
+{
+	socket = new QTcpSocket(this);
+	connect(socket, SIGNAL(connected()), this, SLOT(slotConnected()));
+	connect(socket, SIGNAL(readyRead()), this, SLOT(readData()));
+	connect(socket, SIGNAL(error(QAbstractSocket::SocketError)), this, SLOT(slotSocketError(QAbstractSocket::SocketError)));
+
+	xmlReader = new QXmlStreamReader;
+}
+
+RemoteClientConnection::~RemoteClientConnection()
+{
+	disconnectFromHost();
+	delete xmlReader;
+}
+
+void RemoteClientConnection::connectToHost(const QString &hostname, unsigned int port, int _connectionId)
+{
+	disconnectFromHost();
+
+	connectionId = _connectionId;
+	socket->connectToHost(hostname, port);
+}
+
+void RemoteClientConnection::disconnectFromHost()
+{
+	delete topLevelItem;
+	topLevelItem = 0;
+
+	xmlReader->clear();
+
+	delete deflater;
+	deflater = 0;
+	delete inflater;
+	inflater = 0;
+	awaitingCompression = false;
+	inputBuffer.clear();
+	pendingOutput.clear();
+	cardNames.clear();
+
+	socket->close();
+}
+
+void RemoteClientConnection::slotConnected()
+{
+	emit connected(connectionId);
+}
+
+void RemoteClientConnection::slotSocketError(QAbstractSocket::SocketError /*error*/)
+{
+	emit socketError(connectionId, socket->errorString());
+	disconnectFromHost();
+}
+
+bool RemoteClientConnection::decodeInput(QByteArray &data)
+{
+	if (inflater) {
+		QByteArray plainData;
+		if (!inflater->inflate(data, plainData))
+			return false;
+		data = plainData;
+	} else if (awaitingCompression) {
+		// The server switches to compressed data right after the start
+		// marker. A marker split across two reads has to be recognized too,
+		// so the tail of the data is held back until more arrives.
+		const QByteArray marker(StreamCompression::startMarker);
+		inputBuffer.append(data);
+		int markerPos = inputBuffer.indexOf(marker);
+		if (markerPos == -1) {
+			int keep = qMin(inputBuffer.size(), marker.size() - 1);
+			data = inputBuffer.left(inputBuffer.size() - keep);
+			inputBuffer = inputBuffer.right(keep);
+		} else {
+			data = inputBuffer.left(markerPos);
+			QByteArray compressedData = inputBuffer.mid(markerPos + marker.size());
+			inputBuffer.clear();
+			awaitingCompression = false;
+
+			inflater = new StreamInflater;
+			QByteArray plainData;
+			if (!inflater->inflate(compressedData, plainData))
+				return false;
+			data.append(plainData);
+		}
+	}
+	return true;
+}
+
+void RemoteClientConnection::processHeader()
+{
+	int serverVersion = xmlReader->attributes().value("version").toString().toInt();
+	if (serverVersion != ProtocolItem::protocolVersion) {
+		emit protocolVersionMismatch(connectionId, ProtocolItem::protocolVersion, serverVersion);
+		disconnectFromHost();
+		return;
+	}
+	// Commands are serialized by a separate writer in the GUI thread, so the
+	// stream header is written out here as a complete start tag. All of its
+	// values are plain numbers and names that need no escaping.
+	bool compression = xmlReader->attributes().value("compression").toString() == StreamCompression::methodName;
+	QByteArray header("<?xml version=\"1.0\" encoding=\"UTF-8\"?><cockatrice_client_stream version=\"");
+	header.append(QByteArray::number(ProtocolItem::protocolVersion));
+	header.append('"');
+	if (compression)
+		header.append(" compression=\"").append(StreamCompression::methodName).append('"');
+	header.append('>');
+	socket->write(header);
+	if (compression) {
+		deflater = new StreamDeflater;
+		awaitingCompression = true;
+	}
+
+	topLevelItem = new TopLevelProtocolItem;
+	connect(topLevelItem, SIGNAL(protocolItemReceived(ProtocolItem *)), this, SLOT(itemReceived(ProtocolItem *)));
+
+	if (!pendingOutput.isEmpty()) {
+		writeData(pendingOutput);
+		pendingOutput.clear();
+	}
+	emit handshakeFinished(connectionId);
+}
+
+void RemoteClientConnection::readData()
+{
+	QByteArray data = socket->readAll();
+	if (!decodeInput(data)) {
+		emit protocolError(connectionId);
+		disconnectFromHost();
+		return;
+	}
+	xmlReader->addData(data);
+
+	SerializableItem_CardName::setReadDictionary(&cardNames);
+	while (!xmlReader->atEnd()) {
+		xmlReader->readNext();
+		if (topLevelItem)
+			topLevelItem->readElement(xmlReader);
+		else if (xmlReader->isStartElement() && (xmlReader->name().toString() == "cockatrice_server_stream")) {
+			processHeader();
+			if (!topLevelItem)
+				break;
+		}
+	}
+	SerializableItem_CardName::setReadDictionary(0);
+}
+
+void RemoteClientConnection::itemReceived(ProtocolItem *item)
+{
+	item->moveItemToThread(clientThread);
+	emit protocolItemReceived(connectionId, item);
+}
+
+void RemoteClientConnection::writeData(const QByteArray &data)
+{
+	if (deflater)
+		socket->write(deflater->deflate(data));
+	else
+		socket->write(data);
+}
+
+void RemoteClientConnection::sendData(const QByteArray &data)
+{
+	// Nothing may be sent before the stream header.
+	if (!topLevelItem)
+		pendingOutput.append(data);
+	else
+		writeData(data);
+}
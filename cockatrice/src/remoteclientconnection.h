@@ -0,0 +1,57 @@
+#ifndef REMOTECLIENTCONNECTION_H
+#define REMOTECLIENTCONNECTION_H
+
+#include <QTcpSocket>
+#include "serializable_item.h"
+
+class QXmlStreamReader;
+class ProtocolItem;
+class TopLevelProtocolItem;
+class StreamDeflater;
+class StreamInflater;
+
+// Socket, decompression and XML decoding of a RemoteClient. It lives in the
+// client's network thread, so that decoding big items does not stall the
+// GUI. Received items are moved to the GUI thread before they are handed out.
+// Every signal carries the id of the connection it belongs to, so that the
+// client can discard signals that are still queued from an old connection.
+class RemoteClientConnection : public QObject {
+	Q_OBJECT
+signals:
+	void connected(int connectionId);
+	void handshakeFinished(int connectionId);
+	void protocolItemReceived(int connectionId, ProtocolItem *item);
+	void socketError(int connectionId, const QString &errorString);
+	void protocolVersionMismatch(int connectionId, int clientVersion, int serverVersion);
+	void protocolError(int connectionId);
+public slots:
+	void connectToHost(const QString &hostname, unsigned int port, int _connectionId);
+	void disconnectFromHost();
+	void sendData(const QByteArray &data);
+private slots:
+	void slotConnected();
+	void slotSocketError(QAbstractSocket::SocketError error);
+	void readData();
+	void itemReceived(ProtocolItem *item);
+private:
+	QThread *clientThread;
+	int connectionId;
+	QTcpSocket *socket;
+	QXmlStreamReader *xmlReader;
+	TopLevelProtocolItem *topLevelItem;
+	StreamDeflater *deflater;
+	StreamInflater *inflater;
+	bool awaitingCompression;
+	QByteArray inputBuffer;
+	QByteArray pendingOutput;
+	CardNameDictionary cardNames;
+
+	bool decodeInput(QByteArray &data);
+	void processHeader();
+	void writeData(const QByteArray &data);
+public:
+	RemoteClientConnection(QThread *_clientThread);
+	~RemoteClientConnection();
+};
+
+#endif
@@ -26,6 +26,7 @@ SettingsCache::SettingsCache()
 	economicalGrid = settings->value("table/economic", false).toBool();
 	invertVerticalCoordinate = settings->value("table/invert_vertical", false).toBool();
 	tapAnimation = settings->value("cards/tapanimation", true).toBool();
+	messageLogSize = settings->value("interface/messagelogsize", 2000).toInt();
 	
 	zoneViewSortByName = settings->value("zoneview/sortbyname", true).toBool();
 	zoneViewSortByType = settings->value("zoneview/sortbytype", true).toBool();
@@ -163,3 +164,10 @@ void SettingsCache::setZoneViewSortByType(int _zoneViewSortByType)
 	zoneViewSortByType = _zoneViewSortByType;
 	settings->setValue("zoneview/sortbytype", zoneViewSortByType);
 }
+
+void SettingsCache::setMessageLogSize(int _messageLogSize)
+{
+	messageLogSize = _messageLogSize;
+	settings->setValue("interface/messagelogsize", messageLogSize);
+	emit messageLogSizeChanged();
+}
@@ -20,6 +20,7 @@ signals:
 	void horizontalHandChanged();
 	void economicalGridChanged();
 	void invertVerticalCoordinateChanged();
+	void messageLogSizeChanged();
 private:
 	QSettings *settings;
 	
@@ -34,6 +35,7 @@ private:
 	bool invertVerticalCoordinate;
 	bool tapAnimation;
 	bool zoneViewSortByName, zoneViewSortByType;
+	int messageLogSize;
         int cardInfoFontSize;
         bool cardInfoStripped;
 public:
@@ -56,6 +58,7 @@ public:
 	bool getTapAnimation() const { return tapAnimation; }
 	bool getZoneViewSortByName() const { return zoneViewSortByName; }
 	bool getZoneViewSortByType() const { return zoneViewSortByType; }
+	int getMessageLogSize() const { return messageLogSize; }
         int getCardInfoFontSize() const { return cardInfoFontSize; }
         bool getCardInfoStripped() const { return cardInfoStripped; }
 public slots:
@@ -77,6 +80,7 @@ public slots:
 	void setTapAnimation(int _tapAnimation);
 	void setZoneViewSortByName(int _zoneViewSortByName);
 	void setZoneViewSortByType(int _zoneViewSortByType);
+	void setMessageLogSize(int _messageLogSize);
         void setCardInfoFontSize(int _cardInfoFontSize);
         void setCardInfoStripped(int _cardInfoStripped);
 
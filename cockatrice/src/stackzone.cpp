@@ -94,7 +94,7 @@ void StackZone::reorganizeCards()
 		}
 		QSetIterator<ArrowItem *> arrowIterator(QSet<ArrowItem *>::fromList(arrowsToUpdate));
 		while (arrowIterator.hasNext())
-			arrowIterator.next()->updatePath();
+			arrowIterator.next()->scheduleUpdatePath();
 	}
 	update();
 }
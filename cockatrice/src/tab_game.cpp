@@ -6,6 +6,7 @@
 #include <QFileDialog>
 #include <QApplication>
 #include <QDesktopWidget>
+#include <QTimer>
 #include "tab_game.h"
 #include "cardinfowidget.h"
 #include "playerlistwidget.h"
@@ -160,9 +161,11 @@ void DeckViewContainer::setDeck(DeckList *deck)
 }
 
 TabGame::TabGame(QList<AbstractClient *> &_clients, int _gameId, const QString &_gameDescription, int _localPlayerId, bool _spectator, bool _spectatorsCanTalk, bool _spectatorsSeeEverything, bool _resuming)
-	: Tab(), clients(_clients), gameId(_gameId), gameDescription(_gameDescription), localPlayerId(_localPlayerId), spectator(_spectator), spectatorsCanTalk(_spectatorsCanTalk), spectatorsSeeEverything(_spectatorsSeeEverything), started(false), resuming(_resuming), currentPhase(-1), infoPopup(0)
+	: Tab(), clients(_clients), gameId(_gameId), gameDescription(_gameDescription), localPlayerId(_localPlayerId), spectator(_spectator), spectatorsCanTalk(_spectatorsCanTalk), spectatorsSeeEverything(_spectatorsSeeEverything), started(false), resuming(_resuming), currentPhase(-1), secondsElapsed(0), infoPopup(0)
 {
 	scene = new GameScene(this);
+	// The scene is laid out when the tab is first shown.
+	scene->setSuspended(true);
 	gameView = new GameView(scene);
 	gameView->hide();
 	
@@ -171,8 +174,13 @@ TabGame::TabGame(QList<AbstractClient *> &_clients, int _gameId, const QString &
 	playerListWidget->setFocusPolicy(Qt::NoFocus);
 	timeElapsedLabel = new QLabel;
 	timeElapsedLabel->setAlignment(Qt::AlignCenter);
+	gameTimer = new QTimer(this);
+	gameTimer->setInterval(1000);
+	connect(gameTimer, SIGNAL(timeout()), this, SLOT(incrementGameTime()));
 	messageLog = new MessageLogWidget;
 	connect(messageLog, SIGNAL(cardNameHovered(QString)), cardInfo, SLOT(setCard(QString)));
+	// The game may start while the card database is still being loaded.
+	connect(db, SIGNAL(cardsLoaded(const QList<CardInfo *> &)), this, SLOT(cardsLoaded(const QList<CardInfo *> &)));
 	connect(messageLog, SIGNAL(showCardInfoPopup(QPoint, QString)), this, SLOT(showCardInfoPopup(QPoint, QString)));
 	connect(messageLog, SIGNAL(deleteCardInfoPopup()), this, SLOT(deleteCardInfoPopup()));
 	sayLabel = new QLabel;
@@ -249,6 +257,20 @@ TabGame::~TabGame()
 	emit gameClosing(this);
 }
 
+void TabGame::showEvent(QShowEvent *event)
+{
+	scene->setSuspended(false);
+	Tab::showEvent(event);
+}
+
+void TabGame::hideEvent(QHideEvent *event)
+{
+	// Games in background tabs keep their state current, but are only
+	// laid out again once they are visible.
+	scene->setSuspended(true);
+	Tab::hideEvent(event);
+}
+
 void TabGame::retranslateUi()
 {
 	tabMenu->setTitle(tr("&Game"));
@@ -404,6 +426,14 @@ void TabGame::processGameEventContainer(GameEventContainer *cont, AbstractClient
 	}
 }
 
+AbstractClient *TabGame::getClientForPlayer(int playerId) const
+{
+	if (clients.size() > 1)
+		return clients.at(playerId);
+	else
+		return clients.first();
+}
+
 void TabGame::sendGameCommand(GameCommand *command, int playerId)
 {
 	command->setGameId(gameId);
@@ -594,6 +624,7 @@ void TabGame::eventLeave(Event_Leave *event, GameEventContext * /*context*/)
 void TabGame::eventGameClosed(Event_GameClosed * /*event*/, GameEventContext * /*context*/)
 {
 	started = false;
+	gameTimer->stop();
 	messageLog->logGameClosed();
 	emit userEvent();
 }
@@ -655,7 +686,16 @@ void TabGame::eventPing(Event_Ping *event, GameEventContext * /*context*/)
 	for (int i = 0; i < pingList.size(); ++i)
 		playerListWidget->updatePing(pingList[i]->getPlayerId(), pingList[i]->getPingTime());
 	
-	int seconds = event->getSecondsElapsed();
+	// The server only sends pings when a latency changes noticeably, so the
+	// clock runs locally in between and is corrected with every ping.
+	secondsElapsed = event->getSecondsElapsed();
+	gameTimer->start();
+	incrementGameTime();
+}
+
+void TabGame::incrementGameTime()
+{
+	int seconds = secondsElapsed++;
 	int minutes = seconds / 60;
 	seconds -= minutes * 60;
 	int hours = minutes / 60;
@@ -663,6 +703,16 @@ void TabGame::eventPing(Event_Ping *event, GameEventContext * /*context*/)
 	timeElapsedLabel->setText(QString::number(hours).rightJustified(2, '0') + ":" + QString::number(minutes).rightJustified(2, '0') + ":" + QString::number(seconds).rightJustified(2, '0'));
 }
 
+void TabGame::cardsLoaded(const QList<CardInfo *> &cards)
+{
+	CardInfo *shownCard = cardInfo->getCard();
+	if (shownCard && cards.contains(shownCard))
+		cardInfo->setCard(shownCard);
+	
+	// Card frames and P/T depend on the card data.
+	scene->update();
+}
+
 void TabGame::newCardAdded(AbstractCardItem *card)
 {
 	connect(card, SIGNAL(hovered(AbstractCardItem *)), cardInfo, SLOT(setCard(AbstractCardItem *)));
@@ -670,13 +720,13 @@ void TabGame::newCardAdded(AbstractCardItem *card)
 	connect(card, SIGNAL(deleteCardInfoPopup()), this, SLOT(deleteCardInfoPopup()));
 }
 
-CardItem *TabGame::getCard(int playerId, const QString &zoneName, int cardId) const
+CardItem *TabGame::getCard(int playerId, const ZoneRef &zoneRef, int cardId) const
 {
 	Player *player = players.value(playerId, 0);
 	if (!player)
 		return 0;
 	
-	CardZone *zone = player->getZones().value(zoneName, 0);
+	CardZone *zone = player->getZone(zoneRef);
 	if (!zone)
 		return 0;
 	
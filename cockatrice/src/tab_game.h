@@ -6,6 +6,7 @@
 #include "tab.h"
 
 class AbstractClient;
+class QTimer;
 class CardDatabase;
 class GameView;
 class DeckView;
@@ -25,6 +26,7 @@ class GameEventContainer;
 class GameEventContext;
 class GameCommand;
 class CommandContainer;
+class ZoneRef;
 class Event_GameStateChanged;
 class Event_PlayerPropertiesChanged;
 class Event_Join;
@@ -39,6 +41,7 @@ class Player;
 class CardZone;
 class AbstractCardItem;
 class CardItem;
+class CardInfo;
 class TabGame;
 class DeckList;
 class QVBoxLayout;
@@ -95,6 +98,8 @@ private:
 	bool resuming;
 	int currentPhase;
 	int activePlayer;
+	int secondsElapsed;
+	QTimer *gameTimer;
 
 	CardInfoWidget *infoPopup;
 	CardInfoWidget *cardInfo;
@@ -138,8 +143,10 @@ signals:
 	void playerRemoved(Player *player);
 private slots:
 	void newCardAdded(AbstractCardItem *card);
+	void cardsLoaded(const QList<CardInfo *> &cards);
 	void showCardInfoPopup(const QPoint &pos, const QString &cardName);
 	void deleteCardInfoPopup();
+	void incrementGameTime();
 	
 	void actConcede();
 	void actLeaveGame();
@@ -147,18 +154,22 @@ private slots:
 	void actSay();
 	void actNextPhase();
 	void actNextTurn();
+protected:
+	void showEvent(QShowEvent *event);
+	void hideEvent(QHideEvent *event);
 public:
 	TabGame(QList<AbstractClient *> &_clients, int _gameId, const QString &_gameDescription, int _localPlayerId, bool _spectator, bool _spectatorsCanTalk, bool _spectatorsSeeEverything, bool _resuming);
 	~TabGame();
 	void retranslateUi();
 	const QMap<int, Player *> &getPlayers() const { return players; }
-	CardItem *getCard(int playerId, const QString &zoneName, int cardId) const;
+	CardItem *getCard(int playerId, const ZoneRef &zone, int cardId) const;
 	int getGameId() const { return gameId; }
 	QString getTabText() const { return tr("Game %1: %2").arg(gameId).arg(gameDescription); }
 	bool getSpectator() const { return spectator; }
 	bool getSpectatorsCanTalk() const { return spectatorsCanTalk; }
 	bool getSpectatorsSeeEverything() const { return spectatorsSeeEverything; }
 	Player *getActiveLocalPlayer() const;
+	AbstractClient *getClientForPlayer(int playerId) const;
 
 	void processGameEventContainer(GameEventContainer *cont, AbstractClient *client);
 public slots:
@@ -17,8 +17,9 @@
 #include "abstractclient.h"
 #include "protocol_items.h"
 #include "gamesmodel.h"
+#include "settingscache.h"
 
-#include <QTextTable>
+#include <QTextDocument>
 
 GameSelector::GameSelector(AbstractClient *_client, int _roomId, QWidget *parent)
 	: QGroupBox(parent), client(_client), roomId(_roomId)
@@ -90,16 +91,16 @@ void GameSelector::actJoin()
 	QModelIndex ind = gameListView->currentIndex();
 	if (!ind.isValid())
 		return;
-	ServerInfo_Game *game = gameListModel->getGame(ind.data(Qt::UserRole).toInt());
+	GamesModel::GameEntry game = gameListModel->getGame(ind.data(Qt::UserRole).toInt());
 	QString password;
-	if (game->getHasPassword() && !(spectator && !game->getSpectatorsNeedPassword())) {
+	if (game.hasPassword && !(spectator && !game.spectatorsNeedPassword)) {
 		bool ok;
 		password = QInputDialog::getText(this, tr("Join game"), tr("Password:"), QLineEdit::Password, QString(), &ok);
 		if (!ok)
 			return;
 	}
 
-	Command_JoinGame *commandJoinGame = new Command_JoinGame(roomId, game->getGameId(), password, spectator);
+	Command_JoinGame *commandJoinGame = new Command_JoinGame(roomId, game.gameId, password, spectator);
 	connect(commandJoinGame, SIGNAL(finished(ResponseCode)), this, SLOT(checkResponse(ResponseCode)));
 	client->sendCommand(commandJoinGame);
 
@@ -123,38 +124,29 @@ void GameSelector::processGameInfo(ServerInfo_Game *info)
 }
 
 ChatView::ChatView(const QString &_ownName, QWidget *parent)
-	: QTextEdit(parent), ownName(_ownName)
+	: QPlainTextEdit(parent), ownName(_ownName)
 {
 	setTextInteractionFlags(Qt::TextSelectableByMouse);
-	
-	QTextTableFormat format;
-	format.setBorderStyle(QTextFrameFormat::BorderStyle_None);
-	table = textCursor().insertTable(1, 3, format);
+	setMaximumBlockCount(settingsCache->getMessageLogSize());
+	connect(settingsCache, SIGNAL(messageLogSizeChanged()), this, SLOT(updateMaximumBlockCount()));
+}
+
+void ChatView::updateMaximumBlockCount()
+{
+	setMaximumBlockCount(settingsCache->getMessageLogSize());
 }
 
 void ChatView::appendMessage(const QString &sender, const QString &message)
 {
-	QTextCursor cellCursor = table->cellAt(table->rows() - 1, 0).lastCursorPosition();
-	cellCursor.insertText(QDateTime::currentDateTime().toString("[hh:mm]"));
-	QTextTableCell senderCell = table->cellAt(table->rows() - 1, 1);
-	QTextCharFormat senderFormat;
-	if (sender == ownName) {
-		senderFormat.setFontWeight(QFont::Bold);
-		senderFormat.setForeground(Qt::red);
-	} else
-		senderFormat.setForeground(Qt::blue);
-	senderCell.setFormat(senderFormat);
-	cellCursor = senderCell.lastCursorPosition();
-	cellCursor.insertText(sender);
-	QTextTableCell messageCell = table->cellAt(table->rows() - 1, 2);
-	QTextCharFormat messageFormat;
+	QString senderStr;
+	if (sender == ownName)
+		senderStr = QString("<b><font color=\"red\">%1</font></b>").arg(Qt::escape(sender));
+	else
+		senderStr = QString("<font color=\"blue\">%1</font>").arg(Qt::escape(sender));
+	QString messageStr = Qt::escape(message);
 	if (sender.isEmpty())
-		messageFormat.setForeground(Qt::darkGreen);
-	messageCell.setFormat(messageFormat);
-	cellCursor = messageCell.lastCursorPosition();
-	cellCursor.insertText(message);
-	
-	table->appendRows(1);
+		messageStr = QString("<font color=\"darkgreen\">%1</font>").arg(messageStr);
+	appendHtml(QDateTime::currentDateTime().toString("[hh:mm]") + " " + senderStr + " " + messageStr);
 	
 	verticalScrollBar()->setValue(verticalScrollBar()->maximum());
 }
@@ -4,7 +4,7 @@
 #include "tab.h"
 #include "protocol_datastructures.h"
 #include <QGroupBox>
-#include <QTextEdit>
+#include <QPlainTextEdit>
 
 class AbstractClient;
 class UserList;
@@ -13,7 +13,6 @@ class QTextEdit;
 class QLineEdit;
 class QTreeView;
 class QPushButton;
-class QTextTable;
 class QCheckBox;
 class GamesModel;
 class GamesProxyModel;
@@ -49,11 +48,12 @@ public:
 	void processGameInfo(ServerInfo_Game *info);
 };
 
-class ChatView : public QTextEdit {
+class ChatView : public QPlainTextEdit {
 	Q_OBJECT;
 private:
-	QTextTable *table;
 	QString ownName;
+private slots:
+	void updateMaximumBlockCount();
 public:
 	ChatView(const QString &_ownName, QWidget *parent = 0);
 	void appendMessage(const QString &sender, const QString &message);
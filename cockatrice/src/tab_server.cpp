@@ -9,6 +9,7 @@
 #include <QLineEdit>
 #include <QHeaderView>
 #include <QInputDialog>
+#include <QSet>
 #include "tab_server.h"
 #include "abstractclient.h"
 #include "protocol.h"
@@ -119,7 +120,7 @@ void RoomSelector::joinFinished(ProtocolResponse *r)
 }
 
 TabServer::TabServer(AbstractClient *_client, ServerInfo_User *userInfo, QWidget *parent)
-	: Tab(parent), client(_client)
+	: Tab(parent), client(_client), userListVersion(-1)
 {
 	roomSelector = new RoomSelector(client);
 	serverInfoBox = new QTextBrowser;
@@ -130,13 +131,10 @@ TabServer::TabServer(AbstractClient *_client, ServerInfo_User *userInfo, QWidget
 	connect(roomSelector, SIGNAL(roomJoined(ServerInfo_Room *, bool)), this, SIGNAL(roomJoined(ServerInfo_Room *, bool)));
 	connect(userList, SIGNAL(openMessageDialog(const QString &, bool)), this, SIGNAL(openMessageDialog(const QString &, bool)));
 	
-	connect(client, SIGNAL(userJoinedEventReceived(Event_UserJoined *)), this, SLOT(processUserJoinedEvent(Event_UserJoined *)));
-	connect(client, SIGNAL(userLeftEventReceived(Event_UserLeft *)), this, SLOT(processUserLeftEvent(Event_UserLeft *)));
+	connect(client, SIGNAL(userListChangedEventReceived(Event_UserListChanged *)), this, SLOT(processUserListChangedEvent(Event_UserListChanged *)));
 	connect(client, SIGNAL(serverMessageEventReceived(Event_ServerMessage *)), this, SLOT(processServerMessageEvent(Event_ServerMessage *)));
 	
-	Command_ListUsers *cmd = new Command_ListUsers;
-	connect(cmd, SIGNAL(finished(ProtocolResponse *)), this, SLOT(processListUsersResponse(ProtocolResponse *)));
-	client->sendCommand(cmd);
+	requestUserList(-1);
 	
 	QVBoxLayout *vbox = new QVBoxLayout;
 	vbox->addWidget(roomSelector);
@@ -166,6 +164,25 @@ void TabServer::processServerMessageEvent(Event_ServerMessage *event)
 	emit userEvent();
 }
 
+void TabServer::requestUserList(int sinceVersion)
+{
+	Command_ListUsers *cmd = new Command_ListUsers(sinceVersion);
+	connect(cmd, SIGNAL(finished(ProtocolResponse *)), this, SLOT(processListUsersResponse(ProtocolResponse *)));
+	client->sendCommand(cmd);
+}
+
+void TabServer::applyUserListChanges(const QList<ServerInfo_User *> &changedUsers, const QStringList &leftUsers)
+{
+	for (int i = 0; i < leftUsers.size(); ++i)
+		if (userList->deleteUser(leftUsers[i]))
+			emit userLeft(leftUsers[i]);
+	
+	for (int i = 0; i < changedUsers.size(); ++i)
+		userList->processUserInfo(changedUsers[i]);
+	
+	userList->sortItems();
+}
+
 void TabServer::processListUsersResponse(ProtocolResponse *response)
 {
 	Response_ListUsers *resp = qobject_cast<Response_ListUsers *>(response);
@@ -173,20 +190,31 @@ void TabServer::processListUsersResponse(ProtocolResponse *response)
 		return;
 	
 	const QList<ServerInfo_User *> &respList = resp->getUserList();
-	for (int i = 0; i < respList.size(); ++i)
-		userList->processUserInfo(respList[i]);
+	QStringList leftUsers = resp->getLeftUserList();
+	if (!resp->getDelta()) {
+		// A complete list replaces whatever we knew before.
+		QSet<QString> presentUsers;
+		for (int i = 0; i < respList.size(); ++i)
+			presentUsers.insert(respList[i]->getName());
+		const QStringList knownUsers = userList->getUserNames();
+		for (int i = 0; i < knownUsers.size(); ++i)
+			if (!presentUsers.contains(knownUsers[i]))
+				leftUsers.append(knownUsers[i]);
+	}
 	
-	userList->sortItems();
+	applyUserListChanges(respList, leftUsers);
+	userListVersion = qMax(userListVersion, resp->getVersion());
 }
 
-void TabServer::processUserJoinedEvent(Event_UserJoined *event)
+void TabServer::processUserListChangedEvent(Event_UserListChanged *event)
 {
-	userList->processUserInfo(event->getUserInfo());
-	userList->sortItems();
+	if (event->getVersion() <= userListVersion)
+		return;
+	
+	// If batches were lost in between, fetch what changed since the last known version.
+	if ((userListVersion != -1) && (event->getVersion() != userListVersion + 1))
+		requestUserList(userListVersion);
+	
+	applyUserListChanges(event->getUserList(), event->getLeftUserList());
+	userListVersion = event->getVersion();
 }
-
-void TabServer::processUserLeftEvent(Event_UserLeft *event)
-{
-	if (userList->deleteUser(event->getUserName()))
-		emit userLeft(event->getUserName());
-}
\ No newline at end of file
@@ -15,8 +15,7 @@ class UserInfoBox;
 
 class Event_ListRooms;
 class Event_ServerMessage;
-class Event_UserJoined;
-class Event_UserLeft;
+class Event_UserListChanged;
 class ProtocolResponse;
 class ServerInfo_User;
 class ServerInfo_Room;
@@ -48,8 +47,7 @@ signals:
 	void userLeft(const QString &userName);
 private slots:
 	void processListUsersResponse(ProtocolResponse *response);
-	void processUserJoinedEvent(Event_UserJoined *event);
-	void processUserLeftEvent(Event_UserLeft *event);
+	void processUserListChangedEvent(Event_UserListChanged *event);
 	void processServerMessageEvent(Event_ServerMessage *event);
 private:
 	AbstractClient *client;
@@ -57,6 +55,9 @@ private:
 	QTextBrowser *serverInfoBox;
 	UserList *userList;
 	UserInfoBox *userInfoBox;
+	int userListVersion;
+	void requestUserList(int sinceVersion);
+	void applyUserListChanges(const QList<ServerInfo_User *> &changedUsers, const QStringList &leftUsers);
 public:
 	TabServer(AbstractClient *_client, ServerInfo_User *userInfo, QWidget *parent = 0);
 	void retranslateUi();
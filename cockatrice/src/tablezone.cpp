@@ -77,6 +77,7 @@ void TableZone::paint(QPainter *painter, const QStyleOptionGraphicsItem */*optio
 
 void TableZone::addCardImpl(CardItem *card, int _x, int _y)
 {
+	cardPositions.insert(card, cards.size());
 	cards.append(card);
 	card->setGridPoint(QPoint(_x, _y));
 
@@ -165,7 +166,7 @@ void TableZone::reorganizeCards()
 
 	QSetIterator<ArrowItem *> arrowIterator(QSet<ArrowItem *>::fromList(arrowsToUpdate));
 	while (arrowIterator.hasNext())
-		arrowIterator.next()->updatePath();
+		arrowIterator.next()->scheduleUpdatePath();
 	
 	resizeToContents();
 	update();
@@ -214,12 +215,50 @@ void TableZone::resizeToContents()
 	}
 }
 
+void TableZone::indexCard(CardItem *card)
+{
+	CardZone::indexCard(card);
+	const QPoint &gridPoint = card->getGridPoint();
+	if ((gridPoint.x() >= 0) && (gridPoint.y() >= 0))
+		cardsByGridPoint.insert(gridPointKey(gridPoint), card);
+}
+
+void TableZone::unindexCard(CardItem *card)
+{
+	CardZone::unindexCard(card);
+	cardPositions.remove(card);
+	const quint64 key = gridPointKey(card->getGridPoint());
+	if (cardsByGridPoint.value(key) == card)
+		cardsByGridPoint.remove(key);
+}
+
+CardItem *TableZone::takeCardAt(int position)
+{
+	CardItem *card = cards[position];
+	CardItem *lastCard = cards.takeLast();
+	if (lastCard != card) {
+		cards[position] = lastCard;
+		cardPositions.insert(lastCard, position);
+	}
+	cardPositions.remove(card);
+	return card;
+}
+
+void TableZone::cardGridPointChanged(CardItem *card, const QPoint &oldGridPoint)
+{
+	const quint64 oldKey = gridPointKey(oldGridPoint);
+	if (cardsByGridPoint.value(oldKey) == card)
+		cardsByGridPoint.remove(oldKey);
+	const QPoint &gridPoint = card->getGridPoint();
+	if ((gridPoint.x() >= 0) && (gridPoint.y() >= 0))
+		cardsByGridPoint.insert(gridPointKey(gridPoint), card);
+}
+
 CardItem *TableZone::getCardFromGrid(const QPoint &gridPoint) const
 {
-	for (int i = 0; i < cards.size(); i++)
-		if (cards.at(i)->getGridPoint() == gridPoint)
-			return cards.at(i);
-	return 0;
+	if ((gridPoint.x() < 0) || (gridPoint.y() < 0))
+		return 0;
+	return cardsByGridPoint.value(gridPointKey(gridPoint));
 }
 
 CardItem *TableZone::getCardFromCoords(const QPointF &point) const
@@ -15,6 +15,12 @@ private:
 	static const int minWidth = 15 * CARD_WIDTH / 2;
 
 	QMap<int, int> gridPointWidth;
+	// Cards that occupy a grid point; attached cards are not included.
+	QHash<quint64, CardItem *> cardsByGridPoint;
+	static quint64 gridPointKey(const QPoint &gridPoint) { return ((quint64) (quint32) gridPoint.y() << 32) | (quint32) gridPoint.x(); }
+	// The order of the cards on the table does not matter, so a card that
+	// is taken out is replaced by the last one and no search is needed.
+	QHash<CardItem *, int> cardPositions;
 	int width, height;
 	int currentMinimumWidth;
 	QPixmap bgPixmap;
@@ -42,8 +48,13 @@ public:
 	void setWidth(qreal _width);
 	qreal getWidth() const { return width; }
 	void setActive(bool _active) { active = _active; update(); }
+	void cardGridPointChanged(CardItem *card, const QPoint &oldGridPoint);
 protected:
 	void addCardImpl(CardItem *card, int x, int y);
+	void indexCard(CardItem *card);
+	void unindexCard(CardItem *card);
+	int cardPosition(CardItem *card) const { return cardPositions.value(card, -1); }
+	CardItem *takeCardAt(int position);
 };
 
 #endif
@@ -3,12 +3,15 @@
 #include "pixmapgenerator.h"
 #include "protocol_items.h"
 #include "abstractclient.h"
+#include "avatarcache.h"
 #include <QLabel>
 #include <QGridLayout>
 
 UserInfoBox::UserInfoBox(AbstractClient *_client, bool _fullInfo, QWidget *parent, Qt::WindowFlags flags)
-	: QWidget(parent, flags), client(_client), fullInfo(_fullInfo)
+	: QWidget(parent, flags), client(_client), fullInfo(_fullInfo), userLevel(ServerInfo_User::IsNothing)
 {
+	connect(client->getAvatarCache(), SIGNAL(avatarLoaded(const QString &)), this, SLOT(avatarLoaded(const QString &)));
+	
 	avatarLabel = new QLabel;
 	nameLabel = new QLabel;
 	QFont nameFont = nameLabel->font();
@@ -47,14 +50,25 @@ void UserInfoBox::retranslateUi()
 	userLevelLabel1->setText(tr("User level:"));
 }
 
-void UserInfoBox::updateInfo(ServerInfo_User *user)
+void UserInfoBox::updateAvatar()
 {
-	int userLevel = user->getUserLevel();
-	
 	QPixmap avatarPixmap;
-	if (!avatarPixmap.loadFromData(user->getAvatarBmp()))
+	if (!avatarPixmap.loadFromData(client->getAvatarCache()->getAvatar(avatarHash)))
 		avatarPixmap = UserLevelPixmapGenerator::generatePixmap(64, userLevel);
 	avatarLabel->setPixmap(avatarPixmap);
+}
+
+void UserInfoBox::avatarLoaded(const QString &_avatarHash)
+{
+	if (_avatarHash == avatarHash)
+		updateAvatar();
+}
+
+void UserInfoBox::updateInfo(ServerInfo_User *user)
+{
+	userLevel = user->getUserLevel();
+	avatarHash = user->getAvatarHash();
+	updateAvatar();
 	
 	nameLabel->setText(user->getName());
 	realNameLabel2->setText(user->getRealName());
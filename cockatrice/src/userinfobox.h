@@ -13,12 +13,16 @@ class UserInfoBox : public QWidget {
 private:
 	AbstractClient *client;
 	bool fullInfo;
+	QString avatarHash;
+	int userLevel;
 	QLabel *avatarLabel, *nameLabel, *realNameLabel1, *realNameLabel2, *countryLabel1, *countryLabel2, *userLevelLabel1, *userLevelLabel2, *userLevelLabel3;
+	void updateAvatar();
 public:
 	UserInfoBox(AbstractClient *_client, bool fullInfo, QWidget *parent = 0, Qt::WindowFlags flags = 0);
 	void retranslateUi();
 private slots:
 	void processResponse(ProtocolResponse *r);
+	void avatarLoaded(const QString &_avatarHash);
 public slots:
 	void updateInfo(ServerInfo_User *user);
 	void updateInfo(const QString &userName);
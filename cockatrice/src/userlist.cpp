@@ -100,6 +100,14 @@ bool UserList::deleteUser(const QString &userName)
 	return false;
 }
 
+QStringList UserList::getUserNames() const
+{
+	QStringList result;
+	for (int i = 0; i < userTree->topLevelItemCount(); ++i)
+		result.append(userTree->topLevelItem(i)->data(2, Qt::UserRole).toString());
+	return result;
+}
+
 void UserList::updateCount()
 {
 	setTitle(titleStr.arg(userTree->topLevelItemCount()));
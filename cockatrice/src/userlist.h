@@ -4,6 +4,7 @@
 #include <QGroupBox>
 #include <QTreeWidgetItem>
 #include <QItemDelegate>
+#include <QStringList>
 
 class QTreeWidget;
 class ServerInfo_User;
@@ -39,6 +40,7 @@ public:
 	void retranslateUi();
 	void processUserInfo(ServerInfo_User *user);
 	bool deleteUser(const QString &userName);
+	QStringList getUserNames() const;
 	void showContextMenu(const QPoint &pos, const QModelIndex &index);
 	void sortItems();
 };
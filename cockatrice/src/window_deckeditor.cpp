@@ -212,7 +212,8 @@ WndDeckEditor::WndDeckEditor(QWidget *parent)
 	verticalToolBar->addAction(aIncrement);
 	verticalToolBar->addAction(aDecrement);
 	
-	dlgCardSearch = new DlgCardSearch(this);
+	dlgCardSearch = 0;
+	connect(db, SIGNAL(loadingFinished(bool)), this, SLOT(cardDatabaseLoaded()));
 	
 	resize(950, 700);
 }
@@ -376,14 +377,30 @@ void WndDeckEditor::actEditSets()
 	w->show();
 }
 
+void WndDeckEditor::cardDatabaseLoaded()
+{
+	// The search dialog offers the card types and colors known at
+	// construction time, so rebuild it once the database is complete.
+	delete dlgCardSearch;
+	dlgCardSearch = 0;
+}
+
 void WndDeckEditor::actSearch()
 {
+	if (!dlgCardSearch)
+		dlgCardSearch = new DlgCardSearch(this);
 	if (dlgCardSearch->exec()) {
+		CardQuery query(dlgCardSearch->getCardQuery());
+		if (!query.isValid()) {
+			QMessageBox::critical(this, tr("Error"), tr("Invalid search query: %1").arg(query.getError()));
+			return;
+		}
 		searchEdit->clear();
 		databaseDisplayModel->setCardName(dlgCardSearch->getCardName());
 		databaseDisplayModel->setCardText(dlgCardSearch->getCardText());
 		databaseDisplayModel->setCardTypes(dlgCardSearch->getCardTypes());
 		databaseDisplayModel->setCardColors(dlgCardSearch->getCardColors());
+		databaseDisplayModel->setCardQuery(query);
 	}
 }
 
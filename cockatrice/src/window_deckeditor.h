@@ -33,6 +33,7 @@ private slots:
 	void updateCardInfoLeft(const QModelIndex &current, const QModelIndex &previous);
 	void updateCardInfoRight(const QModelIndex &current, const QModelIndex &previous);
 	void updateSearch(const QString &search);
+	void cardDatabaseLoaded();
 
 	void actNewDeck();
 	void actLoadDeck();
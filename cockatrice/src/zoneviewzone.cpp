@@ -139,8 +139,9 @@ void ZoneViewZone::removeCard(int position)
 		return;
 
 	CardItem *card = cards.takeAt(position);
+	unindexCard(card);
 	card->deleteLater();
-	reorganizeCards();
+	scheduleReorganize();
 }
 
 void ZoneViewZone::setGeometry(const QRectF &rect)
@@ -327,6 +327,14 @@ void DeckList::writeElement(QXmlStreamWriter *xml)
 		i.next().value()->write(xml);
 }
 
+void DeckList::moveItemToThread(QThread *thread)
+{
+	moveToThread(thread);
+	QMapIterator<QString, SideboardPlan *> i(sideboardPlans);
+	while (i.hasNext())
+		i.next().value()->moveItemToThread(thread);
+}
+
 void DeckList::loadFromXml(QXmlStreamReader *xml)
 {
 	while (!xml->atEnd()) {
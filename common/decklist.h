@@ -137,6 +137,7 @@ public:
 
 	bool readElement(QXmlStreamReader *xml);
 	void writeElement(QXmlStreamWriter *xml);
+	void moveItemToThread(QThread *thread);
 	void loadFromXml(QXmlStreamReader *xml);
 	
 	bool loadFromFile_Native(QIODevice *device);
@@ -28,6 +28,7 @@ void ProtocolItem::initializeHash()
 	registerSerializableItem("file", DeckList_File::newItem);
 	registerSerializableItem("directory", DeckList_Directory::newItem);
 	registerSerializableItem("card_id", CardId::newItem);
+	registerSerializableItem("left_user", LeftUserName::newItem);
 	
 	registerSerializableItem("containercmd", CommandContainer::newItem);
 	registerSerializableItem("containergame_event", GameEventContainer::newItem);
@@ -42,6 +43,7 @@ void ProtocolItem::initializeHash()
 	registerSerializableItem("respjoin_room", Response_JoinRoom::newItem);
 	registerSerializableItem("resplist_users", Response_ListUsers::newItem);
 	registerSerializableItem("respget_user_info", Response_GetUserInfo::newItem);
+	registerSerializableItem("respget_avatar", Response_GetAvatar::newItem);
 	registerSerializableItem("respdeck_list", Response_DeckList::newItem);
 	registerSerializableItem("respdeck_download", Response_DeckDownload::newItem);
 	registerSerializableItem("respdeck_upload", Response_DeckUpload::newItem);
@@ -50,7 +52,7 @@ void ProtocolItem::initializeHash()
 	
 	registerSerializableItem("room_eventlist_games", Event_ListGames::newItem);
 	registerSerializableItem("room_eventjoin_room", Event_JoinRoom::newItem);
-	registerSerializableItem("generic_eventuser_joined", Event_UserJoined::newItem);
+	registerSerializableItem("generic_eventuser_list_changed", Event_UserListChanged::newItem);
 	registerSerializableItem("generic_eventlist_rooms", Event_ListRooms::newItem);
 	registerSerializableItem("game_eventjoin", Event_Join::newItem);
 	registerSerializableItem("game_eventgame_state_changed", Event_GameStateChanged::newItem);
@@ -203,9 +205,9 @@ QList<MoveCardToZone *> Command_SetSideboardPlan::getMoveList() const
 Command_MoveCard::Command_MoveCard(int _gameId, const QString &_startZone, const QList<CardId *> &_cardIds, int _targetPlayerId, const QString &_targetZone, int _x, int _y, bool _faceDown, bool _tapped)
 	: GameCommand("move_card", _gameId)
 {
-	insertItem(new SerializableItem_String("start_zone", _startZone));
+	insertItem(new SerializableItem_ZoneName("start_zone", _startZone));
 	insertItem(new SerializableItem_Int("target_player_id", _targetPlayerId));
-	insertItem(new SerializableItem_String("target_zone", _targetZone));
+	insertItem(new SerializableItem_ZoneName("target_zone", _targetZone));
 	insertItem(new SerializableItem_Int("x", _x));
 	insertItem(new SerializableItem_Int("y", _y));
 	insertItem(new SerializableItem_Bool("face_down", _faceDown));
@@ -247,11 +249,24 @@ Response_JoinRoom::Response_JoinRoom(int _cmdId, ResponseCode _responseCode, Ser
 	insertItem(_roomInfo);
 }
 
-Response_ListUsers::Response_ListUsers(int _cmdId, ResponseCode _responseCode, const QList<ServerInfo_User *> &_userList)
+Response_ListUsers::Response_ListUsers(int _cmdId, ResponseCode _responseCode, int _version, bool _delta, const QList<ServerInfo_User *> &_userList, const QStringList &_leftUserList)
 	: ProtocolResponse(_cmdId, _responseCode, "list_users")
 {
+	insertItem(new SerializableItem_Int("version", _version));
+	insertItem(new SerializableItem_Bool("delta", _delta));
 	for (int i = 0; i < _userList.size(); ++i)
 		itemList.append(_userList[i]);
+	for (int i = 0; i < _leftUserList.size(); ++i)
+		itemList.append(new LeftUserName(_leftUserList[i]));
+}
+
+QStringList Response_ListUsers::getLeftUserList() const
+{
+	QStringList result;
+	const QList<LeftUserName *> &leftUsers = typecastItemList<LeftUserName *>();
+	for (int i = 0; i < leftUsers.size(); ++i)
+		result.append(leftUsers[i]->getData());
+	return result;
 }
 
 Response_DeckList::Response_DeckList(int _cmdId, ResponseCode _responseCode, DeckList_Directory *_root)
@@ -270,6 +285,13 @@ Response_GetUserInfo::Response_GetUserInfo(int _cmdId, ResponseCode _responseCod
 	insertItem(_user);
 }
 
+Response_GetAvatar::Response_GetAvatar(int _cmdId, ResponseCode _responseCode, const QString &_avatarHash, const QByteArray &_compressedAvatarBmp)
+	: ProtocolResponse(_cmdId, _responseCode, "get_avatar")
+{
+	insertItem(new SerializableItem_String("avatar_hash", _avatarHash));
+	insertItem(new SerializableItem_ByteArray("avatar_bmp", _compressedAvatarBmp, true));
+}
+
 Response_DeckDownload::Response_DeckDownload(int _cmdId, ResponseCode _responseCode, DeckList *_deck)
 	: ProtocolResponse(_cmdId, _responseCode, "deck_download")
 {
@@ -346,12 +368,23 @@ Event_ListGames::Event_ListGames(int _roomId, const QList<ServerInfo_Game *> &_g
 		itemList.append(_gameList[i]);
 }
 
-Event_UserJoined::Event_UserJoined(ServerInfo_User *_userInfo)
-	: GenericEvent("user_joined")
+Event_UserListChanged::Event_UserListChanged(int _version, const QList<ServerInfo_User *> &_userList, const QStringList &_leftUserList)
+	: GenericEvent("user_list_changed")
 {
-	if (!_userInfo)
-		_userInfo = new ServerInfo_User;
-	insertItem(_userInfo);
+	insertItem(new SerializableItem_Int("version", _version));
+	for (int i = 0; i < _userList.size(); ++i)
+		itemList.append(_userList[i]);
+	for (int i = 0; i < _leftUserList.size(); ++i)
+		itemList.append(new LeftUserName(_leftUserList[i]));
+}
+
+QStringList Event_UserListChanged::getLeftUserList() const
+{
+	QStringList result;
+	const QList<LeftUserName *> &leftUsers = typecastItemList<LeftUserName *>();
+	for (int i = 0; i < leftUsers.size(); ++i)
+		result.append(leftUsers[i]->getData());
+	return result;
 }
 
 Event_Join::Event_Join(ServerInfo_PlayerProperties *player)
@@ -464,7 +497,7 @@ Event_DrawCards::Event_DrawCards(int _playerId, int _numberCards, const QList<Se
 Event_RevealCards::Event_RevealCards(int _playerId, const QString &_zoneName, int _cardId, int _otherPlayerId, const QList<ServerInfo_Card *> &_cardList)
 	: GameEvent("reveal_cards", _playerId)
 {
-	insertItem(new SerializableItem_String("zone_name", _zoneName));
+	insertItem(new SerializableItem_ZoneName("zone_name", _zoneName));
 	insertItem(new SerializableItem_Int("card_id", _cardId));
 	insertItem(new SerializableItem_Int("other_player_id", _otherPlayerId));
 	for (int i = 0; i < _cardList.size(); ++i)
@@ -6,6 +6,7 @@
 #include <QHash>
 #include <QObject>
 #include <QVariant>
+#include <QStringList>
 #include "protocol_item_ids.h"
 #include "protocol_datastructures.h"
 
@@ -29,7 +30,7 @@ enum ItemId {
 	ItemId_Event_ListRooms = ItemId_Other + 200,
 	ItemId_Event_JoinRoom = ItemId_Other + 201,
 	ItemId_Event_ListGames = ItemId_Other + 203,
-	ItemId_Event_UserJoined = ItemId_Other + 204,
+	ItemId_Event_UserListChanged = ItemId_Other + 204,
 	ItemId_Event_GameStateChanged = ItemId_Other + 205,
 	ItemId_Event_PlayerPropertiesChanged = ItemId_Other + 206,
 	ItemId_Event_CreateArrows = ItemId_Other + 207,
@@ -46,6 +47,7 @@ enum ItemId {
 	ItemId_Response_DumpZone = ItemId_Other + 305,
 	ItemId_Response_JoinRoom = ItemId_Other + 306,
 	ItemId_Response_Login = ItemId_Other + 307,
+	ItemId_Response_GetAvatar = ItemId_Other + 308,
 	ItemId_Invalid = ItemId_Other + 1000
 };
 
@@ -55,7 +57,7 @@ private:
 	static void initializeHashAuto();
 	bool receiverMayDelete;
 public:
-	static const int protocolVersion = 11;
+	static const int protocolVersion = 15;
 	static void initializeHash();
 	virtual int getItemId() const = 0;
 	bool getReceiverMayDelete() const { return receiverMayDelete; }
@@ -205,10 +207,12 @@ class Command_MoveCard : public GameCommand {
 	Q_OBJECT
 public:
 	Command_MoveCard(int _gameId = -1, const QString &_startZone = QString(), const QList<CardId *> &_cardIds = QList<CardId *>(), int _targetPlayerId = -1, const QString &_targetZone = QString(), int _x = -1, int _y = -1, bool _faceDown = false, bool _tapped = false);
-	QString getStartZone() const { return static_cast<SerializableItem_String *>(itemMap.value("start_zone"))->getData(); }
+	QString getStartZone() const { return static_cast<SerializableItem_ZoneName *>(itemMap.value("start_zone"))->getData(); }
+	ZoneRef getStartZoneRef() const { return static_cast<SerializableItem_ZoneName *>(itemMap.value("start_zone"))->getRef(); }
 	QList<CardId *> getCardIds() const { return typecastItemList<CardId *>(); }
 	int getTargetPlayerId() const { return static_cast<SerializableItem_Int *>(itemMap.value("target_player_id"))->getData(); }
-	QString getTargetZone() const { return static_cast<SerializableItem_String *>(itemMap.value("target_zone"))->getData(); }
+	QString getTargetZone() const { return static_cast<SerializableItem_ZoneName *>(itemMap.value("target_zone"))->getData(); }
+	ZoneRef getTargetZoneRef() const { return static_cast<SerializableItem_ZoneName *>(itemMap.value("target_zone"))->getRef(); }
 	int getX() const { return static_cast<SerializableItem_Int *>(itemMap.value("x"))->getData(); }
 	int getY() const { return static_cast<SerializableItem_Int *>(itemMap.value("y"))->getData(); }
 	bool getFaceDown() const { return static_cast<SerializableItem_Bool *>(itemMap.value("face_down"))->getData(); }
@@ -246,10 +250,14 @@ public:
 class Response_ListUsers : public ProtocolResponse {
 	Q_OBJECT
 public:
-	Response_ListUsers(int _cmdId = -1, ResponseCode _responseCode = RespOk, const QList<ServerInfo_User *> &_userList = QList<ServerInfo_User *>());
+	// If _delta is set, the lists only contain the changes since the version given in Command_ListUsers.
+	Response_ListUsers(int _cmdId = -1, ResponseCode _responseCode = RespOk, int _version = -1, bool _delta = false, const QList<ServerInfo_User *> &_userList = QList<ServerInfo_User *>(), const QStringList &_leftUserList = QStringList());
 	int getItemId() const { return ItemId_Response_ListUsers; }
 	static SerializableItem *newItem() { return new Response_ListUsers; }
+	int getVersion() const { return static_cast<SerializableItem_Int *>(itemMap.value("version"))->getData(); }
+	bool getDelta() const { return static_cast<SerializableItem_Bool *>(itemMap.value("delta"))->getData(); }
 	QList<ServerInfo_User *> getUserList() const { return typecastItemList<ServerInfo_User *>(); }
+	QStringList getLeftUserList() const;
 };
 
 class Response_GetUserInfo : public ProtocolResponse {
@@ -261,6 +269,16 @@ public:
 	ServerInfo_User *getUserInfo() const { return static_cast<ServerInfo_User *>(itemMap.value("user")); }
 };
 
+class Response_GetAvatar : public ProtocolResponse {
+	Q_OBJECT
+public:
+	Response_GetAvatar(int _cmdId = -1, ResponseCode _responseCode = RespOk, const QString &_avatarHash = QString(), const QByteArray &_compressedAvatarBmp = QByteArray());
+	int getItemId() const { return ItemId_Response_GetAvatar; }
+	static SerializableItem *newItem() { return new Response_GetAvatar; }
+	QString getAvatarHash() const { return static_cast<SerializableItem_String *>(itemMap.value("avatar_hash"))->getData(); }
+	QByteArray getAvatarBmp() const { return static_cast<SerializableItem_ByteArray *>(itemMap.value("avatar_bmp"))->getData(); }
+};
+
 class Response_DeckList : public ProtocolResponse {
 	Q_OBJECT
 public:
@@ -385,13 +403,15 @@ public:
 	QList<ServerInfo_Game *> getGameList() const { return typecastItemList<ServerInfo_Game *>(); }
 };
 
-class Event_UserJoined : public GenericEvent {
+class Event_UserListChanged : public GenericEvent {
 	Q_OBJECT
 public:
-	Event_UserJoined(ServerInfo_User *_userInfo = 0);
-	int getItemId() const { return ItemId_Event_UserJoined; }
-	static SerializableItem *newItem() { return new Event_UserJoined; }
-	ServerInfo_User *getUserInfo() const { return static_cast<ServerInfo_User *>(itemMap.value("user")); }
+	Event_UserListChanged(int _version = -1, const QList<ServerInfo_User *> &_userList = QList<ServerInfo_User *>(), const QStringList &_leftUserList = QStringList());
+	int getItemId() const { return ItemId_Event_UserListChanged; }
+	static SerializableItem *newItem() { return new Event_UserListChanged; }
+	int getVersion() const { return static_cast<SerializableItem_Int *>(itemMap.value("version"))->getData(); }
+	QList<ServerInfo_User *> getUserList() const { return typecastItemList<ServerInfo_User *>(); }
+	QStringList getLeftUserList() const;
 };
 
 class Event_Join : public GameEvent {
@@ -468,7 +488,8 @@ public:
 	Event_RevealCards(int _playerId = -1, const QString &_zoneName = QString(), int cardId = -1, int _otherPlayerId = -1, const QList<ServerInfo_Card *> &_cardList = QList<ServerInfo_Card *>());
 	int getItemId() const { return ItemId_Event_RevealCards; }
 	static SerializableItem *newItem() { return new Event_RevealCards; }
-	QString getZoneName() const { return static_cast<SerializableItem_String *>(itemMap.value("zone_name"))->getData(); }
+	QString getZoneName() const { return static_cast<SerializableItem_ZoneName *>(itemMap.value("zone_name"))->getData(); }
+	ZoneRef getZoneNameRef() const { return static_cast<SerializableItem_ZoneName *>(itemMap.value("zone_name"))->getRef(); }
 	int getCardId() const { return static_cast<SerializableItem_Int *>(itemMap.value("card_id"))->getData(); }
 	int getOtherPlayerId() const { return static_cast<SerializableItem_Int *>(itemMap.value("other_player_id"))->getData(); }
 	QList<ServerInfo_Card *> getCardList() const { return typecastItemList<ServerInfo_Card *>(); }
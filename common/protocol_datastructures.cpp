@@ -2,25 +2,75 @@
 #include "decklist.h"
 #include <QXmlStreamReader>
 #include <QXmlStreamWriter>
+#include <QCryptographicHash>
 
-ServerInfo_User::ServerInfo_User(const QString &_name, int _userLevel, const QString &_realName, const QString &_country, const QByteArray &_avatarBmp)
+static const char *standardZoneNames[StandardZoneCount] = { "deck", "sb", "table", "hand", "stack", "grave", "rfg" };
+
+ZoneId ZoneNames::getZoneId(const QString &zoneName)
+{
+	for (int i = 0; i < StandardZoneCount; ++i)
+		if (zoneName == QLatin1String(standardZoneNames[i]))
+			return (ZoneId) i;
+	return CustomZoneId;
+}
+
+QString ZoneNames::getZoneName(ZoneId zoneId)
+{
+	if ((zoneId < 0) || (zoneId >= StandardZoneCount))
+		return QString();
+	return QString(standardZoneNames[zoneId]);
+}
+
+bool SerializableItem_ZoneName::readElement(QXmlStreamReader *xml)
+{
+	if (xml->isStartElement()) {
+		bool ok;
+		int id = xml->attributes().value("id").toString().toInt(&ok);
+		if (ok && (id >= 0) && (id < StandardZoneCount)) {
+			zoneId = (ZoneId) id;
+			data = ZoneNames::getZoneName(zoneId);
+		}
+	} else if (xml->isCharacters() && !xml->isWhitespace())
+		data.append(xml->text().toString());
+	else if (xml->isEndElement() && (zoneId == CustomZoneId))
+		// Standard zones may still arrive by name.
+		zoneId = ZoneNames::getZoneId(data);
+	return SerializableItem::readElement(xml);
+}
+
+void SerializableItem_ZoneName::writeElement(QXmlStreamWriter *xml)
+{
+	if (zoneId != CustomZoneId)
+		xml->writeAttribute("id", QString::number(zoneId));
+	else
+		xml->writeCharacters(data);
+}
+
+ServerInfo_User::ServerInfo_User(const QString &_name, int _userLevel, const QString &_realName, const QString &_country, const QString &_avatarHash)
 	: SerializableItem_Map("user")
 {
 	insertItem(new SerializableItem_String("name", _name));
 	insertItem(new SerializableItem_Int("userlevel", _userLevel));
 	insertItem(new SerializableItem_String("real_name", _realName));
 	insertItem(new SerializableItem_String("country", _country));
-	insertItem(new SerializableItem_ByteArray("avatar_bmp", _avatarBmp));
+	insertItem(new SerializableItem_String("avatar_hash", _avatarHash));
 }
 
-ServerInfo_User::ServerInfo_User(const ServerInfo_User *other, bool complete)
+ServerInfo_User::ServerInfo_User(const ServerInfo_User *other)
 	: SerializableItem_Map("user")
 {
 	insertItem(new SerializableItem_String("name", other->getName()));
 	insertItem(new SerializableItem_Int("userlevel", other->getUserLevel()));
 	insertItem(new SerializableItem_String("real_name", other->getRealName()));
 	insertItem(new SerializableItem_String("country", other->getCountry()));
-	insertItem(new SerializableItem_ByteArray("avatar_bmp", complete ? other->getAvatarBmp() : QByteArray()));
+	insertItem(new SerializableItem_String("avatar_hash", other->getAvatarHash()));
+}
+
+QString ServerInfo_User::calculateAvatarHash(const QByteArray &avatarBmp)
+{
+	if (avatarBmp.isEmpty())
+		return QString();
+	return QString(QCryptographicHash::hash(avatarBmp, QCryptographicHash::Sha1).toHex());
 }
 
 ServerInfo_Game::ServerInfo_Game(int _gameId, const QString &_description, bool _hasPassword, int _playerCount, int _maxPlayers, ServerInfo_User *_creatorInfo, bool _spectatorsAllowed, bool _spectatorsNeedPassword, int _spectatorCount)
@@ -84,7 +134,7 @@ ServerInfo_Card::ServerInfo_Card(int _id, const QString &_name, int _x, int _y,
 	: SerializableItem_Map("card")
 {
 	insertItem(new SerializableItem_Int("id", _id));
-	insertItem(new SerializableItem_String("name", _name));
+	insertItem(new SerializableItem_CardName("name", _name));
 	insertItem(new SerializableItem_Int("x", _x));
 	insertItem(new SerializableItem_Int("y", _y));
 	insertItem(new SerializableItem_Bool("tapped", _tapped));
@@ -94,7 +144,7 @@ ServerInfo_Card::ServerInfo_Card(int _id, const QString &_name, int _x, int _y,
 	insertItem(new SerializableItem_String("annotation", _annotation));
 	insertItem(new SerializableItem_Bool("destroy_on_zone_change", _destroyOnZoneChange));
 	insertItem(new SerializableItem_Int("attach_player_id", _attachPlayerId));
-	insertItem(new SerializableItem_String("attach_zone", _attachZone));
+	insertItem(new SerializableItem_ZoneName("attach_zone", _attachZone));
 	insertItem(new SerializableItem_Int("attach_card_id", _attachCardId));
 	
 	for (int i = 0; i < _counters.size(); ++i)
@@ -104,7 +154,7 @@ ServerInfo_Card::ServerInfo_Card(int _id, const QString &_name, int _x, int _y,
 ServerInfo_Zone::ServerInfo_Zone(const QString &_name, ZoneType _type, bool _hasCoords, int _cardCount, const QList<ServerInfo_Card *> &_cardList)
 	: SerializableItem_Map("zone")
 {
-	insertItem(new SerializableItem_String("name", _name));
+	insertItem(new SerializableItem_ZoneName("name", _name));
 	insertItem(new SerializableItem_String("zone_type", typeToString(_type)));
 	insertItem(new SerializableItem_Bool("has_coords", _hasCoords));
 	insertItem(new SerializableItem_Int("card_count", _cardCount));
@@ -157,10 +207,10 @@ ServerInfo_Arrow::ServerInfo_Arrow(int _id, int _startPlayerId, const QString &_
 {
 	insertItem(new SerializableItem_Int("id", _id));
 	insertItem(new SerializableItem_Int("start_player_id", _startPlayerId));
-	insertItem(new SerializableItem_String("start_zone", _startZone));
+	insertItem(new SerializableItem_ZoneName("start_zone", _startZone));
 	insertItem(new SerializableItem_Int("start_card_id", _startCardId));
 	insertItem(new SerializableItem_Int("target_player_id", _targetPlayerId));
-	insertItem(new SerializableItem_String("target_zone", _targetZone));
+	insertItem(new SerializableItem_ZoneName("target_zone", _targetZone));
 	insertItem(new SerializableItem_Int("target_card_id", _targetCardId));
 	insertItem(new SerializableItem_Color("color", _color));
 }
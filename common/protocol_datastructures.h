@@ -20,12 +20,61 @@ enum ResponseCode { RespNothing, RespOk, RespInvalidCommand, RespInvalidData, Re
 // list index, whereas cards in any other zone are referenced by their ids.
 enum ZoneType { PrivateZone, PublicZone, HiddenZone };
 
+// Every player owns the standard zones, so they are addressed by a fixed
+// numeric id. Zones created by the player at runtime are CustomZoneId and
+// keep being identified by their name.
+enum ZoneId { CustomZoneId = -1, DeckZoneId, SideboardZoneId, TableZoneId, HandZoneId, StackZoneId, GraveZoneId, ExileZoneId, StandardZoneCount };
+
+class ZoneNames {
+public:
+	static ZoneId getZoneId(const QString &zoneName);
+	static QString getZoneName(ZoneId zoneId);
+};
+
+// A zone as referred to by a protocol item. The id of a standard zone is
+// resolved once, when the item is created or decoded, so that looking the
+// zone up does not have to compare names. Custom zones are found by name.
+class ZoneRef {
+private:
+	ZoneId id;
+	QString name;
+public:
+	ZoneRef(const QString &_name = QString()) : id(ZoneNames::getZoneId(_name)), name(_name) { }
+	ZoneRef(ZoneId _id, const QString &_name) : id(_id), name(_name) { }
+	ZoneId getId() const { return id; }
+	const QString &getName() const { return name; }
+	bool isEmpty() const { return name.isEmpty(); }
+};
+
+// A zone name that is sent as its id if it refers to a standard zone.
+class SerializableItem_ZoneName : public SerializableItem {
+private:
+	QString data;
+	ZoneId zoneId;
+protected:
+	bool readElement(QXmlStreamReader *xml);
+	void writeElement(QXmlStreamWriter *xml);
+public:
+	SerializableItem_ZoneName(const QString &_itemType, const QString &_data)
+		: SerializableItem(_itemType), data(_data), zoneId(ZoneNames::getZoneId(_data)) { }
+	const QString &getData() { return data; }
+	ZoneRef getRef() const { return ZoneRef(zoneId, data); }
+	void setData(const QString &_data) { data = _data; zoneId = ZoneNames::getZoneId(_data); }
+	bool isEmpty() const { return data.isEmpty(); }
+};
+
 class CardId : public SerializableItem_Int {
 public:
 	CardId(int _cardId = -1) : SerializableItem_Int("card_id", _cardId) { }
 	static SerializableItem *newItem() { return new CardId; }
 };
 
+class LeftUserName : public SerializableItem_String {
+public:
+	LeftUserName(const QString &_userName = QString()) : SerializableItem_String("left_user", _userName) { }
+	static SerializableItem *newItem() { return new LeftUserName; }
+};
+
 class ServerInfo_User : public SerializableItem_Map {
 public:
 	enum UserLevelFlags {
@@ -35,15 +84,17 @@ public:
 		IsJudge = 0x04,
 		IsAdmin = 0x08
 	};
-	ServerInfo_User(const QString &_name = QString(), int _userLevel = IsNothing, const QString &_realName = QString(), const QString &_country = QString(), const QByteArray &_avatarBmp = QByteArray());
-	ServerInfo_User(const ServerInfo_User *other, bool complete = true);
+	ServerInfo_User(const QString &_name = QString(), int _userLevel = IsNothing, const QString &_realName = QString(), const QString &_country = QString(), const QString &_avatarHash = QString());
+	ServerInfo_User(const ServerInfo_User *other);
 	static SerializableItem *newItem() { return new ServerInfo_User; }
 	QString getName() const { return static_cast<SerializableItem_String *>(itemMap.value("name"))->getData(); }
 	int getUserLevel() const { return static_cast<SerializableItem_Int *>(itemMap.value("userlevel"))->getData(); }
 	void setUserLevel(int _userLevel) { static_cast<SerializableItem_Int *>(itemMap.value("userlevel"))->setData(_userLevel); }
 	QString getRealName() const { return static_cast<SerializableItem_String *>(itemMap.value("real_name"))->getData(); }
 	QString getCountry() const { return static_cast<SerializableItem_String *>(itemMap.value("country"))->getData(); }
-	QByteArray getAvatarBmp() const { return static_cast<SerializableItem_ByteArray *>(itemMap.value("avatar_bmp"))->getData(); }
+	// The avatar itself is not part of the user info. It is fetched separately by its hash using Command_GetAvatar.
+	QString getAvatarHash() const { return static_cast<SerializableItem_String *>(itemMap.value("avatar_hash"))->getData(); }
+	static QString calculateAvatarHash(const QByteArray &avatarBmp);
 };
 
 class ServerInfo_Game : public SerializableItem_Map {
@@ -93,7 +144,7 @@ public:
 	ServerInfo_Card(int _id = -1, const QString &_name = QString(), int _x = -1, int _y = -1, bool _tapped = false, bool _attacking = false, const QString &_color = QString(), const QString &_pt = QString(), const QString &_annotation = QString(), bool _destroyOnZoneChange = false, const QList<ServerInfo_CardCounter *> &_counterList = QList<ServerInfo_CardCounter *>(), int attachPlayerId = -1, const QString &_attachZone = QString(), int attachCardId = -1);
 	static SerializableItem *newItem() { return new ServerInfo_Card; }
 	int getId() const { return static_cast<SerializableItem_Int *>(itemMap.value("id"))->getData(); }
-	QString getName() const { return static_cast<SerializableItem_String *>(itemMap.value("name"))->getData(); }
+	QString getName() const { return static_cast<SerializableItem_CardName *>(itemMap.value("name"))->getData(); }
 	int getX() const { return static_cast<SerializableItem_Int *>(itemMap.value("x"))->getData(); }
 	int getY() const { return static_cast<SerializableItem_Int *>(itemMap.value("y"))->getData(); }
 	bool getTapped() const { return static_cast<SerializableItem_Bool *>(itemMap.value("tapped"))->getData(); }
@@ -104,7 +155,8 @@ public:
 	bool getDestroyOnZoneChange() const { return static_cast<SerializableItem_Bool *>(itemMap.value("destroy_on_zone_change"))->getData(); }
 	QList<ServerInfo_CardCounter *> getCounters() const { return typecastItemList<ServerInfo_CardCounter *>(); }
 	int getAttachPlayerId() const { return static_cast<SerializableItem_Int *>(itemMap.value("attach_player_id"))->getData(); }
-	QString getAttachZone() const { return static_cast<SerializableItem_String *>(itemMap.value("attach_zone"))->getData(); }
+	QString getAttachZone() const { return static_cast<SerializableItem_ZoneName *>(itemMap.value("attach_zone"))->getData(); }
+	ZoneRef getAttachZoneRef() const { return static_cast<SerializableItem_ZoneName *>(itemMap.value("attach_zone"))->getRef(); }
 	int getAttachCardId() const { return static_cast<SerializableItem_Int *>(itemMap.value("attach_card_id"))->getData(); }
 };
 
@@ -115,7 +167,8 @@ private:
 public:
 	ServerInfo_Zone(const QString &_name = QString(), ZoneType _type = PrivateZone, bool _hasCoords = false, int _cardCount = -1, const QList<ServerInfo_Card *> &_cardList = QList<ServerInfo_Card *>());
 	static SerializableItem *newItem() { return new ServerInfo_Zone; }
-	QString getName() const { return static_cast<SerializableItem_String *>(itemMap.value("name"))->getData(); }
+	QString getName() const { return static_cast<SerializableItem_ZoneName *>(itemMap.value("name"))->getData(); }
+	ZoneRef getNameRef() const { return static_cast<SerializableItem_ZoneName *>(itemMap.value("name"))->getRef(); }
 	ZoneType getType() const { return typeFromString(static_cast<SerializableItem_String *>(itemMap.value("type"))->getData()); }
 	bool getHasCoords() const { return static_cast<SerializableItem_Bool *>(itemMap.value("has_coords"))->getData(); }
 	int getCardCount() const { return static_cast<SerializableItem_Int *>(itemMap.value("card_count"))->getData(); }
@@ -139,10 +192,12 @@ public:
 	static SerializableItem *newItem() { return new ServerInfo_Arrow; }
 	int getId() const { return static_cast<SerializableItem_Int *>(itemMap.value("id"))->getData(); }
 	int getStartPlayerId() const { return static_cast<SerializableItem_Int *>(itemMap.value("start_player_id"))->getData(); }
-	QString getStartZone() const { return static_cast<SerializableItem_String *>(itemMap.value("start_zone"))->getData(); }
+	QString getStartZone() const { return static_cast<SerializableItem_ZoneName *>(itemMap.value("start_zone"))->getData(); }
+	ZoneRef getStartZoneRef() const { return static_cast<SerializableItem_ZoneName *>(itemMap.value("start_zone"))->getRef(); }
 	int getStartCardId() const { return static_cast<SerializableItem_Int *>(itemMap.value("start_card_id"))->getData(); }
 	int getTargetPlayerId() const { return static_cast<SerializableItem_Int *>(itemMap.value("target_player_id"))->getData(); }
-	QString getTargetZone() const { return static_cast<SerializableItem_String *>(itemMap.value("target_zone"))->getData(); }
+	QString getTargetZone() const { return static_cast<SerializableItem_ZoneName *>(itemMap.value("target_zone"))->getData(); }
+	ZoneRef getTargetZoneRef() const { return static_cast<SerializableItem_ZoneName *>(itemMap.value("target_zone"))->getRef(); }
 	int getTargetCardId() const { return static_cast<SerializableItem_Int *>(itemMap.value("target_card_id"))->getData(); }
 	Color getColor() const { return static_cast<SerializableItem_Color *>(itemMap.value("color"))->getData(); }
 };
@@ -4,65 +4,65 @@ ItemId_Command_Login = 1002,
 ItemId_Command_Message = 1003,
 ItemId_Command_ListUsers = 1004,
 ItemId_Command_GetUserInfo = 1005,
-ItemId_Command_DeckList = 1006,
-ItemId_Command_DeckNewDir = 1007,
-ItemId_Command_DeckDelDir = 1008,
-ItemId_Command_DeckDel = 1009,
-ItemId_Command_DeckDownload = 1010,
-ItemId_Command_ListRooms = 1011,
-ItemId_Command_JoinRoom = 1012,
-ItemId_Command_LeaveRoom = 1013,
-ItemId_Command_RoomSay = 1014,
-ItemId_Command_CreateGame = 1015,
-ItemId_Command_JoinGame = 1016,
-ItemId_Command_LeaveGame = 1017,
-ItemId_Command_Say = 1018,
-ItemId_Command_Shuffle = 1019,
-ItemId_Command_Mulligan = 1020,
-ItemId_Command_RollDie = 1021,
-ItemId_Command_DrawCards = 1022,
-ItemId_Command_FlipCard = 1023,
-ItemId_Command_AttachCard = 1024,
-ItemId_Command_CreateToken = 1025,
-ItemId_Command_CreateArrow = 1026,
-ItemId_Command_DeleteArrow = 1027,
-ItemId_Command_SetCardAttr = 1028,
-ItemId_Command_SetCardCounter = 1029,
-ItemId_Command_IncCardCounter = 1030,
-ItemId_Command_ReadyStart = 1031,
-ItemId_Command_Concede = 1032,
-ItemId_Command_IncCounter = 1033,
-ItemId_Command_CreateCounter = 1034,
-ItemId_Command_SetCounter = 1035,
-ItemId_Command_DelCounter = 1036,
-ItemId_Command_NextTurn = 1037,
-ItemId_Command_SetActivePhase = 1038,
-ItemId_Command_DumpZone = 1039,
-ItemId_Command_StopDumpZone = 1040,
-ItemId_Command_RevealCards = 1041,
-ItemId_Event_Say = 1042,
-ItemId_Event_Leave = 1043,
-ItemId_Event_GameClosed = 1044,
-ItemId_Event_Shuffle = 1045,
-ItemId_Event_RollDie = 1046,
-ItemId_Event_MoveCard = 1047,
-ItemId_Event_FlipCard = 1048,
-ItemId_Event_DestroyCard = 1049,
-ItemId_Event_AttachCard = 1050,
-ItemId_Event_CreateToken = 1051,
-ItemId_Event_DeleteArrow = 1052,
-ItemId_Event_SetCardAttr = 1053,
-ItemId_Event_SetCardCounter = 1054,
-ItemId_Event_SetCounter = 1055,
-ItemId_Event_DelCounter = 1056,
-ItemId_Event_SetActivePlayer = 1057,
-ItemId_Event_SetActivePhase = 1058,
-ItemId_Event_DumpZone = 1059,
-ItemId_Event_StopDumpZone = 1060,
-ItemId_Event_ServerMessage = 1061,
-ItemId_Event_Message = 1062,
-ItemId_Event_GameJoined = 1063,
-ItemId_Event_UserLeft = 1064,
+ItemId_Command_GetAvatar = 1006,
+ItemId_Command_DeckList = 1007,
+ItemId_Command_DeckNewDir = 1008,
+ItemId_Command_DeckDelDir = 1009,
+ItemId_Command_DeckDel = 1010,
+ItemId_Command_DeckDownload = 1011,
+ItemId_Command_ListRooms = 1012,
+ItemId_Command_JoinRoom = 1013,
+ItemId_Command_LeaveRoom = 1014,
+ItemId_Command_RoomSay = 1015,
+ItemId_Command_CreateGame = 1016,
+ItemId_Command_JoinGame = 1017,
+ItemId_Command_LeaveGame = 1018,
+ItemId_Command_Say = 1019,
+ItemId_Command_Shuffle = 1020,
+ItemId_Command_Mulligan = 1021,
+ItemId_Command_RollDie = 1022,
+ItemId_Command_DrawCards = 1023,
+ItemId_Command_FlipCard = 1024,
+ItemId_Command_AttachCard = 1025,
+ItemId_Command_CreateToken = 1026,
+ItemId_Command_CreateArrow = 1027,
+ItemId_Command_DeleteArrow = 1028,
+ItemId_Command_SetCardAttr = 1029,
+ItemId_Command_SetCardCounter = 1030,
+ItemId_Command_IncCardCounter = 1031,
+ItemId_Command_ReadyStart = 1032,
+ItemId_Command_Concede = 1033,
+ItemId_Command_IncCounter = 1034,
+ItemId_Command_CreateCounter = 1035,
+ItemId_Command_SetCounter = 1036,
+ItemId_Command_DelCounter = 1037,
+ItemId_Command_NextTurn = 1038,
+ItemId_Command_SetActivePhase = 1039,
+ItemId_Command_DumpZone = 1040,
+ItemId_Command_StopDumpZone = 1041,
+ItemId_Command_RevealCards = 1042,
+ItemId_Event_Say = 1043,
+ItemId_Event_Leave = 1044,
+ItemId_Event_GameClosed = 1045,
+ItemId_Event_Shuffle = 1046,
+ItemId_Event_RollDie = 1047,
+ItemId_Event_MoveCard = 1048,
+ItemId_Event_FlipCard = 1049,
+ItemId_Event_DestroyCard = 1050,
+ItemId_Event_AttachCard = 1051,
+ItemId_Event_CreateToken = 1052,
+ItemId_Event_DeleteArrow = 1053,
+ItemId_Event_SetCardAttr = 1054,
+ItemId_Event_SetCardCounter = 1055,
+ItemId_Event_SetCounter = 1056,
+ItemId_Event_DelCounter = 1057,
+ItemId_Event_SetActivePlayer = 1058,
+ItemId_Event_SetActivePhase = 1059,
+ItemId_Event_DumpZone = 1060,
+ItemId_Event_StopDumpZone = 1061,
+ItemId_Event_ServerMessage = 1062,
+ItemId_Event_Message = 1063,
+ItemId_Event_GameJoined = 1064,
 ItemId_Event_LeaveRoom = 1065,
 ItemId_Event_RoomSay = 1066,
 ItemId_Context_ReadyStart = 1067,
@@ -17,15 +17,21 @@ Command_Message::Command_Message(const QString &_userName, const QString &_text)
 	insertItem(new SerializableItem_String("user_name", _userName));
 	insertItem(new SerializableItem_String("text", _text));
 }
-Command_ListUsers::Command_ListUsers()
+Command_ListUsers::Command_ListUsers(int _sinceVersion)
 	: Command("list_users")
 {
+	insertItem(new SerializableItem_Int("since_version", _sinceVersion));
 }
 Command_GetUserInfo::Command_GetUserInfo(const QString &_userName)
 	: Command("get_user_info")
 {
 	insertItem(new SerializableItem_String("user_name", _userName));
 }
+Command_GetAvatar::Command_GetAvatar(const QString &_avatarHash)
+	: Command("get_avatar")
+{
+	insertItem(new SerializableItem_String("avatar_hash", _avatarHash));
+}
 Command_DeckList::Command_DeckList()
 	: Command("deck_list")
 {
@@ -117,23 +123,23 @@ Command_DrawCards::Command_DrawCards(int _gameId, int _number)
 Command_FlipCard::Command_FlipCard(int _gameId, const QString &_zone, int _cardId, bool _faceDown)
 	: GameCommand("flip_card", _gameId)
 {
-	insertItem(new SerializableItem_String("zone", _zone));
+	insertItem(new SerializableItem_ZoneName("zone", _zone));
 	insertItem(new SerializableItem_Int("card_id", _cardId));
 	insertItem(new SerializableItem_Bool("face_down", _faceDown));
 }
 Command_AttachCard::Command_AttachCard(int _gameId, const QString &_startZone, int _cardId, int _targetPlayerId, const QString &_targetZone, int _targetCardId)
 	: GameCommand("attach_card", _gameId)
 {
-	insertItem(new SerializableItem_String("start_zone", _startZone));
+	insertItem(new SerializableItem_ZoneName("start_zone", _startZone));
 	insertItem(new SerializableItem_Int("card_id", _cardId));
 	insertItem(new SerializableItem_Int("target_player_id", _targetPlayerId));
-	insertItem(new SerializableItem_String("target_zone", _targetZone));
+	insertItem(new SerializableItem_ZoneName("target_zone", _targetZone));
 	insertItem(new SerializableItem_Int("target_card_id", _targetCardId));
 }
 Command_CreateToken::Command_CreateToken(int _gameId, const QString &_zone, const QString &_cardName, const QString &_color, const QString &_pt, const QString &_annotation, bool _destroy, int _x, int _y)
 	: GameCommand("create_token", _gameId)
 {
-	insertItem(new SerializableItem_String("zone", _zone));
+	insertItem(new SerializableItem_ZoneName("zone", _zone));
 	insertItem(new SerializableItem_String("card_name", _cardName));
 	insertItem(new SerializableItem_String("color", _color));
 	insertItem(new SerializableItem_String("pt", _pt));
@@ -146,10 +152,10 @@ Command_CreateArrow::Command_CreateArrow(int _gameId, int _startPlayerId, const
 	: GameCommand("create_arrow", _gameId)
 {
 	insertItem(new SerializableItem_Int("start_player_id", _startPlayerId));
-	insertItem(new SerializableItem_String("start_zone", _startZone));
+	insertItem(new SerializableItem_ZoneName("start_zone", _startZone));
 	insertItem(new SerializableItem_Int("start_card_id", _startCardId));
 	insertItem(new SerializableItem_Int("target_player_id", _targetPlayerId));
-	insertItem(new SerializableItem_String("target_zone", _targetZone));
+	insertItem(new SerializableItem_ZoneName("target_zone", _targetZone));
 	insertItem(new SerializableItem_Int("target_card_id", _targetCardId));
 	insertItem(new SerializableItem_Color("color", _color));
 }
@@ -161,7 +167,7 @@ Command_DeleteArrow::Command_DeleteArrow(int _gameId, int _arrowId)
 Command_SetCardAttr::Command_SetCardAttr(int _gameId, const QString &_zone, int _cardId, const QString &_attrName, const QString &_attrValue)
 	: GameCommand("set_card_attr", _gameId)
 {
-	insertItem(new SerializableItem_String("zone", _zone));
+	insertItem(new SerializableItem_ZoneName("zone", _zone));
 	insertItem(new SerializableItem_Int("card_id", _cardId));
 	insertItem(new SerializableItem_String("attr_name", _attrName));
 	insertItem(new SerializableItem_String("attr_value", _attrValue));
@@ -169,7 +175,7 @@ Command_SetCardAttr::Command_SetCardAttr(int _gameId, const QString &_zone, int
 Command_SetCardCounter::Command_SetCardCounter(int _gameId, const QString &_zone, int _cardId, int _counterId, int _counterValue)
 	: GameCommand("set_card_counter", _gameId)
 {
-	insertItem(new SerializableItem_String("zone", _zone));
+	insertItem(new SerializableItem_ZoneName("zone", _zone));
 	insertItem(new SerializableItem_Int("card_id", _cardId));
 	insertItem(new SerializableItem_Int("counter_id", _counterId));
 	insertItem(new SerializableItem_Int("counter_value", _counterValue));
@@ -177,7 +183,7 @@ Command_SetCardCounter::Command_SetCardCounter(int _gameId, const QString &_zone
 Command_IncCardCounter::Command_IncCardCounter(int _gameId, const QString &_zone, int _cardId, int _counterId, int _counterDelta)
 	: GameCommand("inc_card_counter", _gameId)
 {
-	insertItem(new SerializableItem_String("zone", _zone));
+	insertItem(new SerializableItem_ZoneName("zone", _zone));
 	insertItem(new SerializableItem_Int("card_id", _cardId));
 	insertItem(new SerializableItem_Int("counter_id", _counterId));
 	insertItem(new SerializableItem_Int("counter_delta", _counterDelta));
@@ -229,19 +235,19 @@ Command_DumpZone::Command_DumpZone(int _gameId, int _playerId, const QString &_z
 	: GameCommand("dump_zone", _gameId)
 {
 	insertItem(new SerializableItem_Int("player_id", _playerId));
-	insertItem(new SerializableItem_String("zone_name", _zoneName));
+	insertItem(new SerializableItem_ZoneName("zone_name", _zoneName));
 	insertItem(new SerializableItem_Int("number_cards", _numberCards));
 }
 Command_StopDumpZone::Command_StopDumpZone(int _gameId, int _playerId, const QString &_zoneName)
 	: GameCommand("stop_dump_zone", _gameId)
 {
 	insertItem(new SerializableItem_Int("player_id", _playerId));
-	insertItem(new SerializableItem_String("zone_name", _zoneName));
+	insertItem(new SerializableItem_ZoneName("zone_name", _zoneName));
 }
 Command_RevealCards::Command_RevealCards(int _gameId, const QString &_zoneName, int _cardId, int _playerId)
 	: GameCommand("reveal_cards", _gameId)
 {
-	insertItem(new SerializableItem_String("zone_name", _zoneName));
+	insertItem(new SerializableItem_ZoneName("zone_name", _zoneName));
 	insertItem(new SerializableItem_Int("card_id", _cardId));
 	insertItem(new SerializableItem_Int("player_id", _playerId));
 }
@@ -272,11 +278,11 @@ Event_MoveCard::Event_MoveCard(int _playerId, int _cardId, const QString &_cardN
 	: GameEvent("move_card", _playerId)
 {
 	insertItem(new SerializableItem_Int("card_id", _cardId));
-	insertItem(new SerializableItem_String("card_name", _cardName));
-	insertItem(new SerializableItem_String("start_zone", _startZone));
+	insertItem(new SerializableItem_CardName("card_name", _cardName));
+	insertItem(new SerializableItem_ZoneName("start_zone", _startZone));
 	insertItem(new SerializableItem_Int("position", _position));
 	insertItem(new SerializableItem_Int("target_player_id", _targetPlayerId));
-	insertItem(new SerializableItem_String("target_zone", _targetZone));
+	insertItem(new SerializableItem_ZoneName("target_zone", _targetZone));
 	insertItem(new SerializableItem_Int("x", _x));
 	insertItem(new SerializableItem_Int("y", _y));
 	insertItem(new SerializableItem_Int("new_card_id", _newCardId));
@@ -285,32 +291,32 @@ Event_MoveCard::Event_MoveCard(int _playerId, int _cardId, const QString &_cardN
 Event_FlipCard::Event_FlipCard(int _playerId, const QString &_zone, int _cardId, const QString &_cardName, bool _faceDown)
 	: GameEvent("flip_card", _playerId)
 {
-	insertItem(new SerializableItem_String("zone", _zone));
+	insertItem(new SerializableItem_ZoneName("zone", _zone));
 	insertItem(new SerializableItem_Int("card_id", _cardId));
-	insertItem(new SerializableItem_String("card_name", _cardName));
+	insertItem(new SerializableItem_CardName("card_name", _cardName));
 	insertItem(new SerializableItem_Bool("face_down", _faceDown));
 }
 Event_DestroyCard::Event_DestroyCard(int _playerId, const QString &_zone, int _cardId)
 	: GameEvent("destroy_card", _playerId)
 {
-	insertItem(new SerializableItem_String("zone", _zone));
+	insertItem(new SerializableItem_ZoneName("zone", _zone));
 	insertItem(new SerializableItem_Int("card_id", _cardId));
 }
 Event_AttachCard::Event_AttachCard(int _playerId, const QString &_startZone, int _cardId, int _targetPlayerId, const QString &_targetZone, int _targetCardId)
 	: GameEvent("attach_card", _playerId)
 {
-	insertItem(new SerializableItem_String("start_zone", _startZone));
+	insertItem(new SerializableItem_ZoneName("start_zone", _startZone));
 	insertItem(new SerializableItem_Int("card_id", _cardId));
 	insertItem(new SerializableItem_Int("target_player_id", _targetPlayerId));
-	insertItem(new SerializableItem_String("target_zone", _targetZone));
+	insertItem(new SerializableItem_ZoneName("target_zone", _targetZone));
 	insertItem(new SerializableItem_Int("target_card_id", _targetCardId));
 }
 Event_CreateToken::Event_CreateToken(int _playerId, const QString &_zone, int _cardId, const QString &_cardName, const QString &_color, const QString &_pt, const QString &_annotation, bool _destroyOnZoneChange, int _x, int _y)
 	: GameEvent("create_token", _playerId)
 {
-	insertItem(new SerializableItem_String("zone", _zone));
+	insertItem(new SerializableItem_ZoneName("zone", _zone));
 	insertItem(new SerializableItem_Int("card_id", _cardId));
-	insertItem(new SerializableItem_String("card_name", _cardName));
+	insertItem(new SerializableItem_CardName("card_name", _cardName));
 	insertItem(new SerializableItem_String("color", _color));
 	insertItem(new SerializableItem_String("pt", _pt));
 	insertItem(new SerializableItem_String("annotation", _annotation));
@@ -326,7 +332,7 @@ Event_DeleteArrow::Event_DeleteArrow(int _playerId, int _arrowId)
 Event_SetCardAttr::Event_SetCardAttr(int _playerId, const QString &_zone, int _cardId, const QString &_attrName, const QString &_attrValue)
 	: GameEvent("set_card_attr", _playerId)
 {
-	insertItem(new SerializableItem_String("zone", _zone));
+	insertItem(new SerializableItem_ZoneName("zone", _zone));
 	insertItem(new SerializableItem_Int("card_id", _cardId));
 	insertItem(new SerializableItem_String("attr_name", _attrName));
 	insertItem(new SerializableItem_String("attr_value", _attrValue));
@@ -334,7 +340,7 @@ Event_SetCardAttr::Event_SetCardAttr(int _playerId, const QString &_zone, int _c
 Event_SetCardCounter::Event_SetCardCounter(int _playerId, const QString &_zone, int _cardId, int _counterId, int _counterValue)
 	: GameEvent("set_card_counter", _playerId)
 {
-	insertItem(new SerializableItem_String("zone", _zone));
+	insertItem(new SerializableItem_ZoneName("zone", _zone));
 	insertItem(new SerializableItem_Int("card_id", _cardId));
 	insertItem(new SerializableItem_Int("counter_id", _counterId));
 	insertItem(new SerializableItem_Int("counter_value", _counterValue));
@@ -364,14 +370,14 @@ Event_DumpZone::Event_DumpZone(int _playerId, int _zoneOwnerId, const QString &_
 	: GameEvent("dump_zone", _playerId)
 {
 	insertItem(new SerializableItem_Int("zone_owner_id", _zoneOwnerId));
-	insertItem(new SerializableItem_String("zone", _zone));
+	insertItem(new SerializableItem_ZoneName("zone", _zone));
 	insertItem(new SerializableItem_Int("number_cards", _numberCards));
 }
 Event_StopDumpZone::Event_StopDumpZone(int _playerId, int _zoneOwnerId, const QString &_zone)
 	: GameEvent("stop_dump_zone", _playerId)
 {
 	insertItem(new SerializableItem_Int("zone_owner_id", _zoneOwnerId));
-	insertItem(new SerializableItem_String("zone", _zone));
+	insertItem(new SerializableItem_ZoneName("zone", _zone));
 }
 Event_ServerMessage::Event_ServerMessage(const QString &_message)
 	: GenericEvent("server_message")
@@ -396,11 +402,6 @@ Event_GameJoined::Event_GameJoined(int _gameId, const QString &_gameDescription,
 	insertItem(new SerializableItem_Bool("spectators_see_everything", _spectatorsSeeEverything));
 	insertItem(new SerializableItem_Bool("resuming", _resuming));
 }
-Event_UserLeft::Event_UserLeft(const QString &_userName)
-	: GenericEvent("user_left")
-{
-	insertItem(new SerializableItem_String("user_name", _userName));
-}
 Event_LeaveRoom::Event_LeaveRoom(int _roomId, const QString &_playerName)
 	: RoomEvent("leave_room", _roomId)
 {
@@ -436,6 +437,7 @@ void ProtocolItem::initializeHashAuto()
 	itemNameHash.insert("cmdmessage", Command_Message::newItem);
 	itemNameHash.insert("cmdlist_users", Command_ListUsers::newItem);
 	itemNameHash.insert("cmdget_user_info", Command_GetUserInfo::newItem);
+	itemNameHash.insert("cmdget_avatar", Command_GetAvatar::newItem);
 	itemNameHash.insert("cmddeck_list", Command_DeckList::newItem);
 	itemNameHash.insert("cmddeck_new_dir", Command_DeckNewDir::newItem);
 	itemNameHash.insert("cmddeck_del_dir", Command_DeckDelDir::newItem);
@@ -494,7 +496,6 @@ void ProtocolItem::initializeHashAuto()
 	itemNameHash.insert("generic_eventserver_message", Event_ServerMessage::newItem);
 	itemNameHash.insert("generic_eventmessage", Event_Message::newItem);
 	itemNameHash.insert("generic_eventgame_joined", Event_GameJoined::newItem);
-	itemNameHash.insert("generic_eventuser_left", Event_UserLeft::newItem);
 	itemNameHash.insert("room_eventleave_room", Event_LeaveRoom::newItem);
 	itemNameHash.insert("room_eventroom_say", Event_RoomSay::newItem);
 	itemNameHash.insert("game_event_contextready_start", Context_ReadyStart::newItem);
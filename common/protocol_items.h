@@ -31,7 +31,8 @@ public:
 class Command_ListUsers : public Command {
 	Q_OBJECT
 public:
-	Command_ListUsers();
+	Command_ListUsers(int _sinceVersion = -1);
+	int getSinceVersion() const { return static_cast<SerializableItem_Int *>(itemMap.value("since_version"))->getData(); };
 	static SerializableItem *newItem() { return new Command_ListUsers; }
 	int getItemId() const { return ItemId_Command_ListUsers; }
 };
@@ -43,6 +44,14 @@ public:
 	static SerializableItem *newItem() { return new Command_GetUserInfo; }
 	int getItemId() const { return ItemId_Command_GetUserInfo; }
 };
+class Command_GetAvatar : public Command {
+	Q_OBJECT
+public:
+	Command_GetAvatar(const QString &_avatarHash = QString());
+	QString getAvatarHash() const { return static_cast<SerializableItem_String *>(itemMap.value("avatar_hash"))->getData(); };
+	static SerializableItem *newItem() { return new Command_GetAvatar; }
+	int getItemId() const { return ItemId_Command_GetAvatar; }
+};
 class Command_DeckList : public Command {
 	Q_OBJECT
 public:
@@ -186,7 +195,8 @@ class Command_FlipCard : public GameCommand {
 	Q_OBJECT
 public:
 	Command_FlipCard(int _gameId = -1, const QString &_zone = QString(), int _cardId = -1, bool _faceDown = false);
-	QString getZone() const { return static_cast<SerializableItem_String *>(itemMap.value("zone"))->getData(); };
+	QString getZone() const { return static_cast<SerializableItem_ZoneName *>(itemMap.value("zone"))->getData(); };
+	ZoneRef getZoneRef() const { return static_cast<SerializableItem_ZoneName *>(itemMap.value("zone"))->getRef(); };
 	int getCardId() const { return static_cast<SerializableItem_Int *>(itemMap.value("card_id"))->getData(); };
 	bool getFaceDown() const { return static_cast<SerializableItem_Bool *>(itemMap.value("face_down"))->getData(); };
 	static SerializableItem *newItem() { return new Command_FlipCard; }
@@ -196,10 +206,12 @@ class Command_AttachCard : public GameCommand {
 	Q_OBJECT
 public:
 	Command_AttachCard(int _gameId = -1, const QString &_startZone = QString(), int _cardId = -1, int _targetPlayerId = -1, const QString &_targetZone = QString(), int _targetCardId = -1);
-	QString getStartZone() const { return static_cast<SerializableItem_String *>(itemMap.value("start_zone"))->getData(); };
+	QString getStartZone() const { return static_cast<SerializableItem_ZoneName *>(itemMap.value("start_zone"))->getData(); };
+	ZoneRef getStartZoneRef() const { return static_cast<SerializableItem_ZoneName *>(itemMap.value("start_zone"))->getRef(); };
 	int getCardId() const { return static_cast<SerializableItem_Int *>(itemMap.value("card_id"))->getData(); };
 	int getTargetPlayerId() const { return static_cast<SerializableItem_Int *>(itemMap.value("target_player_id"))->getData(); };
-	QString getTargetZone() const { return static_cast<SerializableItem_String *>(itemMap.value("target_zone"))->getData(); };
+	QString getTargetZone() const { return static_cast<SerializableItem_ZoneName *>(itemMap.value("target_zone"))->getData(); };
+	ZoneRef getTargetZoneRef() const { return static_cast<SerializableItem_ZoneName *>(itemMap.value("target_zone"))->getRef(); };
 	int getTargetCardId() const { return static_cast<SerializableItem_Int *>(itemMap.value("target_card_id"))->getData(); };
 	static SerializableItem *newItem() { return new Command_AttachCard; }
 	int getItemId() const { return ItemId_Command_AttachCard; }
@@ -208,7 +220,8 @@ class Command_CreateToken : public GameCommand {
 	Q_OBJECT
 public:
 	Command_CreateToken(int _gameId = -1, const QString &_zone = QString(), const QString &_cardName = QString(), const QString &_color = QString(), const QString &_pt = QString(), const QString &_annotation = QString(), bool _destroy = false, int _x = -1, int _y = -1);
-	QString getZone() const { return static_cast<SerializableItem_String *>(itemMap.value("zone"))->getData(); };
+	QString getZone() const { return static_cast<SerializableItem_ZoneName *>(itemMap.value("zone"))->getData(); };
+	ZoneRef getZoneRef() const { return static_cast<SerializableItem_ZoneName *>(itemMap.value("zone"))->getRef(); };
 	QString getCardName() const { return static_cast<SerializableItem_String *>(itemMap.value("card_name"))->getData(); };
 	QString getColor() const { return static_cast<SerializableItem_String *>(itemMap.value("color"))->getData(); };
 	QString getPt() const { return static_cast<SerializableItem_String *>(itemMap.value("pt"))->getData(); };
@@ -224,10 +237,12 @@ class Command_CreateArrow : public GameCommand {
 public:
 	Command_CreateArrow(int _gameId = -1, int _startPlayerId = -1, const QString &_startZone = QString(), int _startCardId = -1, int _targetPlayerId = -1, const QString &_targetZone = QString(), int _targetCardId = -1, const Color &_color = Color());
 	int getStartPlayerId() const { return static_cast<SerializableItem_Int *>(itemMap.value("start_player_id"))->getData(); };
-	QString getStartZone() const { return static_cast<SerializableItem_String *>(itemMap.value("start_zone"))->getData(); };
+	QString getStartZone() const { return static_cast<SerializableItem_ZoneName *>(itemMap.value("start_zone"))->getData(); };
+	ZoneRef getStartZoneRef() const { return static_cast<SerializableItem_ZoneName *>(itemMap.value("start_zone"))->getRef(); };
 	int getStartCardId() const { return static_cast<SerializableItem_Int *>(itemMap.value("start_card_id"))->getData(); };
 	int getTargetPlayerId() const { return static_cast<SerializableItem_Int *>(itemMap.value("target_player_id"))->getData(); };
-	QString getTargetZone() const { return static_cast<SerializableItem_String *>(itemMap.value("target_zone"))->getData(); };
+	QString getTargetZone() const { return static_cast<SerializableItem_ZoneName *>(itemMap.value("target_zone"))->getData(); };
+	ZoneRef getTargetZoneRef() const { return static_cast<SerializableItem_ZoneName *>(itemMap.value("target_zone"))->getRef(); };
 	int getTargetCardId() const { return static_cast<SerializableItem_Int *>(itemMap.value("target_card_id"))->getData(); };
 	Color getColor() const { return static_cast<SerializableItem_Color *>(itemMap.value("color"))->getData(); };
 	static SerializableItem *newItem() { return new Command_CreateArrow; }
@@ -245,7 +260,8 @@ class Command_SetCardAttr : public GameCommand {
 	Q_OBJECT
 public:
 	Command_SetCardAttr(int _gameId = -1, const QString &_zone = QString(), int _cardId = -1, const QString &_attrName = QString(), const QString &_attrValue = QString());
-	QString getZone() const { return static_cast<SerializableItem_String *>(itemMap.value("zone"))->getData(); };
+	QString getZone() const { return static_cast<SerializableItem_ZoneName *>(itemMap.value("zone"))->getData(); };
+	ZoneRef getZoneRef() const { return static_cast<SerializableItem_ZoneName *>(itemMap.value("zone"))->getRef(); };
 	int getCardId() const { return static_cast<SerializableItem_Int *>(itemMap.value("card_id"))->getData(); };
 	QString getAttrName() const { return static_cast<SerializableItem_String *>(itemMap.value("attr_name"))->getData(); };
 	QString getAttrValue() const { return static_cast<SerializableItem_String *>(itemMap.value("attr_value"))->getData(); };
@@ -256,7 +272,8 @@ class Command_SetCardCounter : public GameCommand {
 	Q_OBJECT
 public:
 	Command_SetCardCounter(int _gameId = -1, const QString &_zone = QString(), int _cardId = -1, int _counterId = -1, int _counterValue = -1);
-	QString getZone() const { return static_cast<SerializableItem_String *>(itemMap.value("zone"))->getData(); };
+	QString getZone() const { return static_cast<SerializableItem_ZoneName *>(itemMap.value("zone"))->getData(); };
+	ZoneRef getZoneRef() const { return static_cast<SerializableItem_ZoneName *>(itemMap.value("zone"))->getRef(); };
 	int getCardId() const { return static_cast<SerializableItem_Int *>(itemMap.value("card_id"))->getData(); };
 	int getCounterId() const { return static_cast<SerializableItem_Int *>(itemMap.value("counter_id"))->getData(); };
 	int getCounterValue() const { return static_cast<SerializableItem_Int *>(itemMap.value("counter_value"))->getData(); };
@@ -267,7 +284,8 @@ class Command_IncCardCounter : public GameCommand {
 	Q_OBJECT
 public:
 	Command_IncCardCounter(int _gameId = -1, const QString &_zone = QString(), int _cardId = -1, int _counterId = -1, int _counterDelta = -1);
-	QString getZone() const { return static_cast<SerializableItem_String *>(itemMap.value("zone"))->getData(); };
+	QString getZone() const { return static_cast<SerializableItem_ZoneName *>(itemMap.value("zone"))->getData(); };
+	ZoneRef getZoneRef() const { return static_cast<SerializableItem_ZoneName *>(itemMap.value("zone"))->getRef(); };
 	int getCardId() const { return static_cast<SerializableItem_Int *>(itemMap.value("card_id"))->getData(); };
 	int getCounterId() const { return static_cast<SerializableItem_Int *>(itemMap.value("counter_id"))->getData(); };
 	int getCounterDelta() const { return static_cast<SerializableItem_Int *>(itemMap.value("counter_delta"))->getData(); };
@@ -346,7 +364,8 @@ class Command_DumpZone : public GameCommand {
 public:
 	Command_DumpZone(int _gameId = -1, int _playerId = -1, const QString &_zoneName = QString(), int _numberCards = -1);
 	int getPlayerId() const { return static_cast<SerializableItem_Int *>(itemMap.value("player_id"))->getData(); };
-	QString getZoneName() const { return static_cast<SerializableItem_String *>(itemMap.value("zone_name"))->getData(); };
+	QString getZoneName() const { return static_cast<SerializableItem_ZoneName *>(itemMap.value("zone_name"))->getData(); };
+	ZoneRef getZoneNameRef() const { return static_cast<SerializableItem_ZoneName *>(itemMap.value("zone_name"))->getRef(); };
 	int getNumberCards() const { return static_cast<SerializableItem_Int *>(itemMap.value("number_cards"))->getData(); };
 	static SerializableItem *newItem() { return new Command_DumpZone; }
 	int getItemId() const { return ItemId_Command_DumpZone; }
@@ -356,7 +375,8 @@ class Command_StopDumpZone : public GameCommand {
 public:
 	Command_StopDumpZone(int _gameId = -1, int _playerId = -1, const QString &_zoneName = QString());
 	int getPlayerId() const { return static_cast<SerializableItem_Int *>(itemMap.value("player_id"))->getData(); };
-	QString getZoneName() const { return static_cast<SerializableItem_String *>(itemMap.value("zone_name"))->getData(); };
+	QString getZoneName() const { return static_cast<SerializableItem_ZoneName *>(itemMap.value("zone_name"))->getData(); };
+	ZoneRef getZoneNameRef() const { return static_cast<SerializableItem_ZoneName *>(itemMap.value("zone_name"))->getRef(); };
 	static SerializableItem *newItem() { return new Command_StopDumpZone; }
 	int getItemId() const { return ItemId_Command_StopDumpZone; }
 };
@@ -364,7 +384,8 @@ class Command_RevealCards : public GameCommand {
 	Q_OBJECT
 public:
 	Command_RevealCards(int _gameId = -1, const QString &_zoneName = QString(), int _cardId = -1, int _playerId = -1);
-	QString getZoneName() const { return static_cast<SerializableItem_String *>(itemMap.value("zone_name"))->getData(); };
+	QString getZoneName() const { return static_cast<SerializableItem_ZoneName *>(itemMap.value("zone_name"))->getData(); };
+	ZoneRef getZoneNameRef() const { return static_cast<SerializableItem_ZoneName *>(itemMap.value("zone_name"))->getRef(); };
 	int getCardId() const { return static_cast<SerializableItem_Int *>(itemMap.value("card_id"))->getData(); };
 	int getPlayerId() const { return static_cast<SerializableItem_Int *>(itemMap.value("player_id"))->getData(); };
 	static SerializableItem *newItem() { return new Command_RevealCards; }
@@ -413,11 +434,13 @@ class Event_MoveCard : public GameEvent {
 public:
 	Event_MoveCard(int _playerId = -1, int _cardId = -1, const QString &_cardName = QString(), const QString &_startZone = QString(), int _position = -1, int _targetPlayerId = -1, const QString &_targetZone = QString(), int _x = -1, int _y = -1, int _newCardId = -1, bool _faceDown = false);
 	int getCardId() const { return static_cast<SerializableItem_Int *>(itemMap.value("card_id"))->getData(); };
-	QString getCardName() const { return static_cast<SerializableItem_String *>(itemMap.value("card_name"))->getData(); };
-	QString getStartZone() const { return static_cast<SerializableItem_String *>(itemMap.value("start_zone"))->getData(); };
+	QString getCardName() const { return static_cast<SerializableItem_CardName *>(itemMap.value("card_name"))->getData(); };
+	QString getStartZone() const { return static_cast<SerializableItem_ZoneName *>(itemMap.value("start_zone"))->getData(); };
+	ZoneRef getStartZoneRef() const { return static_cast<SerializableItem_ZoneName *>(itemMap.value("start_zone"))->getRef(); };
 	int getPosition() const { return static_cast<SerializableItem_Int *>(itemMap.value("position"))->getData(); };
 	int getTargetPlayerId() const { return static_cast<SerializableItem_Int *>(itemMap.value("target_player_id"))->getData(); };
-	QString getTargetZone() const { return static_cast<SerializableItem_String *>(itemMap.value("target_zone"))->getData(); };
+	QString getTargetZone() const { return static_cast<SerializableItem_ZoneName *>(itemMap.value("target_zone"))->getData(); };
+	ZoneRef getTargetZoneRef() const { return static_cast<SerializableItem_ZoneName *>(itemMap.value("target_zone"))->getRef(); };
 	int getX() const { return static_cast<SerializableItem_Int *>(itemMap.value("x"))->getData(); };
 	int getY() const { return static_cast<SerializableItem_Int *>(itemMap.value("y"))->getData(); };
 	int getNewCardId() const { return static_cast<SerializableItem_Int *>(itemMap.value("new_card_id"))->getData(); };
@@ -429,9 +452,10 @@ class Event_FlipCard : public GameEvent {
 	Q_OBJECT
 public:
 	Event_FlipCard(int _playerId = -1, const QString &_zone = QString(), int _cardId = -1, const QString &_cardName = QString(), bool _faceDown = false);
-	QString getZone() const { return static_cast<SerializableItem_String *>(itemMap.value("zone"))->getData(); };
+	QString getZone() const { return static_cast<SerializableItem_ZoneName *>(itemMap.value("zone"))->getData(); };
+	ZoneRef getZoneRef() const { return static_cast<SerializableItem_ZoneName *>(itemMap.value("zone"))->getRef(); };
 	int getCardId() const { return static_cast<SerializableItem_Int *>(itemMap.value("card_id"))->getData(); };
-	QString getCardName() const { return static_cast<SerializableItem_String *>(itemMap.value("card_name"))->getData(); };
+	QString getCardName() const { return static_cast<SerializableItem_CardName *>(itemMap.value("card_name"))->getData(); };
 	bool getFaceDown() const { return static_cast<SerializableItem_Bool *>(itemMap.value("face_down"))->getData(); };
 	static SerializableItem *newItem() { return new Event_FlipCard; }
 	int getItemId() const { return ItemId_Event_FlipCard; }
@@ -440,7 +464,8 @@ class Event_DestroyCard : public GameEvent {
 	Q_OBJECT
 public:
 	Event_DestroyCard(int _playerId = -1, const QString &_zone = QString(), int _cardId = -1);
-	QString getZone() const { return static_cast<SerializableItem_String *>(itemMap.value("zone"))->getData(); };
+	QString getZone() const { return static_cast<SerializableItem_ZoneName *>(itemMap.value("zone"))->getData(); };
+	ZoneRef getZoneRef() const { return static_cast<SerializableItem_ZoneName *>(itemMap.value("zone"))->getRef(); };
 	int getCardId() const { return static_cast<SerializableItem_Int *>(itemMap.value("card_id"))->getData(); };
 	static SerializableItem *newItem() { return new Event_DestroyCard; }
 	int getItemId() const { return ItemId_Event_DestroyCard; }
@@ -449,10 +474,12 @@ class Event_AttachCard : public GameEvent {
 	Q_OBJECT
 public:
 	Event_AttachCard(int _playerId = -1, const QString &_startZone = QString(), int _cardId = -1, int _targetPlayerId = -1, const QString &_targetZone = QString(), int _targetCardId = -1);
-	QString getStartZone() const { return static_cast<SerializableItem_String *>(itemMap.value("start_zone"))->getData(); };
+	QString getStartZone() const { return static_cast<SerializableItem_ZoneName *>(itemMap.value("start_zone"))->getData(); };
+	ZoneRef getStartZoneRef() const { return static_cast<SerializableItem_ZoneName *>(itemMap.value("start_zone"))->getRef(); };
 	int getCardId() const { return static_cast<SerializableItem_Int *>(itemMap.value("card_id"))->getData(); };
 	int getTargetPlayerId() const { return static_cast<SerializableItem_Int *>(itemMap.value("target_player_id"))->getData(); };
-	QString getTargetZone() const { return static_cast<SerializableItem_String *>(itemMap.value("target_zone"))->getData(); };
+	QString getTargetZone() const { return static_cast<SerializableItem_ZoneName *>(itemMap.value("target_zone"))->getData(); };
+	ZoneRef getTargetZoneRef() const { return static_cast<SerializableItem_ZoneName *>(itemMap.value("target_zone"))->getRef(); };
 	int getTargetCardId() const { return static_cast<SerializableItem_Int *>(itemMap.value("target_card_id"))->getData(); };
 	static SerializableItem *newItem() { return new Event_AttachCard; }
 	int getItemId() const { return ItemId_Event_AttachCard; }
@@ -461,9 +488,10 @@ class Event_CreateToken : public GameEvent {
 	Q_OBJECT
 public:
 	Event_CreateToken(int _playerId = -1, const QString &_zone = QString(), int _cardId = -1, const QString &_cardName = QString(), const QString &_color = QString(), const QString &_pt = QString(), const QString &_annotation = QString(), bool _destroyOnZoneChange = false, int _x = -1, int _y = -1);
-	QString getZone() const { return static_cast<SerializableItem_String *>(itemMap.value("zone"))->getData(); };
+	QString getZone() const { return static_cast<SerializableItem_ZoneName *>(itemMap.value("zone"))->getData(); };
+	ZoneRef getZoneRef() const { return static_cast<SerializableItem_ZoneName *>(itemMap.value("zone"))->getRef(); };
 	int getCardId() const { return static_cast<SerializableItem_Int *>(itemMap.value("card_id"))->getData(); };
-	QString getCardName() const { return static_cast<SerializableItem_String *>(itemMap.value("card_name"))->getData(); };
+	QString getCardName() const { return static_cast<SerializableItem_CardName *>(itemMap.value("card_name"))->getData(); };
 	QString getColor() const { return static_cast<SerializableItem_String *>(itemMap.value("color"))->getData(); };
 	QString getPt() const { return static_cast<SerializableItem_String *>(itemMap.value("pt"))->getData(); };
 	QString getAnnotation() const { return static_cast<SerializableItem_String *>(itemMap.value("annotation"))->getData(); };
@@ -485,7 +513,8 @@ class Event_SetCardAttr : public GameEvent {
 	Q_OBJECT
 public:
 	Event_SetCardAttr(int _playerId = -1, const QString &_zone = QString(), int _cardId = -1, const QString &_attrName = QString(), const QString &_attrValue = QString());
-	QString getZone() const { return static_cast<SerializableItem_String *>(itemMap.value("zone"))->getData(); };
+	QString getZone() const { return static_cast<SerializableItem_ZoneName *>(itemMap.value("zone"))->getData(); };
+	ZoneRef getZoneRef() const { return static_cast<SerializableItem_ZoneName *>(itemMap.value("zone"))->getRef(); };
 	int getCardId() const { return static_cast<SerializableItem_Int *>(itemMap.value("card_id"))->getData(); };
 	QString getAttrName() const { return static_cast<SerializableItem_String *>(itemMap.value("attr_name"))->getData(); };
 	QString getAttrValue() const { return static_cast<SerializableItem_String *>(itemMap.value("attr_value"))->getData(); };
@@ -496,7 +525,8 @@ class Event_SetCardCounter : public GameEvent {
 	Q_OBJECT
 public:
 	Event_SetCardCounter(int _playerId = -1, const QString &_zone = QString(), int _cardId = -1, int _counterId = -1, int _counterValue = -1);
-	QString getZone() const { return static_cast<SerializableItem_String *>(itemMap.value("zone"))->getData(); };
+	QString getZone() const { return static_cast<SerializableItem_ZoneName *>(itemMap.value("zone"))->getData(); };
+	ZoneRef getZoneRef() const { return static_cast<SerializableItem_ZoneName *>(itemMap.value("zone"))->getRef(); };
 	int getCardId() const { return static_cast<SerializableItem_Int *>(itemMap.value("card_id"))->getData(); };
 	int getCounterId() const { return static_cast<SerializableItem_Int *>(itemMap.value("counter_id"))->getData(); };
 	int getCounterValue() const { return static_cast<SerializableItem_Int *>(itemMap.value("counter_value"))->getData(); };
@@ -541,7 +571,8 @@ class Event_DumpZone : public GameEvent {
 public:
 	Event_DumpZone(int _playerId = -1, int _zoneOwnerId = -1, const QString &_zone = QString(), int _numberCards = -1);
 	int getZoneOwnerId() const { return static_cast<SerializableItem_Int *>(itemMap.value("zone_owner_id"))->getData(); };
-	QString getZone() const { return static_cast<SerializableItem_String *>(itemMap.value("zone"))->getData(); };
+	QString getZone() const { return static_cast<SerializableItem_ZoneName *>(itemMap.value("zone"))->getData(); };
+	ZoneRef getZoneRef() const { return static_cast<SerializableItem_ZoneName *>(itemMap.value("zone"))->getRef(); };
 	int getNumberCards() const { return static_cast<SerializableItem_Int *>(itemMap.value("number_cards"))->getData(); };
 	static SerializableItem *newItem() { return new Event_DumpZone; }
 	int getItemId() const { return ItemId_Event_DumpZone; }
@@ -551,7 +582,8 @@ class Event_StopDumpZone : public GameEvent {
 public:
 	Event_StopDumpZone(int _playerId = -1, int _zoneOwnerId = -1, const QString &_zone = QString());
 	int getZoneOwnerId() const { return static_cast<SerializableItem_Int *>(itemMap.value("zone_owner_id"))->getData(); };
-	QString getZone() const { return static_cast<SerializableItem_String *>(itemMap.value("zone"))->getData(); };
+	QString getZone() const { return static_cast<SerializableItem_ZoneName *>(itemMap.value("zone"))->getData(); };
+	ZoneRef getZoneRef() const { return static_cast<SerializableItem_ZoneName *>(itemMap.value("zone"))->getRef(); };
 	static SerializableItem *newItem() { return new Event_StopDumpZone; }
 	int getItemId() const { return ItemId_Event_StopDumpZone; }
 };
@@ -587,14 +619,6 @@ public:
 	static SerializableItem *newItem() { return new Event_GameJoined; }
 	int getItemId() const { return ItemId_Event_GameJoined; }
 };
-class Event_UserLeft : public GenericEvent {
-	Q_OBJECT
-public:
-	Event_UserLeft(const QString &_userName = QString());
-	QString getUserName() const { return static_cast<SerializableItem_String *>(itemMap.value("user_name"))->getData(); };
-	static SerializableItem *newItem() { return new Event_UserLeft; }
-	int getItemId() const { return ItemId_Event_UserLeft; }
-};
 class Event_LeaveRoom : public RoomEvent {
 	Q_OBJECT
 public:
@@ -109,6 +109,19 @@ while (<file>) {
 			$constructorParamsCpp .= "const QString &_$prettyVarName";
 			$constructorCode .= "\tinsertItem(new SerializableItem_String(\"$value\", _$prettyVarName));\n";
 			$getFunctionCode .= "\t$dataType get$prettyVarName2() const { return static_cast<SerializableItem_String *>(itemMap.value(\"$value\"))->getData(); };\n";
+		} elsif ($key eq 'n') {
+			$dataType = 'QString';
+			$constructorParamsH .= "const QString &_$prettyVarName = QString()";
+			$constructorParamsCpp .= "const QString &_$prettyVarName";
+			$constructorCode .= "\tinsertItem(new SerializableItem_CardName(\"$value\", _$prettyVarName));\n";
+			$getFunctionCode .= "\t$dataType get$prettyVarName2() const { return static_cast<SerializableItem_CardName *>(itemMap.value(\"$value\"))->getData(); };\n";
+		} elsif ($key eq 'z') {
+			$dataType = 'QString';
+			$constructorParamsH .= "const QString &_$prettyVarName = QString()";
+			$constructorParamsCpp .= "const QString &_$prettyVarName";
+			$constructorCode .= "\tinsertItem(new SerializableItem_ZoneName(\"$value\", _$prettyVarName));\n";
+			$getFunctionCode .= "\t$dataType get$prettyVarName2() const { return static_cast<SerializableItem_ZoneName *>(itemMap.value(\"$value\"))->getData(); };\n";
+			$getFunctionCode .= "\tZoneRef get${prettyVarName2}Ref() const { return static_cast<SerializableItem_ZoneName *>(itemMap.value(\"$value\"))->getRef(); };\n";
 		} elsif ($key eq 'i') {
 			$dataType = 'int';
 			$constructorParamsH .= "int _$prettyVarName = -1";
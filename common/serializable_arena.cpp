@@ -0,0 +1,143 @@
+#include "serializable_arena.h"
+#include <QThread>
+#include <new>
+
+QThreadStorage<SerializableArena **> SerializableArena::currentStorage;
+
+SerializableArena *&SerializableArena::current()
+{
+	if (!currentStorage.hasLocalData())
+		currentStorage.setLocalData(new SerializableArena *(0));
+	return *currentStorage.localData();
+}
+
+SerializableArena::Scope::Scope(SerializableArena *_arena)
+	: arena(_arena), previous(current())
+{
+	Q_ASSERT(arena->ownerThread == QThread::currentThread());
+	current() = arena;
+	++arena->scopeDepth;
+}
+
+SerializableArena::Scope::~Scope()
+{
+	current() = previous;
+	if (!--arena->scopeDepth)
+		arena->reset();
+}
+
+SerializableArena::SerializableArena()
+	: ownerThread(QThread::currentThread()), scopeDepth(0), allocationCount(0), heapAllocationCount(0)
+{
+}
+
+SerializableArena::~SerializableArena()
+{
+	reset();
+	for (int i = 0; i < freeChunks.size(); ++i)
+		::operator delete(freeChunks[i]);
+	
+	// Retired chunks are freed by the deletion of their last item.
+	QSetIterator<Chunk *> retiredIterator(retiredChunks);
+	while (retiredIterator.hasNext())
+		retiredIterator.next()->arena = 0;
+}
+
+int SerializableArena::headerSize()
+{
+	// Every allocation is preceded by a pointer to its chunk, or 0 if it
+	// came from the heap.
+	return (sizeof(Chunk *) + alignment - 1) & ~(alignment - 1);
+}
+
+int SerializableArena::chunkHeaderSize()
+{
+	return (sizeof(Chunk) + alignment - 1) & ~(alignment - 1);
+}
+
+char *SerializableArena::chunkData(Chunk *chunk)
+{
+	return reinterpret_cast<char *>(chunk) + chunkHeaderSize();
+}
+
+void *SerializableArena::allocate(size_t size)
+{
+	const int totalSize = headerSize() + ((size + alignment - 1) & ~(alignment - 1));
+	SerializableArena *arena = current();
+	Chunk *chunk = 0;
+	char *memory;
+	if (arena && (totalSize <= chunkSize / 4))
+		memory = arena->allocateFromChunk(totalSize, chunk);
+	else {
+		if (arena)
+			++arena->heapAllocationCount;
+		memory = static_cast<char *>(::operator new(totalSize));
+	}
+	*reinterpret_cast<Chunk **>(memory) = chunk;
+	return memory + headerSize();
+}
+
+void SerializableArena::release(void *ptr)
+{
+	if (!ptr)
+		return;
+	char *memory = static_cast<char *>(ptr) - headerSize();
+	Chunk *chunk = *reinterpret_cast<Chunk **>(memory);
+	if (!chunk) {
+		::operator delete(memory);
+		return;
+	}
+	Q_ASSERT(!chunk->arena || (chunk->arena->ownerThread == QThread::currentThread()));
+	if (!--chunk->liveCount && chunk->retired) {
+		if (chunk->arena)
+			chunk->arena->recycleChunk(chunk);
+		else
+			::operator delete(chunk);
+	}
+}
+
+char *SerializableArena::allocateFromChunk(int size, Chunk *&chunk)
+{
+	if (activeChunks.isEmpty() || (activeChunks.last()->used + size > chunkSize)) {
+		Chunk *newChunk;
+		if (freeChunks.isEmpty()) {
+			newChunk = static_cast<Chunk *>(::operator new(chunkHeaderSize() + chunkSize));
+			newChunk->arena = this;
+			newChunk->used = 0;
+			newChunk->liveCount = 0;
+			newChunk->retired = false;
+		} else
+			newChunk = freeChunks.takeLast();
+		activeChunks.append(newChunk);
+	}
+	chunk = activeChunks.last();
+	char *memory = chunkData(chunk) + chunk->used;
+	chunk->used += size;
+	++chunk->liveCount;
+	++allocationCount;
+	return memory;
+}
+
+void SerializableArena::recycleChunk(Chunk *chunk)
+{
+	retiredChunks.remove(chunk);
+	chunk->retired = false;
+	chunk->used = 0;
+	if (freeChunks.size() < maxFreeChunks)
+		freeChunks.append(chunk);
+	else
+		::operator delete(chunk);
+}
+
+void SerializableArena::reset()
+{
+	for (int i = 0; i < activeChunks.size(); ++i) {
+		Chunk *chunk = activeChunks[i];
+		if (chunk->liveCount) {
+			chunk->retired = true;
+			retiredChunks.insert(chunk);
+		} else
+			recycleChunk(chunk);
+	}
+	activeChunks.clear();
+}
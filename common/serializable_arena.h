@@ -0,0 +1,82 @@
+#ifndef SERIALIZABLE_ARENA_H
+#define SERIALIZABLE_ARENA_H
+
+#include <QList>
+#include <QSet>
+#include <QThreadStorage>
+#include <stddef.h>
+
+class QThread;
+
+// Bump allocator for the protocol items created while one command container is
+// being processed. While a Scope is active, SerializableItem's operator new
+// takes memory from the arena, and deleting such an item only decrements the
+// live count of its chunk. When the outermost Scope ends, all chunks without
+// live items are rewound at once. Chunks that still hold items which outlived
+// the command are retired and reused once their last item has been deleted.
+//
+// An arena belongs to the thread that created it. Scopes may only be opened
+// there, and items allocated from its chunks may only be deleted there, as
+// neither the chunk counts nor the chunk lists are locked. Items allocated
+// while no arena is active come from the heap and may be deleted anywhere.
+class SerializableArena {
+	Q_DISABLE_COPY(SerializableArena)
+public:
+	class Scope {
+	private:
+		SerializableArena *arena, *previous;
+	public:
+		Scope(SerializableArena *_arena);
+		~Scope();
+	};
+	// Items that are kept beyond the current command should be created
+	// with the arena suspended, so that they don't pin a chunk.
+	class Suspend {
+	private:
+		SerializableArena *previous;
+	public:
+		Suspend() : previous(current()) { current() = 0; }
+		~Suspend() { current() = previous; }
+	};
+private:
+	struct Chunk {
+		SerializableArena *arena;
+		int used;
+		int liveCount;
+		bool retired;
+	};
+	static const int chunkSize = 32768;
+	static const int maxFreeChunks = 16;
+	static const int alignment = 16;
+	// The active arena is tracked per thread, since protocol items are also
+	// created outside the server's thread (e.g. by the client's network thread).
+	static QThreadStorage<SerializableArena **> currentStorage;
+	static SerializableArena *&current();
+	
+	QThread *ownerThread;
+	QList<Chunk *> activeChunks, freeChunks;
+	QSet<Chunk *> retiredChunks;
+	int scopeDepth;
+	qint64 allocationCount, heapAllocationCount;
+	
+	static int headerSize();
+	static int chunkHeaderSize();
+	static char *chunkData(Chunk *chunk);
+	char *allocateFromChunk(int size, Chunk *&chunk);
+	void recycleChunk(Chunk *chunk);
+	void reset();
+public:
+	SerializableArena();
+	~SerializableArena();
+	static void *allocate(size_t size);
+	static void release(void *ptr);
+	
+	qint64 getAllocationCount() const { return allocationCount; }
+	qint64 getHeapAllocationCount() const { return heapAllocationCount; }
+	qint64 getTotalAllocationCount() const { return allocationCount + heapAllocationCount; }
+	int getChunkCount() const { return activeChunks.size() + freeChunks.size() + retiredChunks.size(); }
+	int getRetiredChunkCount() const { return retiredChunks.size(); }
+	void resetStatistics() { allocationCount = heapAllocationCount = 0; }
+};
+
+#endif
@@ -79,6 +79,17 @@ void SerializableItem_Map::writeElement(QXmlStreamWriter *xml)
 		itemList[i]->write(xml);
 }
 
+void SerializableItem_Map::moveItemToThread(QThread *thread)
+{
+	moveToThread(thread);
+	QMapIterator<QString, SerializableItem *> mapIterator(itemMap);
+	while (mapIterator.hasNext())
+		mapIterator.next().value()->moveItemToThread(thread);
+	for (int i = 0; i < itemList.size(); ++i)
+		if (itemList[i])
+			itemList[i]->moveItemToThread(thread);
+}
+
 bool SerializableItem_String::readElement(QXmlStreamReader *xml)
 {
 	// This function is sometimes called multiple times if there are
@@ -94,6 +105,75 @@ void SerializableItem_String::writeElement(QXmlStreamWriter *xml)
 	xml->writeCharacters(data);
 }
 
+int CardNameDictionary::addName(const QString &name)
+{
+	if (names.size() >= maxSize)
+		return -1;
+	const int id = names.size();
+	names.append(name);
+	nameToId.insert(name, id);
+	return id;
+}
+
+void CardNameDictionary::setName(int id, const QString &name)
+{
+	// Ids are handed out in order, so a new one always extends the table.
+	if (id < names.size()) {
+		nameToId.remove(names[id]);
+		names[id] = name;
+	} else if (id == names.size())
+		names.append(name);
+	else
+		return;
+	nameToId.insert(name, id);
+}
+
+QThreadStorage<SerializableItem_CardName::Dictionaries *> SerializableItem_CardName::dictionaryStorage;
+
+SerializableItem_CardName::Dictionaries &SerializableItem_CardName::dictionaries()
+{
+	if (!dictionaryStorage.hasLocalData())
+		dictionaryStorage.setLocalData(new Dictionaries);
+	return *dictionaryStorage.localData();
+}
+
+bool SerializableItem_CardName::readElement(QXmlStreamReader *xml)
+{
+	if (xml->isStartElement()) {
+		bool ok;
+		id = xml->attributes().value("id").toString().toInt(&ok);
+		if (!ok)
+			id = -1;
+	} else if (xml->isCharacters() && !xml->isWhitespace())
+		data.append(xml->text().toString());
+	else if (xml->isEndElement() && (id != -1)) {
+		CardNameDictionary *readDictionary = dictionaries().read;
+		if (readDictionary) {
+			if (data.isEmpty())
+				data = readDictionary->getName(id);
+			else
+				readDictionary->setName(id, data);
+		}
+	}
+	return SerializableItem::readElement(xml);
+}
+
+void SerializableItem_CardName::writeElement(QXmlStreamWriter *xml)
+{
+	CardNameDictionary *writeDictionary = dictionaries().write;
+	if (writeDictionary) {
+		int nameId = writeDictionary->getId(data);
+		if (nameId != -1) {
+			xml->writeAttribute("id", QString::number(nameId));
+			return;
+		}
+		nameId = writeDictionary->addName(data);
+		if (nameId != -1)
+			xml->writeAttribute("id", QString::number(nameId));
+	}
+	xml->writeCharacters(data);
+}
+
 bool SerializableItem_Int::readElement(QXmlStreamReader *xml)
 {
 	if (xml->isCharacters() && !xml->isWhitespace()) {
@@ -154,13 +234,15 @@ void SerializableItem_DateTime::writeElement(QXmlStreamWriter *xml)
 
 bool SerializableItem_ByteArray::readElement(QXmlStreamReader *xml)
 {
-	if (xml->isCharacters() && !xml->isWhitespace())
+	if (xml->isCharacters() && !xml->isWhitespace()) {
 		data = qUncompress(QByteArray::fromBase64(xml->text().toString().toAscii()));
+		compressed = false;
+	}
 	
 	return SerializableItem::readElement(xml);
 }
 
 void SerializableItem_ByteArray::writeElement(QXmlStreamWriter *xml)
 {
-	xml->writeCharacters(QString(qCompress(data).toBase64()));
+	xml->writeCharacters(QString((compressed ? data : qCompress(data)).toBase64()));
 }
@@ -6,8 +6,11 @@
 #include <QMap>
 #include <QList>
 #include <QHash>
+#include <QStringList>
 #include <QDateTime>
+#include <QThreadStorage>
 #include "color.h"
+#include "serializable_arena.h"
 
 class QXmlStreamReader;
 class QXmlStreamWriter;
@@ -23,6 +26,8 @@ protected:
 public:
 	SerializableItem(const QString &_itemType, const QString &_itemSubType = QString())
 		: QObject(), itemType(_itemType), itemSubType(_itemSubType), firstItem(true) { }
+	static void *operator new(size_t size) { return SerializableArena::allocate(size); }
+	static void operator delete(void *ptr) { SerializableArena::release(ptr); }
 	static void registerSerializableItem(const QString &name, NewItemFunction func);
 	static SerializableItem *getNewItem(const QString &name);
 	const QString &getItemType() const { return itemType; }
@@ -31,6 +36,9 @@ public:
 	virtual void writeElement(QXmlStreamWriter *xml) = 0;
 	virtual bool isEmpty() const = 0;
 	void write(QXmlStreamWriter *xml);
+	// Child items are not QObject children, so QObject::moveToThread()
+	// would leave them behind.
+	virtual void moveItemToThread(QThread *thread) { moveToThread(thread); }
 };
 
 class SerializableItem_Invalid : public SerializableItem {
@@ -71,6 +79,7 @@ public:
 	void writeElement(QXmlStreamWriter *xml);
 	bool isEmpty() const { return itemMap.isEmpty() && itemList.isEmpty(); }
 	void appendItem(SerializableItem *item) { itemList.append(item); }
+	void moveItemToThread(QThread *thread);
 };
 
 class SerializableItem_String : public SerializableItem {
@@ -87,6 +96,49 @@ public:
 	bool isEmpty() const { return data.isEmpty(); }
 };
 
+// Card names are sent once per connection. The first occurrence of a name is
+// written with a new id, later ones only carry the id. The reader builds the
+// same table while parsing, so custom token names work just like real cards.
+class CardNameDictionary {
+private:
+	static const int maxSize = 4096;
+	QHash<QString, int> nameToId;
+	QStringList names;
+public:
+	int size() const { return names.size(); }
+	int getId(const QString &name) const { return nameToId.value(name, -1); }
+	QString getName(int id) const { return names.value(id); }
+	int addName(const QString &name);
+	void setName(int id, const QString &name);
+	void clear() { nameToId.clear(); names.clear(); }
+};
+
+class SerializableItem_CardName : public SerializableItem {
+private:
+	// The dictionaries are set per thread, since the client parses incoming
+	// items in its network thread while the GUI thread writes commands.
+	struct Dictionaries {
+		CardNameDictionary *read, *write;
+		Dictionaries() : read(0), write(0) { }
+	};
+	static QThreadStorage<Dictionaries *> dictionaryStorage;
+	static Dictionaries &dictionaries();
+	QString data;
+	int id;
+protected:
+	bool readElement(QXmlStreamReader *xml);
+	void writeElement(QXmlStreamWriter *xml);
+public:
+	SerializableItem_CardName(const QString &_itemType, const QString &_data)
+		: SerializableItem(_itemType), data(_data), id(-1) { }
+	// Without a dictionary, names are read and written as plain strings.
+	static void setReadDictionary(CardNameDictionary *_readDictionary) { dictionaries().read = _readDictionary; }
+	static void setWriteDictionary(CardNameDictionary *_writeDictionary) { dictionaries().write = _writeDictionary; }
+	const QString &getData() { return data; }
+	void setData(const QString &_data) { data = _data; }
+	bool isEmpty() const { return data.isEmpty(); }
+};
+
 class SerializableItem_Int : public SerializableItem {
 private:
 	int data;
@@ -146,12 +198,14 @@ public:
 class SerializableItem_ByteArray : public SerializableItem {
 private:
 	QByteArray data;
+	bool compressed;
 protected:
 	bool readElement(QXmlStreamReader *xml);
 	void writeElement(QXmlStreamWriter *xml);
 public:
-	SerializableItem_ByteArray(const QString &_itemType, const QByteArray &_data)
-		: SerializableItem(_itemType), data(_data) { }
+	// If _compressed is set, _data already holds the output of qCompress() and is written as is.
+	SerializableItem_ByteArray(const QString &_itemType, const QByteArray &_data, bool _compressed = false)
+		: SerializableItem(_itemType), data(_data), compressed(_compressed) { }
 	const QByteArray &getData() { return data; }
 	void setData(const QByteArray &_data) { data = _data; }
 	bool isEmpty() const { return data.isEmpty(); }
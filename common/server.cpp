@@ -22,18 +22,30 @@
 #include "server_counter.h"
 #include "server_room.h"
 #include "server_protocolhandler.h"
+#include "server_presence.h"
+#include "server_timerwheel.h"
+#include "serializable_arena.h"
 #include "protocol_datastructures.h"
 #include <QDebug>
 
 Server::Server(QObject *parent)
 	: QObject(parent), nextGameId(0)
 {
+	presence = new Server_Presence(this);
+	// Drives all inactivity timeouts and game pings at a granularity of one second.
+	timerWheel = new Server_TimerWheel(1000, this);
+	commandArena = new SerializableArena;
 }
 
 Server::~Server()
 {
 	while (!clients.isEmpty())
 		delete clients.takeFirst();
+	// Games release their avatars when they are destroyed, so they have to
+	// go before the avatar cache does.
+	qDeleteAll(rooms);
+	rooms.clear();
+	delete commandArena;
 }
 
 AuthenticationResult Server::loginUser(Server_ProtocolHandler *session, QString &name, const QString &password)
@@ -59,12 +71,7 @@ AuthenticationResult Server::loginUser(Server_ProtocolHandler *session, QString
 	session->setUserInfo(data);
 	
 	users.insert(name, session);
-	
-	Event_UserJoined *event = new Event_UserJoined(new ServerInfo_User(data));
-	for (int i = 0; i < clients.size(); ++i)
-		if (clients[i]->getAcceptsUserListChanges())
-			clients[i]->sendProtocolItem(event, false);
-	delete event;
+	presence->userChanged(name);
 	
 	return authState;
 }
@@ -79,17 +86,51 @@ void Server::removeClient(Server_ProtocolHandler *client)
 	clients.removeAt(clients.indexOf(client));
 	ServerInfo_User *data = client->getUserInfo();
 	if (data) {
-		Event_UserLeft *event = new Event_UserLeft(data->getName());
-		for (int i = 0; i < clients.size(); ++i)
-			if (clients[i]->getAcceptsUserListChanges())
-				clients[i]->sendProtocolItem(event, false);
-		delete event;
-		
 		users.remove(data->getName());
+		presence->userChanged(data->getName());
+		releaseAvatar(data->getAvatarHash());
 	}
 	qDebug() << "Server::removeClient: " << clients.size() << "clients; " << users.size() << "users left";
 }
 
+QString Server::storeAvatar(const QByteArray &avatarBmp)
+{
+	// Avatars are kept compressed once per distinct image and shared between
+	// all sessions referring to them. The user info only carries the hash.
+	const QString avatarHash = ServerInfo_User::calculateAvatarHash(avatarBmp);
+	if (avatarHash.isEmpty())
+		return avatarHash;
+	
+	AvatarCacheEntry &entry = avatars[avatarHash];
+	if (entry.compressedData.isEmpty())
+		entry.compressedData = qCompress(avatarBmp);
+	acquireAvatar(avatarHash);
+	
+	return avatarHash;
+}
+
+void Server::acquireAvatar(const QString &avatarHash)
+{
+	QHash<QString, AvatarCacheEntry>::iterator i = avatars.find(avatarHash);
+	if (i == avatars.end())
+		return;
+	if (!i.value().refCount++)
+		unreferencedAvatars.removeAll(avatarHash);
+}
+
+void Server::releaseAvatar(const QString &avatarHash)
+{
+	QHash<QString, AvatarCacheEntry>::iterator i = avatars.find(avatarHash);
+	if ((i == avatars.end()) || !i.value().refCount)
+		return;
+	if (--i.value().refCount)
+		return;
+	
+	unreferencedAvatars.append(avatarHash);
+	if (unreferencedAvatars.size() > maxUnreferencedAvatars)
+		avatars.remove(unreferencedAvatars.takeFirst());
+}
+
 Server_Game *Server::getGame(int gameId) const
 {
 	return games.value(gameId);
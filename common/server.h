@@ -4,10 +4,14 @@
 #include <QObject>
 #include <QStringList>
 #include <QMap>
+#include <QHash>
 
 class Server_Game;
 class Server_Room;
 class Server_ProtocolHandler;
+class Server_Presence;
+class Server_TimerWheel;
+class SerializableArena;
 class ServerInfo_User;
 
 enum AuthenticationResult { PasswordWrong = 0, PasswordRight = 1, UnknownUser = 2 };
@@ -15,8 +19,6 @@ enum AuthenticationResult { PasswordWrong = 0, PasswordRight = 1, UnknownUser =
 class Server : public QObject
 {
 	Q_OBJECT
-signals:
-	void pingClockTimeout();
 private slots:
 	void gameCreated(Server_Game *game);
 	void gameClosing(int gameId);
@@ -31,21 +33,46 @@ public:
 	int getNextGameId() { return nextGameId++; }
 	
 	const QMap<QString, Server_ProtocolHandler *> &getUsers() const { return users; }
+	const QList<Server_ProtocolHandler *> &getClients() const { return clients; }
+	Server_Presence *getPresence() const { return presence; }
+	Server_TimerWheel *getTimerWheel() const { return timerWheel; }
+	SerializableArena *getCommandArena() const { return commandArena; }
 	void addClient(Server_ProtocolHandler *player);
 	void removeClient(Server_ProtocolHandler *player);
 	virtual QString getLoginMessage() const = 0;
 	
+	QByteArray getCompressedAvatar(const QString &avatarHash) const { return avatars.value(avatarHash).compressedData; }
+	// Everything holding on to a user info for longer than a response
+	// (sessions, games, players) keeps a reference to its avatar.
+	void acquireAvatar(const QString &avatarHash);
+	void releaseAvatar(const QString &avatarHash);
+	
 	virtual bool getGameShouldPing() const = 0;
 	virtual int getMaxGameInactivityTime() const = 0;
 	virtual int getMaxPlayerInactivityTime() const = 0;
+private:
+	struct AvatarCacheEntry {
+		QByteArray compressedData;
+		int refCount;
+		AvatarCacheEntry() : refCount(0) { }
+	};
+	QHash<QString, AvatarCacheEntry> avatars;
+	// Clients may still ask for an avatar after the last reference to it is
+	// gone, so a few unreferenced ones are kept around.
+	static const int maxUnreferencedAvatars = 32;
+	QList<QString> unreferencedAvatars;
 protected:
 	QMap<int, Server_Game *> games;
 	QList<Server_ProtocolHandler *> clients;
 	QMap<QString, Server_ProtocolHandler *> users;
 	QMap<int, Server_Room *> rooms;
+	Server_Presence *presence;
+	Server_TimerWheel *timerWheel;
+	SerializableArena *commandArena;
 	
 	virtual AuthenticationResult checkUserPassword(const QString &user, const QString &password) = 0;
 	virtual ServerInfo_User *getUserData(const QString &name) = 0;
+	QString storeAvatar(const QByteArray &avatarBmp);
 	int nextGameId;
 	void addRoom(Server_Room *newRoom);
 };
@@ -1,10 +1,14 @@
 #ifndef SERVER_ARROWTARGET_H
 #define SERVER_ARROWTARGET_H
 
-#include <QObject>
-
-class Server_ArrowTarget : public QObject {
-	Q_OBJECT
+class Server_ArrowTarget {
+public:
+	enum ArrowTargetType { CardTarget, PlayerTarget };
+private:
+	ArrowTargetType arrowTargetType;
+public:
+	Server_ArrowTarget(ArrowTargetType _arrowTargetType) : arrowTargetType(_arrowTargetType) { }
+	ArrowTargetType getArrowTargetType() const { return arrowTargetType; }
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -19,29 +19,75 @@
  ***************************************************************************/
 #include "server_card.h"
 
-Server_Card::Server_Card(QString _name, int _id, int _coord_x, int _coord_y)
-	: id(_id), coord_x(_coord_x), coord_y(_coord_y), name(_name), tapped(false), attacking(false), facedown(false), color(QString()), pt(QString()), annotation(QString()), destroyOnZoneChange(false), doesntUntap(false), parentCard(0)
+QSet<QString> Server_Card::nameTable;
+int Server_Card::nameTablePurgeSize = 1024;
+const QMap<int, int> Server_Card::noCounters;
+const QList<Server_Card *> Server_Card::noAttachedCards;
+
+Server_Card::Server_Card(const QString &_name, int _id, int _coord_x, int _coord_y)
+	: Server_ArrowTarget(CardTarget), zone(0), parentCard(0), extra(0), name(internName(_name)), id(_id), coord_x(_coord_x), coord_y(_coord_y), tapped(false), attacking(false), facedown(false), destroyOnZoneChange(false), doesntUntap(false)
 {
 }
 
-
 Server_Card::~Server_Card()
 {
 	// setParentCard(0) leads to the item being removed from our list, so we can't iterate properly
-	while (!attachedCards.isEmpty())
-		attachedCards.first()->setParentCard(0);
+	while (extra && !extra->attachedCards.isEmpty())
+		extra->attachedCards.first()->setParentCard(0);
 	
 	if (parentCard)
 		parentCard->removeAttachedCard(this);
+	delete extra;
+}
+
+QString Server_Card::internName(const QString &name)
+{
+	QSet<QString>::const_iterator i = nameTable.constFind(name);
+	if (i != nameTable.constEnd())
+		return *i;
+	
+	if (nameTable.size() >= nameTablePurgeSize)
+		purgeNameTable();
+	nameTable.insert(name);
+	return name;
+}
+
+void Server_Card::purgeNameTable()
+{
+	// Names that are only referenced by the table itself belong to
+	// cards that no longer exist.
+	QMutableSetIterator<QString> i(nameTable);
+	while (i.hasNext())
+		if (i.next().isDetached())
+			i.remove();
+	nameTablePurgeSize = qMax(1024, nameTable.size() * 2);
+}
+
+Server_Card::ExtraData *Server_Card::getExtra()
+{
+	if (!extra)
+		extra = new ExtraData;
+	return extra;
+}
+
+void Server_Card::releaseExtraIfEmpty()
+{
+	if (extra && extra->counters.isEmpty() && extra->color.isEmpty() && extra->pt.isEmpty() && extra->annotation.isEmpty() && extra->attachedCards.isEmpty()) {
+		delete extra;
+		extra = 0;
+	}
 }
 
 void Server_Card::resetState()
 {
-	counters.clear();
+	if (extra) {
+		extra->counters.clear();
+		extra->pt.clear();
+		extra->annotation.clear();
+		releaseExtraIfEmpty();
+	}
 	setTapped(false);
 	setAttacking(false);
-	setPT(QString());
-	setAnnotation(QString());
 	setDoesntUntap(false);
 }
 
@@ -72,9 +118,35 @@ bool Server_Card::setAttribute(const QString &aname, const QString &avalue, bool
 void Server_Card::setCounter(int id, int value)
 {
 	if (value)
-		counters.insert(id, value);
-	else
-		counters.remove(id);
+		getExtra()->counters.insert(id, value);
+	else if (extra) {
+		extra->counters.remove(id);
+		releaseExtraIfEmpty();
+	}
+}
+
+void Server_Card::setColor(const QString &_color)
+{
+	if (_color.isEmpty() && !extra)
+		return;
+	getExtra()->color = _color;
+	releaseExtraIfEmpty();
+}
+
+void Server_Card::setPT(const QString &_pt)
+{
+	if (_pt.isEmpty() && !extra)
+		return;
+	getExtra()->pt = _pt;
+	releaseExtraIfEmpty();
+}
+
+void Server_Card::setAnnotation(const QString &_annotation)
+{
+	if (_annotation.isEmpty() && !extra)
+		return;
+	getExtra()->annotation = _annotation;
+	releaseExtraIfEmpty();
 }
 
 void Server_Card::setParentCard(Server_Card *_parentCard)
@@ -85,3 +157,11 @@ void Server_Card::setParentCard(Server_Card *_parentCard)
 	if (parentCard)
 		parentCard->addAttachedCard(this);
 }
+
+void Server_Card::removeAttachedCard(Server_Card *card)
+{
+	if (!extra)
+		return;
+	extra->attachedCards.removeAt(extra->attachedCards.indexOf(card));
+	releaseExtraIfEmpty();
+}
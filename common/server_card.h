@@ -23,31 +23,50 @@
 #include "server_arrowtarget.h"
 #include <QString>
 #include <QMap>
+#include <QSet>
+#include <QList>
 
 class Server_CardZone;
 
+// Cards are plain records allocated from their game's Server_CardPool.
+// Names are interned server-wide, and state that most cards never have
+// (counters, color, P/T, annotation, attachments) lives in a separately
+// allocated block that only exists while it is non-empty.
 class Server_Card : public Server_ArrowTarget {
-	Q_OBJECT
+	Q_DISABLE_COPY(Server_Card)
 private:
+	struct ExtraData {
+		QMap<int, int> counters;
+		QString color;
+		QString pt;
+		QString annotation;
+		QList<Server_Card *> attachedCards;
+	};
+	static QSet<QString> nameTable;
+	static int nameTablePurgeSize;
+	static const QMap<int, int> noCounters;
+	static const QList<Server_Card *> noAttachedCards;
+	static QString internName(const QString &name);
+	static void purgeNameTable();
+	
 	Server_CardZone *zone;
+	Server_Card *parentCard;
+	ExtraData *extra;
+	QString name;
 	int id;
 	int coord_x, coord_y;
-	QString name;
-	QMap<int, int> counters;
-	bool tapped;
-	bool attacking;
-	bool facedown;
-	QString color;
-	QString pt;
-	QString annotation;
-	bool destroyOnZoneChange;
-	bool doesntUntap;
+	bool tapped : 1;
+	bool attacking : 1;
+	bool facedown : 1;
+	bool destroyOnZoneChange : 1;
+	bool doesntUntap : 1;
 	
-	Server_Card *parentCard;
-	QList<Server_Card *> attachedCards;
+	ExtraData *getExtra();
+	void releaseExtraIfEmpty();
 public:
-	Server_Card(QString _name, int _id, int _coord_x, int _coord_y);
+	Server_Card(const QString &_name, int _id, int _coord_x, int _coord_y);
 	~Server_Card();
+	static Server_Card *fromArrowTarget(Server_ArrowTarget *target) { return (target && (target->getArrowTargetType() == CardTarget)) ? static_cast<Server_Card *>(target) : 0; }
 	
 	Server_CardZone *getZone() const { return zone; }
 	void setZone(Server_CardZone *_zone) { zone = _zone; }
@@ -56,34 +75,34 @@ public:
 	int getX() const { return coord_x; }
 	int getY() const { return coord_y; }
 	QString getName() const { return name; }
-	const QMap<int, int> &getCounters() const { return counters; }
-	int getCounter(int id) const { return counters.value(id, 0); }
+	const QMap<int, int> &getCounters() const { return extra ? extra->counters : noCounters; }
+	int getCounter(int id) const { return extra ? extra->counters.value(id, 0) : 0; }
 	bool getTapped() const { return tapped; }
 	bool getAttacking() const { return attacking; }
 	bool getFaceDown() const { return facedown; }
-	QString getColor() const { return color; }
-	QString getPT() const { return pt; }
-	QString getAnnotation() const { return annotation; }
+	QString getColor() const { return extra ? extra->color : QString(); }
+	QString getPT() const { return extra ? extra->pt : QString(); }
+	QString getAnnotation() const { return extra ? extra->annotation : QString(); }
 	bool getDoesntUntap() const { return doesntUntap; }
 	bool getDestroyOnZoneChange() const { return destroyOnZoneChange; }
 	Server_Card *getParentCard() const { return parentCard; }
-	const QList<Server_Card *> &getAttachedCards() const { return attachedCards; }
+	const QList<Server_Card *> &getAttachedCards() const { return extra ? extra->attachedCards : noAttachedCards; }
 
 	void setId(int _id) { id = _id; }
 	void setCoords(int x, int y) { coord_x = x; coord_y = y; }
-	void setName(const QString &_name) { name = _name; }
+	void setName(const QString &_name) { name = internName(_name); }
 	void setCounter(int id, int value);
 	void setTapped(bool _tapped) { tapped = _tapped; }
 	void setAttacking(bool _attacking) { attacking = _attacking; }
 	void setFaceDown(bool _facedown) { facedown = _facedown; }
-	void setColor(const QString &_color) { color = _color; }
-	void setPT(const QString &_pt) { pt = _pt; }
-	void setAnnotation(const QString &_annotation) { annotation = _annotation; }
+	void setColor(const QString &_color);
+	void setPT(const QString &_pt);
+	void setAnnotation(const QString &_annotation);
 	void setDestroyOnZoneChange(bool _destroy) { destroyOnZoneChange = _destroy; }
 	void setDoesntUntap(bool _doesntUntap) { doesntUntap = _doesntUntap; }
 	void setParentCard(Server_Card *_parentCard);
-	void addAttachedCard(Server_Card *card) { attachedCards.append(card); }
-	void removeAttachedCard(Server_Card *card) { attachedCards.removeAt(attachedCards.indexOf(card)); }
+	void addAttachedCard(Server_Card *card) { getExtra()->attachedCards.append(card); }
+	void removeAttachedCard(Server_Card *card);
 	
 	void resetState();
 	bool setAttribute(const QString &aname, const QString &avalue, bool allCards);
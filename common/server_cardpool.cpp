@@ -0,0 +1,36 @@
+#include "server_cardpool.h"
+#include <new>
+#include <QDebug>
+
+Server_CardPool::~Server_CardPool()
+{
+	if (cardCount)
+		qDebug() << "Server_CardPool destructor:" << cardCount << "cards still allocated";
+	for (int i = 0; i < blocks.size(); ++i)
+		delete[] blocks[i];
+}
+
+Server_Card *Server_CardPool::newCard(const QString &name, int id, int x, int y)
+{
+	if (!freeList) {
+		Slot *block = new Slot[blockSize];
+		blocks.append(block);
+		for (int i = blockSize - 1; i >= 0; --i) {
+			block[i].next = freeList;
+			freeList = &block[i];
+		}
+	}
+	Slot *slot = freeList;
+	freeList = slot->next;
+	++cardCount;
+	return new (slot->storage) Server_Card(name, id, x, y);
+}
+
+void Server_CardPool::deleteCard(Server_Card *card)
+{
+	card->~Server_Card();
+	Slot *slot = reinterpret_cast<Slot *>(card);
+	slot->next = freeList;
+	freeList = slot;
+	--cardCount;
+}
@@ -0,0 +1,30 @@
+#ifndef SERVER_CARDPOOL_H
+#define SERVER_CARDPOOL_H
+
+#include <QList>
+#include "server_card.h"
+
+// Allocates the cards of one game from blocks of fixed size slots. Freed
+// slots are recycled through a free list; the blocks are only returned to
+// the system together with the game.
+class Server_CardPool {
+	Q_DISABLE_COPY(Server_CardPool)
+private:
+	static const int blockSize = 128;
+	union Slot {
+		Slot *next;
+		void *alignment;
+		char storage[sizeof(Server_Card)];
+	};
+	QList<Slot *> blocks;
+	Slot *freeList;
+	int cardCount;
+public:
+	Server_CardPool() : freeList(0), cardCount(0) { }
+	~Server_CardPool();
+	int getCardCount() const { return cardCount; }
+	Server_Card *newCard(const QString &name, int id, int x, int y);
+	void deleteCard(Server_Card *card);
+};
+
+#endif
@@ -20,12 +20,13 @@
 #include "server_cardzone.h"
 #include "server_card.h"
 #include "server_player.h"
+#include "server_game.h"
 #include "rng_abstract.h"
 #include <QSet>
 #include <QDebug>
 
 Server_CardZone::Server_CardZone(Server_Player *_player, const QString &_name, bool _has_coords, ZoneType _type)
-	: player(_player), name(_name), has_coords(_has_coords), type(_type), cardsBeingLookedAt(0)
+	: player(_player), name(_name), zoneId(ZoneNames::getZoneId(_name)), has_coords(_has_coords), type(_type), cardsBeingLookedAt(0)
 {
 }
 
@@ -203,6 +204,6 @@ void Server_CardZone::insertCard(Server_Card *card, int x, int y)
 void Server_CardZone::clear()
 {
 	for (int i = 0; i < cards.size(); i++)
-		delete cards.at(i);
+		player->getGame()->getCardPool()->deleteCard(cards.at(i));
 	cards.clear();
 }
@@ -33,6 +33,7 @@ class Server_CardZone {
 private:
 	Server_Player *player;
 	QString name;
+	ZoneId zoneId;
 	bool has_coords;
 	ZoneType type;
 	int cardsBeingLookedAt;
@@ -48,6 +49,7 @@ public:
 	bool hasCoords() const { return has_coords; }
 	ZoneType getType() const { return type; }
 	QString getName() const { return name; }
+	ZoneId getZoneId() const { return zoneId; }
 	Server_Player *getPlayer() const { return player; }
 	
 	int getFreeGridColumn(int x, int y, const QString &cardName) const;
@@ -25,18 +25,18 @@
 #include "server_card.h"
 #include "server_cardzone.h"
 #include "server_counter.h"
-#include <QTimer>
+#include <QPair>
 #include <QDebug>
 
 Server_Game::Server_Game(Server_ProtocolHandler *_creator, int _gameId, const QString &_description, const QString &_password, int _maxPlayers, bool _spectatorsAllowed, bool _spectatorsNeedPassword, bool _spectatorsCanTalk, bool _spectatorsSeeEverything, Server_Room *parent)
 	: QObject(parent), creatorInfo(new ServerInfo_User(_creator->getUserInfo())), gameStarted(false), gameId(_gameId), description(_description), password(_password), maxPlayers(_maxPlayers), activePlayer(-1), activePhase(-1), spectatorsAllowed(_spectatorsAllowed), spectatorsNeedPassword(_spectatorsNeedPassword), spectatorsCanTalk(_spectatorsCanTalk), spectatorsSeeEverything(_spectatorsSeeEverything), inactivityCounter(0), secondsElapsed(0)
 {
+	parent->getServer()->acquireAvatar(creatorInfo->getAvatarHash());
 	addPlayer(_creator, false, false);
 
 	if (parent->getServer()->getGameShouldPing()) {
-		pingClock = new QTimer(this);
-		connect(pingClock, SIGNAL(timeout()), this, SLOT(pingClockTimeout()));
-		pingClock->start(1000);
+		pingTimer.setWheel(parent->getServer()->getTimerWheel(), this);
+		pingTimer.start(1);
 	}
 }
 
@@ -50,16 +50,35 @@ Server_Game::~Server_Game()
 	players.clear();
 	
 	emit gameClosing();
+	static_cast<Server_Room *>(parent())->getServer()->releaseAvatar(creatorInfo->getAvatarHash());
 	delete creatorInfo;
 	qDebug("Server_Game destructor");
 }
 
-void Server_Game::pingClockTimeout()
+int Server_Game::getPingBucket(int pingTime)
 {
+	if (pingTime == -1)
+		return -1;
+	else if (pingTime <= 2)
+		return 0;
+	else if (pingTime <= 5)
+		return 1;
+	else if (pingTime <= 10)
+		return 2;
+	else
+		return 3;
+}
+
+void Server_Game::wheelTimerExpired(Server_WheelTimer * /*timer*/)
+{
+	pingTimer.start(1);
 	++secondsElapsed;
 	
+	// Clients keep track of the elapsed time themselves, so the ping event is
+	// only needed when the latency of a player has moved to another bucket.
 	QDateTime now = QDateTime::currentDateTime();
-	QList<ServerInfo_PlayerPing *> pingList;
+	QList<QPair<int, int> > pingTimes;
+	bool pingBucketChanged = false;
 	QMapIterator<int, Server_Player *> playerIterator(players);
 	bool allPlayersInactive = true;
 	while (playerIterator.hasNext()) {
@@ -70,9 +89,20 @@ void Server_Game::pingClockTimeout()
 			allPlayersInactive = false;
 		} else
 			pingTime = -1;
-		pingList.append(new ServerInfo_PlayerPing(player->getPlayerId(), pingTime));
+		pingTimes.append(QPair<int, int>(player->getPlayerId(), pingTime));
+		
+		const int pingBucket = getPingBucket(pingTime);
+		if (pingBucket != player->getPingBucket()) {
+			player->setPingBucket(pingBucket);
+			pingBucketChanged = true;
+		}
+	}
+	if (pingBucketChanged) {
+		QList<ServerInfo_PlayerPing *> pingList;
+		for (int i = 0; i < pingTimes.size(); ++i)
+			pingList.append(new ServerInfo_PlayerPing(pingTimes[i].first, pingTimes[i].second));
+		sendGameEvent(new Event_Ping(secondsElapsed, pingList));
 	}
-	sendGameEvent(new Event_Ping(secondsElapsed, pingList));
 	
 	const int maxTime = static_cast<Server_Room *>(parent())->getServer()->getMaxGameInactivityTime();
 	if (allPlayersInactive) {
@@ -213,11 +243,11 @@ void Server_Game::removePlayer(Server_Player *player)
 		QList<Server_Arrow *> toDelete;
 		for (int i = 0; i < arrows.size(); ++i) {
 			Server_Arrow *a = arrows[i];
-			Server_Card *targetCard = qobject_cast<Server_Card *>(a->getTargetItem());
+			Server_Card *targetCard = Server_Card::fromArrowTarget(a->getTargetItem());
 			if (targetCard) {
 				if (targetCard->getZone()->getPlayer() == player)
 					toDelete.append(a);
-			} else if ((static_cast<Server_Player *>(a->getTargetItem()) == player) || (a->getStartCard()->getZone()->getPlayer() == player))
+			} else if ((Server_Player::fromArrowTarget(a->getTargetItem()) == player) || (a->getStartCard()->getZone()->getPlayer() == player))
 				toDelete.append(a);
 		}
 		for (int i = 0; i < toDelete.size(); ++i) {
@@ -287,7 +317,7 @@ QList<ServerInfo_Player *> Server_Game::getGameState(Server_Player *playerWhosAs
 		QMapIterator<int, Server_Arrow *> arrowIterator(player->getArrows());
 		while (arrowIterator.hasNext()) {
 			Server_Arrow *arrow = arrowIterator.next().value();
-			Server_Card *targetCard = qobject_cast<Server_Card *>(arrow->getTargetItem());
+			Server_Card *targetCard = Server_Card::fromArrowTarget(arrow->getTargetItem());
 			if (targetCard)
 				arrowList.append(new ServerInfo_Arrow(
 					arrow->getId(),
@@ -305,7 +335,7 @@ QList<ServerInfo_Player *> Server_Game::getGameState(Server_Player *playerWhosAs
 					arrow->getStartCard()->getZone()->getPlayer()->getPlayerId(),
 					arrow->getStartCard()->getZone()->getName(),
 					arrow->getStartCard()->getId(),
-					qobject_cast<Server_Player *>(arrow->getTargetItem())->getPlayerId(),
+					Server_Player::fromArrowTarget(arrow->getTargetItem())->getPlayerId(),
 					QString(),
 					-1,
 					arrow->getColor()
@@ -320,9 +350,11 @@ QList<ServerInfo_Player *> Server_Game::getGameState(Server_Player *playerWhosAs
 		}
 
 		QList<ServerInfo_Zone *> zoneList;
-		QMapIterator<QString, Server_CardZone *> zoneIterator(player->getZones());
-		while (zoneIterator.hasNext()) {
-			Server_CardZone *zone = zoneIterator.next().value();
+		const QVector<Server_CardZone *> &zones = player->getZones();
+		for (int j = 0; j < zones.size(); ++j) {
+			Server_CardZone *zone = zones[j];
+			if (!zone)
+				continue;
 			QList<ServerInfo_Card *> cardList;
 			if (
 				(((playerWhosAsking == player) || (playerWhosAsking->getSpectator() && spectatorsSeeEverything)) && (zone->getType() != HiddenZone))
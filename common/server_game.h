@@ -25,12 +25,13 @@
 #include <QObject>
 #include "server_player.h"
 #include "protocol.h"
+#include "server_timerwheel.h"
+#include "server_cardpool.h"
 
-class QTimer;
 class Server_Room;
 class ServerInfo_User;
 
-class Server_Game : public QObject {
+class Server_Game : public QObject, public Server_TimerWheelListener {
 	Q_OBJECT
 private:
 	ServerInfo_User *creatorInfo;
@@ -47,14 +48,15 @@ private:
 	bool spectatorsSeeEverything;
 	int inactivityCounter;
 	int secondsElapsed;
-	QTimer *pingClock;
+	Server_WheelTimer pingTimer;
+	Server_CardPool cardPool;
+	static int getPingBucket(int pingTime);
 signals:
 	void gameClosing();
-private slots:
-	void pingClockTimeout();
 public:
 	Server_Game(Server_ProtocolHandler *_creator, int _gameId, const QString &_description, const QString &_password, int _maxPlayers, bool _spectatorsAllowed, bool _spectatorsNeedPassword, bool _spectatorsCanTalk, bool _spectatorsSeeEverything, Server_Room *parent);
 	~Server_Game();
+	void wheelTimerExpired(Server_WheelTimer *timer);
 	ServerInfo_Game *getInfo() const;
 	ServerInfo_User *getCreatorInfo() const { return creatorInfo; }
 	bool getGameStarted() const { return gameStarted; }
@@ -63,6 +65,7 @@ public:
 	const QMap<int, Server_Player *> &getPlayers() const { return players; }
 	Server_Player *getPlayer(int playerId) const { return players.value(playerId, 0); }
 	int getGameId() const { return gameId; }
+	Server_CardPool *getCardPool() { return &cardPool; }
 	QString getDescription() const { return description; }
 	QString getPassword() const { return password; }
 	int getMaxPlayers() const { return maxPlayers; }
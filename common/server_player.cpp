@@ -4,6 +4,8 @@
 #include "server_arrow.h"
 #include "server_cardzone.h"
 #include "server_game.h"
+#include "server_room.h"
+#include "server.h"
 #include "server_protocolhandler.h"
 #include "protocol.h"
 #include "protocol_items.h"
@@ -11,16 +13,19 @@
 #include <QDebug>
 
 Server_Player::Server_Player(Server_Game *_game, int _playerId, ServerInfo_User *_userInfo, bool _spectator, Server_ProtocolHandler *_handler)
-	: game(_game), handler(_handler), userInfo(new ServerInfo_User(_userInfo)), deck(0), playerId(_playerId), spectator(_spectator), nextCardId(0), readyStart(false), conceded(false), deckId(-2)
+	: Server_ArrowTarget(PlayerTarget), game(_game), handler(_handler), userInfo(new ServerInfo_User(_userInfo)), deck(0), playerId(_playerId), spectator(_spectator), nextCardId(0), readyStart(false), conceded(false), deckId(-2), pingBucket(-2)
 {
+	static_cast<Server_Room *>(game->parent())->getServer()->acquireAvatar(userInfo->getAvatarHash());
 }
 
 Server_Player::~Server_Player()
 {
+	clearZones();
 	delete deck;
 	
 	if (handler)
 		handler->playerRemovedFromGame(game);
+	static_cast<Server_Room *>(game->parent())->getServer()->releaseAvatar(userInfo->getAvatarHash());
 	delete userInfo;
 }
 
@@ -100,7 +105,7 @@ void Server_Player::setupZones()
 			if (!currentCard)
 				continue;
 			for (int k = 0; k < currentCard->getNumber(); ++k)
-				z->cards.append(new Server_Card(currentCard->getName(), nextCardId++, 0, 0));
+				z->cards.append(game->getCardPool()->newCard(currentCard->getName(), nextCardId++, 0, 0));
 		}
 	}
 	
@@ -136,10 +141,10 @@ void Server_Player::setupZones()
 
 void Server_Player::clearZones()
 {
-	QMapIterator<QString, Server_CardZone *> zoneIterator(zones);
-	while (zoneIterator.hasNext())
-		delete zoneIterator.next().value();
+	for (int i = 0; i < zones.size(); ++i)
+		delete zones[i];
 	zones.clear();
+	customZones.clear();
 
 	QMapIterator<int, Server_Counter *> counterIterator(counters);
 	while (counterIterator.hasNext())
@@ -166,7 +171,21 @@ void Server_Player::setDeck(DeckList *_deck, int _deckId)
 
 void Server_Player::addZone(Server_CardZone *zone)
 {
-	zones.insert(zone->getName(), zone);
+	if (zones.size() < StandardZoneCount)
+		zones.resize(StandardZoneCount);
+	ZoneId zoneId = zone->getZoneId();
+	if (zoneId == CustomZoneId) {
+		Server_CardZone *oldZone = customZones.value(zone->getName());
+		if (oldZone) {
+			zones[zones.indexOf(oldZone)] = zone;
+			delete oldZone;
+		} else
+			zones.append(zone);
+		customZones.insert(zone->getName(), zone);
+	} else {
+		delete zones[zoneId];
+		zones[zoneId] = zone;
+	}
 }
 
 void Server_Player::addArrow(Server_Arrow *arrow)
@@ -199,13 +218,13 @@ bool Server_Player::deleteCounter(int counterId)
 	return true;
 }
 
-ResponseCode Server_Player::moveCard(CommandContainer *cont, const QString &_startZone, const QList<int> &_cardIds, int targetPlayerId, const QString &_targetZone, int x, int y, bool faceDown, bool tapped)
+ResponseCode Server_Player::moveCard(CommandContainer *cont, const ZoneRef &_startZone, const QList<int> &_cardIds, int targetPlayerId, const ZoneRef &_targetZone, int x, int y, bool faceDown, bool tapped)
 {
-	Server_CardZone *startzone = getZones().value(_startZone);
+	Server_CardZone *startzone = getZone(_startZone);
 	Server_Player *targetPlayer = game->getPlayers().value(targetPlayerId);
 	if (!targetPlayer)
 		return RespNameNotFound;
-	Server_CardZone *targetzone = targetPlayer->getZones().value(_targetZone);
+	Server_CardZone *targetzone = targetPlayer->getZone(_targetZone);
 	if ((!startzone) || (!targetzone))
 		return RespNameNotFound;
 	
@@ -275,7 +294,7 @@ ResponseCode Server_Player::moveCard(CommandContainer *cont, Server_CardZone *st
 		int newX = x + xIndex;
 		
 		// Attachment relationships can be retained when moving a card onto the opponent's table
-		if (startzone->getName() != targetzone->getName()) {
+		if (startzone->getZoneId() != targetzone->getZoneId()) {
 			// Delete all attachment relationships
 			if (card->getParentCard())
 				card->setParentCard(0);
@@ -305,7 +324,7 @@ ResponseCode Server_Player::moveCard(CommandContainer *cont, Server_CardZone *st
 		if (card->getDestroyOnZoneChange() && (startzone != targetzone)) {
 			cont->enqueueGameEventPrivate(new Event_DestroyCard(getPlayerId(), startzone->getName(), card->getId()), game->getGameId());
 			cont->enqueueGameEventPublic(new Event_DestroyCard(getPlayerId(), startzone->getName(), card->getId()), game->getGameId());
-			card->deleteLater();
+			game->getCardPool()->deleteCard(card);
 		} else {
 			if (!targetzone->hasCoords()) {
 				y = 0;
@@ -386,9 +405,9 @@ void Server_Player::unattachCard(CommandContainer *cont, Server_Card *card)
 	moveCard(cont, zone, QList<int>() << card->getId(), zone, -1, card->getY(), card->getFaceDown(), card->getTapped());
 }
 
-ResponseCode Server_Player::setCardAttrHelper(CommandContainer *cont, const QString &zoneName, int cardId, const QString &attrName, const QString &attrValue)
+ResponseCode Server_Player::setCardAttrHelper(CommandContainer *cont, const ZoneRef &zoneRef, int cardId, const QString &attrName, const QString &attrValue)
 {
-	Server_CardZone *zone = getZones().value(zoneName);
+	Server_CardZone *zone = getZone(zoneRef);
 	if (!zone)
 		return RespNameNotFound;
 	if (!zone->hasCoords())
@@ -2,9 +2,12 @@
 #define PLAYER_H
 
 #include "server_arrowtarget.h"
+#include <QObject>
 #include <QString>
 #include <QList>
 #include <QMap>
+#include <QHash>
+#include <QVector>
 #include "protocol_datastructures.h"
 
 class DeckList;
@@ -19,7 +22,7 @@ class ServerInfo_User;
 class ServerInfo_PlayerProperties;
 class CommandContainer;
 
-class Server_Player : public Server_ArrowTarget {
+class Server_Player : public QObject, public Server_ArrowTarget {
 	Q_OBJECT
 private:
 	class MoveCardCompareFunctor;
@@ -27,7 +30,8 @@ private:
 	Server_ProtocolHandler *handler;
 	ServerInfo_User *userInfo;
 	DeckList *deck;
-	QMap<QString, Server_CardZone *> zones;
+	QVector<Server_CardZone *> zones;
+	QHash<QString, Server_CardZone *> customZones;
 	QMap<int, Server_Counter *> counters;
 	QMap<int, Server_Arrow *> arrows;
 	int playerId;
@@ -37,11 +41,16 @@ private:
 	bool readyStart;
 	bool conceded;
 	int deckId;
+	int pingBucket;
 public:
 	Server_Player(Server_Game *_game, int _playerId, ServerInfo_User *_userInfo, bool _spectator, Server_ProtocolHandler *_handler);
 	~Server_Player();
+	static Server_Player *fromArrowTarget(Server_ArrowTarget *target) { return (target && (target->getArrowTargetType() == PlayerTarget)) ? static_cast<Server_Player *>(target) : 0; }
+	Server_Game *getGame() const { return game; }
 	Server_ProtocolHandler *getProtocolHandler() const { return handler; }
 	void setProtocolHandler(Server_ProtocolHandler *_handler) { handler = _handler; }
+	int getPingBucket() const { return pingBucket; }
+	void setPingBucket(int _pingBucket) { pingBucket = _pingBucket; }
 	
 	void setPlayerId(int _id) { playerId = _id; }
 	int getInitialCards() const { return initialCards; }
@@ -56,7 +65,11 @@ public:
 	ServerInfo_User *getUserInfo() const { return userInfo; }
 	void setDeck(DeckList *_deck, int _deckId);
 	DeckList *getDeck() const { return deck; }
-	const QMap<QString, Server_CardZone *> &getZones() const { return zones; }
+	// The standard zones are indexed by ZoneId, custom zones follow them.
+	const QVector<Server_CardZone *> &getZones() const { return zones; }
+	Server_CardZone *getZone(ZoneId zoneId) const { return ((zoneId >= 0) && (zoneId < StandardZoneCount) && (zoneId < zones.size())) ? zones[zoneId] : 0; }
+	Server_CardZone *getZone(const ZoneRef &zone) const { return (zone.getId() == CustomZoneId) ? customZones.value(zone.getName()) : getZone(zone.getId()); }
+	Server_CardZone *getZone(const QString &zoneName) const { return getZone(ZoneRef(zoneName)); }
 	const QMap<int, Server_Counter *> &getCounters() const { return counters; }
 	const QMap<int, Server_Arrow *> &getArrows() const { return arrows; }
 
@@ -75,10 +88,10 @@ public:
 	void clearZones();
 	void setupZones();
 
-	ResponseCode moveCard(CommandContainer *cont, const QString &_startZone, const QList<int> &_cardId, int _targetPlayer, const QString &_targetZone, int _x, int _y, bool _faceDown, bool _tapped);
+	ResponseCode moveCard(CommandContainer *cont, const ZoneRef &_startZone, const QList<int> &_cardId, int _targetPlayer, const ZoneRef &_targetZone, int _x, int _y, bool _faceDown, bool _tapped);
 	ResponseCode moveCard(CommandContainer *cont, Server_CardZone *startzone, const QList<int> &_cardId, Server_CardZone *targetzone, int x, int y, bool faceDown, bool tapped);
 	void unattachCard(CommandContainer *cont, Server_Card *card);
-	ResponseCode setCardAttrHelper(CommandContainer *cont, const QString &zone, int cardId, const QString &attrName, const QString &attrValue);
+	ResponseCode setCardAttrHelper(CommandContainer *cont, const ZoneRef &zone, int cardId, const QString &attrName, const QString &attrValue);
 
 	void sendProtocolItem(ProtocolItem *item, bool deleteItem = true);
 };
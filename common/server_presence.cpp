@@ -0,0 +1,76 @@
+#include "server_presence.h"
+#include "server.h"
+#include "server_protocolhandler.h"
+#include "protocol.h"
+#include "protocol_datastructures.h"
+#include <QTimer>
+
+Server_Presence::Server_Presence(Server *_server)
+	: QObject(_server), server(_server), version(0), updateInterval(0)
+{
+	flushTimer = new QTimer(this);
+	flushTimer->setSingleShot(true);
+	connect(flushTimer, SIGNAL(timeout()), this, SLOT(flush()));
+}
+
+void Server_Presence::userChanged(const QString &userName)
+{
+	pendingUserNames.insert(userName);
+	if (!flushTimer->isActive())
+		flushTimer->start(updateInterval);
+}
+
+void Server_Presence::collectChanges(const QSet<QString> &userNames, QList<ServerInfo_User *> &changedUsers, QStringList &leftUsers) const
+{
+	// Only the final state of a user matters, so a user who left and came back
+	// within one batch is reported once with the current info.
+	const QMap<QString, Server_ProtocolHandler *> &users = server->getUsers();
+	QSetIterator<QString> nameIterator(userNames);
+	while (nameIterator.hasNext()) {
+		const QString &userName = nameIterator.next();
+		Server_ProtocolHandler *handler = users.value(userName);
+		if (handler)
+			changedUsers.append(new ServerInfo_User(handler->getUserInfo()));
+		else
+			leftUsers.append(userName);
+	}
+}
+
+void Server_Presence::flush()
+{
+	if (pendingUserNames.isEmpty())
+		return;
+	
+	++version;
+	history.append(QPair<int, QStringList>(version, pendingUserNames.toList()));
+	if (history.size() > maxHistorySize)
+		history.removeFirst();
+	
+	QList<ServerInfo_User *> changedUsers;
+	QStringList leftUsers;
+	collectChanges(pendingUserNames, changedUsers, leftUsers);
+	pendingUserNames.clear();
+	
+	Event_UserListChanged *event = new Event_UserListChanged(version, changedUsers, leftUsers);
+	const QList<Server_ProtocolHandler *> &clients = server->getClients();
+	for (int i = 0; i < clients.size(); ++i)
+		if (clients[i]->getAcceptsUserListChanges())
+			clients[i]->sendProtocolItem(event, false);
+	delete event;
+}
+
+bool Server_Presence::getChangesSince(int sinceVersion, QList<ServerInfo_User *> &changedUsers, QStringList &leftUsers) const
+{
+	if (sinceVersion > version)
+		return false;
+	if (!history.isEmpty() && (sinceVersion < history.first().first - 1))
+		return false;
+	
+	QSet<QString> userNames;
+	for (int i = history.size() - 1; (i >= 0) && (history[i].first > sinceVersion); --i)
+		for (int j = 0; j < history[i].second.size(); ++j)
+			userNames.insert(history[i].second[j]);
+	
+	collectChanges(userNames, changedUsers, leftUsers);
+	return true;
+}
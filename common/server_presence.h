@@ -0,0 +1,41 @@
+#ifndef SERVER_PRESENCE_H
+#define SERVER_PRESENCE_H
+
+#include <QObject>
+#include <QSet>
+#include <QList>
+#include <QPair>
+#include <QStringList>
+
+class Server;
+class ServerInfo_User;
+class QTimer;
+
+// Collects logins and logouts over a short window and broadcasts them as a single
+// Event_UserListChanged per subscriber. Each flushed batch bumps the user list
+// version; a bounded history of which names changed in which version allows
+// Command_ListUsers to be answered with a delta instead of the whole list.
+class Server_Presence : public QObject {
+	Q_OBJECT
+private:
+	static const int maxHistorySize = 256;
+	Server *server;
+	QTimer *flushTimer;
+	int version;
+	int updateInterval;
+	QSet<QString> pendingUserNames;
+	QList<QPair<int, QStringList> > history;
+	void collectChanges(const QSet<QString> &userNames, QList<ServerInfo_User *> &changedUsers, QStringList &leftUsers) const;
+private slots:
+	void flush();
+public:
+	Server_Presence(Server *_server);
+	int getVersion() const { return version; }
+	// Length of the window in ms during which changes are collected before they are sent out.
+	void setUpdateInterval(int _updateInterval) { updateInterval = _updateInterval; }
+	void userChanged(const QString &userName);
+	// Returns false if the history does not reach back to sinceVersion; the caller has to send the complete list then.
+	bool getChangesSince(int sinceVersion, QList<ServerInfo_User *> &changedUsers, QStringList &leftUsers) const;
+};
+
+#endif
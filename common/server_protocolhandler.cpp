@@ -4,6 +4,7 @@
 #include "protocol.h"
 #include "protocol_items.h"
 #include "server_room.h"
+#include "server_presence.h"
 #include "server_card.h"
 #include "server_arrow.h"
 #include "server_cardzone.h"
@@ -14,9 +15,9 @@
 #include <QDateTime>
 
 Server_ProtocolHandler::Server_ProtocolHandler(Server *_server, QObject *parent)
-	: QObject(parent), server(_server), authState(PasswordWrong), acceptsUserListChanges(false), acceptsRoomListChanges(false), userInfo(0), lastCommandTime(QDateTime::currentDateTime())
+	: QObject(parent), server(_server), authState(PasswordWrong), acceptsUserListChanges(false), acceptsRoomListChanges(false), userInfo(0), lastCommandTime(QDateTime::currentDateTime()), inactivityTimer(_server->getTimerWheel(), this)
 {
-	connect(server, SIGNAL(pingClockTimeout()), this, SLOT(pingClockTimeout()));
+	inactivityTimer.start(server->getMaxPlayerInactivityTime() + 1);
 }
 
 Server_ProtocolHandler::~Server_ProtocolHandler()
@@ -141,6 +142,7 @@ ResponseCode Server_ProtocolHandler::processCommandHelper(Command *command, Comm
 		case ItemId_Command_DeckUpload: return cmdDeckUpload(static_cast<Command_DeckUpload *>(command), cont);
 		case ItemId_Command_DeckDownload: return cmdDeckDownload(static_cast<Command_DeckDownload *>(command), cont);
 		case ItemId_Command_GetUserInfo: return cmdGetUserInfo(static_cast<Command_GetUserInfo *>(command), cont);
+		case ItemId_Command_GetAvatar: return cmdGetAvatar(static_cast<Command_GetAvatar *>(command), cont);
 		case ItemId_Command_ListRooms: return cmdListRooms(static_cast<Command_ListRooms *>(command), cont);
 		case ItemId_Command_JoinRoom: return cmdJoinRoom(static_cast<Command_JoinRoom *>(command), cont);
 		case ItemId_Command_ListUsers: return cmdListUsers(static_cast<Command_ListUsers *>(command), cont);
@@ -150,6 +152,10 @@ ResponseCode Server_ProtocolHandler::processCommandHelper(Command *command, Comm
 
 void Server_ProtocolHandler::processCommandContainer(CommandContainer *cont)
 {
+	// Responses, events and game state snapshots created from here on
+	// are freed together when the command has been answered.
+	SerializableArena::Scope arenaScope(server->getCommandArena());
+	
 	const QList<Command *> &cmdList = cont->getCommandList();
 	ResponseCode finalResponseCode = RespOk;
 	for (int i = 0; i < cmdList.size(); ++i) {
@@ -198,10 +204,16 @@ void Server_ProtocolHandler::processCommandContainer(CommandContainer *cont)
 		delete cont;
 }
 
-void Server_ProtocolHandler::pingClockTimeout()
+void Server_ProtocolHandler::wheelTimerExpired(Server_WheelTimer * /*timer*/)
 {
-	if (lastCommandTime.secsTo(QDateTime::currentDateTime()) > server->getMaxPlayerInactivityTime())
+	// The deadline is not moved on every command. Instead, it is checked
+	// lazily here and pushed back if there was activity in the meantime.
+	const int maxTime = server->getMaxPlayerInactivityTime();
+	const int inactiveTime = lastCommandTime.secsTo(QDateTime::currentDateTime());
+	if (inactiveTime > maxTime)
 		deleteLater();
+	else
+		inactivityTimer.start(maxTime + 1 - inactiveTime);
 }
 
 void Server_ProtocolHandler::enqueueProtocolItem(ProtocolItem *item)
@@ -226,6 +238,8 @@ ResponseCode Server_ProtocolHandler::cmdLogin(Command_Login *cmd, CommandContain
 	QString userName = cmd->getUsername().simplified();
 	if (userName.isEmpty() || (userInfo != 0))
 		return RespContextError;
+	// The user info is kept for the whole session.
+	SerializableArena::Suspend suspendArena;
 	authState = server->loginUser(this, userName, cmd->getPassword());
 	if (authState == PasswordWrong)
 		return RespWrongPassword;
@@ -286,6 +300,19 @@ ResponseCode Server_ProtocolHandler::cmdGetUserInfo(Command_GetUserInfo *cmd, Co
 	return RespNothing;
 }
 
+ResponseCode Server_ProtocolHandler::cmdGetAvatar(Command_GetAvatar *cmd, CommandContainer *cont)
+{
+	if (authState == PasswordWrong)
+		return RespLoginNeeded;
+	
+	QByteArray compressedAvatarBmp = server->getCompressedAvatar(cmd->getAvatarHash());
+	if (compressedAvatarBmp.isEmpty())
+		return RespNameNotFound;
+	
+	cont->setResponse(new Response_GetAvatar(cont->getCmdId(), RespOk, cmd->getAvatarHash(), compressedAvatarBmp));
+	return RespNothing;
+}
+
 ResponseCode Server_ProtocolHandler::cmdListRooms(Command_ListRooms * /*cmd*/, CommandContainer *cont)
 {
 	if (authState == PasswordWrong)
@@ -335,19 +362,24 @@ ResponseCode Server_ProtocolHandler::cmdRoomSay(Command_RoomSay *cmd, CommandCon
 	return RespOk;
 }
 
-ResponseCode Server_ProtocolHandler::cmdListUsers(Command_ListUsers * /*cmd*/, CommandContainer *cont)
+ResponseCode Server_ProtocolHandler::cmdListUsers(Command_ListUsers *cmd, CommandContainer *cont)
 {
 	if (authState == PasswordWrong)
 		return RespLoginNeeded;
 	
+	Server_Presence *presence = server->getPresence();
 	QList<ServerInfo_User *> resultList;
-	QMapIterator<QString, Server_ProtocolHandler *> userIterator = server->getUsers();
-	while (userIterator.hasNext())
-		resultList.append(new ServerInfo_User(userIterator.next().value()->getUserInfo(), false));
+	QStringList leftUserList;
+	bool delta = (cmd->getSinceVersion() != -1) && presence->getChangesSince(cmd->getSinceVersion(), resultList, leftUserList);
+	if (!delta) {
+		QMapIterator<QString, Server_ProtocolHandler *> userIterator = server->getUsers();
+		while (userIterator.hasNext())
+			resultList.append(new ServerInfo_User(userIterator.next().value()->getUserInfo()));
+	}
 	
 	acceptsUserListChanges = true;
 	
-	cont->setResponse(new Response_ListUsers(cont->getCmdId(), RespOk, resultList));
+	cont->setResponse(new Response_ListUsers(cont->getCmdId(), RespOk, presence->getVersion(), delta, resultList, leftUserList));
 	return RespNothing;
 }
 
@@ -355,6 +387,8 @@ ResponseCode Server_ProtocolHandler::cmdCreateGame(Command_CreateGame *cmd, Comm
 {
 	if (authState == PasswordWrong)
 		return RespLoginNeeded;
+	// Games and players keep copies of the user info.
+	SerializableArena::Suspend suspendArena;
 	
 	Server_Game *game = room->createGame(cmd->getDescription(), cmd->getPassword(), cmd->getMaxPlayers(), cmd->getSpectatorsAllowed(), cmd->getSpectatorsNeedPassword(), cmd->getSpectatorsCanTalk(), cmd->getSpectatorsSeeEverything(), this);
 	Server_Player *creator = game->getPlayers().values().first();
@@ -369,6 +403,7 @@ ResponseCode Server_ProtocolHandler::cmdJoinGame(Command_JoinGame *cmd, CommandC
 {
 	if (authState == PasswordWrong)
 		return RespLoginNeeded;
+	SerializableArena::Suspend suspendArena;
 	
 	if (games.contains(cmd->getGameId()))
 		return RespContextError;
@@ -397,6 +432,8 @@ ResponseCode Server_ProtocolHandler::cmdDeckSelect(Command_DeckSelect *cmd, Comm
 {
 	if (player->getSpectator())
 		return RespFunctionNotAllowed;
+	// The deck stays with the player.
+	SerializableArena::Suspend suspendArena;
 	
 	DeckList *deck;
 	if (cmd->getDeckId() == -1) {
@@ -478,7 +515,7 @@ ResponseCode Server_ProtocolHandler::cmdShuffle(Command_Shuffle * /*cmd*/, Comma
 	if (!game->getGameStarted())
 		return RespGameNotStarted;
 		
-	player->getZones().value("deck")->shuffle();
+	player->getZone(DeckZoneId)->shuffle();
 	game->sendGameEvent(new Event_Shuffle(player->getPlayerId()));
 	return RespOk;
 }
@@ -491,10 +528,10 @@ ResponseCode Server_ProtocolHandler::cmdMulligan(Command_Mulligan * /*cmd*/, Com
 	if (!game->getGameStarted())
 		return RespGameNotStarted;
 	
-	Server_CardZone *hand = player->getZones().value("hand");
+	Server_CardZone *hand = player->getZone(HandZoneId);
 	int number = (hand->cards.size() <= 1) ? player->getInitialCards() : hand->cards.size() - 1;
 		
-	Server_CardZone *deck = player->getZones().value("deck");
+	Server_CardZone *deck = player->getZone(DeckZoneId);
 	while (!hand->cards.isEmpty())
 		player->moveCard(cont, hand, QList<int>() << hand->cards.first()->getId(), deck, 0, 0, false, false);
 
@@ -524,8 +561,8 @@ ResponseCode Server_ProtocolHandler::drawCards(Server_Game *game, Server_Player
 	if (!game->getGameStarted())
 		return RespGameNotStarted;
 		
-	Server_CardZone *deck = player->getZones().value("deck");
-	Server_CardZone *hand = player->getZones().value("hand");
+	Server_CardZone *deck = player->getZone(DeckZoneId);
+	Server_CardZone *hand = player->getZone(HandZoneId);
 	if (deck->cards.size() < number)
 		number = deck->cards.size();
 
@@ -564,7 +601,7 @@ ResponseCode Server_ProtocolHandler::cmdMoveCard(Command_MoveCard *cmd, CommandC
 	for (int i = 0; i < temp.size(); ++i)
 		cardIds.append(temp[i]->getData());
 	
-	return player->moveCard(cont, cmd->getStartZone(), cardIds, cmd->getTargetPlayerId(), cmd->getTargetZone(), cmd->getX(), cmd->getY(), cmd->getFaceDown(), cmd->getTapped());
+	return player->moveCard(cont, cmd->getStartZoneRef(), cardIds, cmd->getTargetPlayerId(), cmd->getTargetZoneRef(), cmd->getX(), cmd->getY(), cmd->getFaceDown(), cmd->getTapped());
 }
 
 ResponseCode Server_ProtocolHandler::cmdFlipCard(Command_FlipCard *cmd, CommandContainer *cont, Server_Game *game, Server_Player *player)
@@ -575,7 +612,7 @@ ResponseCode Server_ProtocolHandler::cmdFlipCard(Command_FlipCard *cmd, CommandC
 	if (!game->getGameStarted())
 		return RespGameNotStarted;
 		
-	Server_CardZone *zone = player->getZones().value(cmd->getZone());
+	Server_CardZone *zone = player->getZone(cmd->getZoneRef());
 	if (!zone)
 		return RespNameNotFound;
 	if (!zone->hasCoords())
@@ -604,7 +641,7 @@ ResponseCode Server_ProtocolHandler::cmdAttachCard(Command_AttachCard *cmd, Comm
 	if (!game->getGameStarted())
 		return RespGameNotStarted;
 		
-	Server_CardZone *startzone = player->getZones().value(cmd->getStartZone());
+	Server_CardZone *startzone = player->getZone(cmd->getStartZoneRef());
 	if (!startzone)
 		return RespNameNotFound;
 	
@@ -624,7 +661,7 @@ ResponseCode Server_ProtocolHandler::cmdAttachCard(Command_AttachCard *cmd, Comm
 	} else if (!card->getParentCard())
 		return RespContextError;
 	if (targetPlayer)
-		targetzone = targetPlayer->getZones().value(cmd->getTargetZone());
+		targetzone = targetPlayer->getZone(cmd->getTargetZoneRef());
 	if (targetzone) {
 		// This is currently enough to make sure cards don't get attached to a card that is not on the table.
 		// Possibly a flag will have to be introduced for this sometime.
@@ -646,7 +683,7 @@ ResponseCode Server_ProtocolHandler::cmdAttachCard(Command_AttachCard *cmd, Comm
 		QList<Server_Arrow *> toDelete;
 		for (int i = 0; i < arrows.size(); ++i) {
 			Server_Arrow *a = arrows[i];
-			Server_Card *tCard = qobject_cast<Server_Card *>(a->getTargetItem());
+			Server_Card *tCard = Server_Card::fromArrowTarget(a->getTargetItem());
 			if ((tCard == card) || (a->getStartCard() == card))
 				toDelete.append(a);
 		}
@@ -684,7 +721,7 @@ ResponseCode Server_ProtocolHandler::cmdCreateToken(Command_CreateToken *cmd, Co
 	if (!game->getGameStarted())
 		return RespGameNotStarted;
 		
-	Server_CardZone *zone = player->getZones().value(cmd->getZone());
+	Server_CardZone *zone = player->getZone(cmd->getZoneRef());
 	if (!zone)
 		return RespNameNotFound;
 
@@ -697,7 +734,7 @@ ResponseCode Server_ProtocolHandler::cmdCreateToken(Command_CreateToken *cmd, Co
 	if (y < 0)
 		y = 0;
 
-	Server_Card *card = new Server_Card(cmd->getCardName(), player->newCardId(), x, y);
+	Server_Card *card = game->getCardPool()->newCard(cmd->getCardName(), player->newCardId(), x, y);
 	card->setPT(cmd->getPt());
 	card->setColor(cmd->getColor());
 	card->setAnnotation(cmd->getAnnotation());
@@ -721,11 +758,11 @@ ResponseCode Server_ProtocolHandler::cmdCreateArrow(Command_CreateArrow *cmd, Co
 	Server_Player *targetPlayer = game->getPlayer(cmd->getTargetPlayerId());
 	if (!startPlayer || !targetPlayer)
 		return RespNameNotFound;
-	Server_CardZone *startZone = startPlayer->getZones().value(cmd->getStartZone());
+	Server_CardZone *startZone = startPlayer->getZone(cmd->getStartZoneRef());
 	bool playerTarget = cmd->getTargetZone().isEmpty();
 	Server_CardZone *targetZone = 0;
 	if (!playerTarget)
-		targetZone = targetPlayer->getZones().value(cmd->getTargetZone());
+		targetZone = targetPlayer->getZone(cmd->getTargetZoneRef());
 	if (!startZone || (!targetZone && !playerTarget))
 		return RespNameNotFound;
 	if (startZone->getType() != PublicZone)
@@ -793,7 +830,7 @@ ResponseCode Server_ProtocolHandler::cmdSetCardAttr(Command_SetCardAttr *cmd, Co
 	if (!game->getGameStarted())
 		return RespGameNotStarted;
 		
-	return player->setCardAttrHelper(cont, cmd->getZone(), cmd->getCardId(), cmd->getAttrName(), cmd->getAttrValue());
+	return player->setCardAttrHelper(cont, cmd->getZoneRef(), cmd->getCardId(), cmd->getAttrName(), cmd->getAttrValue());
 }
 
 ResponseCode Server_ProtocolHandler::cmdSetCardCounter(Command_SetCardCounter *cmd, CommandContainer *cont, Server_Game *game, Server_Player *player)
@@ -804,7 +841,7 @@ ResponseCode Server_ProtocolHandler::cmdSetCardCounter(Command_SetCardCounter *c
 	if (!game->getGameStarted())
 		return RespGameNotStarted;
 		
-	Server_CardZone *zone = player->getZones().value(cmd->getZone());
+	Server_CardZone *zone = player->getZone(cmd->getZoneRef());
 	if (!zone)
 		return RespNameNotFound;
 	if (!zone->hasCoords())
@@ -829,7 +866,7 @@ ResponseCode Server_ProtocolHandler::cmdIncCardCounter(Command_IncCardCounter *c
 	if (!game->getGameStarted())
 		return RespGameNotStarted;
 		
-	Server_CardZone *zone = player->getZones().value(cmd->getZone());
+	Server_CardZone *zone = player->getZone(cmd->getZoneRef());
 	if (!zone)
 		return RespNameNotFound;
 	if (!zone->hasCoords())
@@ -946,7 +983,7 @@ ResponseCode Server_ProtocolHandler::cmdDumpZone(Command_DumpZone *cmd, CommandC
 	Server_Player *otherPlayer = game->getPlayer(cmd->getPlayerId());
 	if (!otherPlayer)
 		return RespNameNotFound;
-	Server_CardZone *zone = otherPlayer->getZones().value(cmd->getZoneName());
+	Server_CardZone *zone = otherPlayer->getZone(cmd->getZoneNameRef());
 	if (!zone)
 		return RespNameNotFound;
 	if (!((zone->getType() == PublicZone) || (player == otherPlayer)))
@@ -995,7 +1032,7 @@ ResponseCode Server_ProtocolHandler::cmdStopDumpZone(Command_StopDumpZone *cmd,
 	Server_Player *otherPlayer = game->getPlayer(cmd->getPlayerId());
 	if (!otherPlayer)
 		return RespNameNotFound;
-	Server_CardZone *zone = otherPlayer->getZones().value(cmd->getZoneName());
+	Server_CardZone *zone = otherPlayer->getZone(cmd->getZoneNameRef());
 	if (!zone)
 		return RespNameNotFound;
 	
@@ -1020,7 +1057,7 @@ ResponseCode Server_ProtocolHandler::cmdRevealCards(Command_RevealCards *cmd, Co
 		if (!otherPlayer)
 			return RespNameNotFound;
 	}
-	Server_CardZone *zone = player->getZones().value(cmd->getZoneName());
+	Server_CardZone *zone = player->getZone(cmd->getZoneNameRef());
 	if (!zone)
 		return RespNameNotFound;
 	
@@ -6,14 +6,14 @@
 #include "server.h"
 #include "protocol.h"
 #include "protocol_items.h"
+#include "server_timerwheel.h"
 
 class Server_Player;
 class Server_Card;
 class ServerInfo_User;
 class Server_Room;
-class QTimer;
 
-class Server_ProtocolHandler : public QObject {
+class Server_ProtocolHandler : public QObject, public Server_TimerWheelListener {
 	Q_OBJECT
 protected:
 	Server *server;
@@ -31,7 +31,7 @@ protected:
 private:
 	QList<ProtocolItem *> itemQueue;
 	QDateTime lastCommandTime;
-	QTimer *pingClock;
+	Server_WheelTimer inactivityTimer;
 
 	virtual DeckList *getDeckFromDatabase(int deckId) = 0;
 
@@ -45,6 +45,7 @@ private:
 	virtual ResponseCode cmdDeckUpload(Command_DeckUpload *cmd, CommandContainer *cont) = 0;
 	virtual ResponseCode cmdDeckDownload(Command_DeckDownload *cmd, CommandContainer *cont) = 0;
 	ResponseCode cmdGetUserInfo(Command_GetUserInfo *cmd, CommandContainer *cont);
+	ResponseCode cmdGetAvatar(Command_GetAvatar *cmd, CommandContainer *cont);
 	ResponseCode cmdListRooms(Command_ListRooms *cmd, CommandContainer *cont);
 	ResponseCode cmdJoinRoom(Command_JoinRoom *cmd, CommandContainer *cont);
 	ResponseCode cmdLeaveRoom(Command_LeaveRoom *cmd, CommandContainer *cont, Server_Room *room);
@@ -84,12 +85,11 @@ private:
 	virtual ResponseCode cmdUpdateServerMessage(Command_UpdateServerMessage *cmd, CommandContainer *cont) = 0;
 	
 	ResponseCode processCommandHelper(Command *command, CommandContainer *cont);
-private slots:
-	void pingClockTimeout();
 public:
 	Server_ProtocolHandler(Server *_server, QObject *parent = 0);
 	~Server_ProtocolHandler();
 	void playerRemovedFromGame(Server_Game *game);
+	void wheelTimerExpired(Server_WheelTimer *timer);
 	
 	bool getAcceptsUserListChanges() const { return acceptsUserListChanges; }
 	bool getAcceptsRoomListChanges() const { return acceptsRoomListChanges; }
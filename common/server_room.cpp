@@ -23,7 +23,7 @@ ServerInfo_Room *Server_Room::getInfo(bool complete) const
 			gameList.append(gameIterator.next().value()->getInfo());
 		
 		for (int i = 0; i < size(); ++i)
-			userList.append(new ServerInfo_User(at(i)->getUserInfo(), false));
+			userList.append(new ServerInfo_User(at(i)->getUserInfo()));
 	}
 	
 	return new ServerInfo_Room(id, name, description, games.size(), size(), autoJoin, gameList, userList);
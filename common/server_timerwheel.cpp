@@ -0,0 +1,142 @@
+#include "server_timerwheel.h"
+#include <QTimer>
+
+Server_WheelTimer::Server_WheelTimer(Server_TimerWheel *_wheel, Server_TimerWheelListener *_listener)
+	: wheel(_wheel), listener(_listener), prev(0), next(0), expiry(0)
+{
+}
+
+Server_WheelTimer::~Server_WheelTimer()
+{
+	stop();
+}
+
+void Server_WheelTimer::setWheel(Server_TimerWheel *_wheel, Server_TimerWheelListener *_listener)
+{
+	stop();
+	wheel = _wheel;
+	listener = _listener;
+}
+
+void Server_WheelTimer::unlink()
+{
+	prev->next = next;
+	next->prev = prev;
+	prev = 0;
+	next = 0;
+}
+
+void Server_WheelTimer::start(int ticks)
+{
+	if (!wheel)
+		return;
+	if (isActive())
+		unlink();
+	else
+		++wheel->activeTimers;
+	
+	expiry = wheel->currentTick + qMax(ticks, 1);
+	wheel->insert(this);
+}
+
+void Server_WheelTimer::stop()
+{
+	if (!isActive())
+		return;
+	
+	unlink();
+	wheel->timerRemoved();
+}
+
+Server_TimerWheel::Server_TimerWheel(int tickInterval, QObject *parent)
+	: QObject(parent), currentTick(0), activeTimers(0)
+{
+	// Every slot is the sentinel of a circular list.
+	for (int i = 0; i < Level0Size; ++i)
+		level0[i].prev = level0[i].next = &level0[i];
+	for (int i = 0; i < LevelNSize; ++i) {
+		level1[i].prev = level1[i].next = &level1[i];
+		level2[i].prev = level2[i].next = &level2[i];
+	}
+	
+	tickClock = new QTimer(this);
+	tickClock->setInterval(tickInterval);
+	connect(tickClock, SIGNAL(timeout()), this, SLOT(tick()));
+}
+
+Server_TimerWheel::~Server_TimerWheel()
+{
+	// Detach timers still scheduled so that their destructors do not touch the wheel.
+	Server_WheelTimer *levels[] = { level0, level1, level2 };
+	const int levelSizes[] = { Level0Size, LevelNSize, LevelNSize };
+	for (int i = 0; i < 3; ++i)
+		for (int j = 0; j < levelSizes[i]; ++j) {
+			Server_WheelTimer *slot = &levels[i][j];
+			while (slot->next != slot) {
+				Server_WheelTimer *timer = slot->next;
+				timer->unlink();
+				timer->wheel = 0;
+			}
+			slot->prev = slot->next = 0;
+		}
+}
+
+void Server_TimerWheel::insert(Server_WheelTimer *timer)
+{
+	const qint64 delta = timer->expiry - currentTick;
+	Server_WheelTimer *slot;
+	if (delta < Level0Size)
+		slot = &level0[timer->expiry & Level0Mask];
+	else if (delta < (Level0Size << LevelNBits))
+		slot = &level1[(timer->expiry >> Level1Shift) & LevelNMask];
+	else if (delta < WheelSpan)
+		slot = &level2[(timer->expiry >> Level2Shift) & LevelNMask];
+	else
+		slot = &level2[((currentTick + WheelSpan - 1) >> Level2Shift) & LevelNMask];
+	
+	timer->prev = slot->prev;
+	timer->next = slot;
+	slot->prev->next = timer;
+	slot->prev = timer;
+	
+	if (!tickClock->isActive())
+		tickClock->start();
+}
+
+void Server_TimerWheel::cascade(Server_WheelTimer *slot)
+{
+	while (slot->next != slot) {
+		Server_WheelTimer *timer = slot->next;
+		timer->unlink();
+		insert(timer);
+	}
+}
+
+void Server_TimerWheel::timerRemoved()
+{
+	if (!--activeTimers)
+		tickClock->stop();
+}
+
+void Server_TimerWheel::tick()
+{
+	++currentTick;
+	if (!(currentTick & ((1 << Level2Shift) - 1)))
+		cascade(&level2[(currentTick >> Level2Shift) & LevelNMask]);
+	if (!(currentTick & Level0Mask))
+		cascade(&level1[(currentTick >> Level1Shift) & LevelNMask]);
+	
+	// Timers are taken out one by one because a listener may stop or
+	// restart any other timer, including ones in this slot.
+	Server_WheelTimer *slot = &level0[currentTick & Level0Mask];
+	while (slot->next != slot) {
+		Server_WheelTimer *timer = slot->next;
+		timer->unlink();
+		if (timer->expiry > currentTick)
+			insert(timer);
+		else {
+			timerRemoved();
+			timer->listener->wheelTimerExpired(timer);
+		}
+	}
+}
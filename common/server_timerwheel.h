@@ -0,0 +1,78 @@
+#ifndef SERVER_TIMERWHEEL_H
+#define SERVER_TIMERWHEEL_H
+
+#include <QObject>
+
+class QTimer;
+class Server_TimerWheel;
+class Server_WheelTimer;
+
+class Server_TimerWheelListener {
+public:
+	virtual ~Server_TimerWheelListener() { }
+	virtual void wheelTimerExpired(Server_WheelTimer *timer) = 0;
+};
+
+// A single-shot timer scheduled on a Server_TimerWheel. It is meant to be
+// embedded as a member of the object it belongs to; it unschedules itself
+// when destroyed.
+class Server_WheelTimer {
+	friend class Server_TimerWheel;
+private:
+	Server_TimerWheel *wheel;
+	Server_TimerWheelListener *listener;
+	Server_WheelTimer *prev, *next;
+	qint64 expiry;
+	
+	Server_WheelTimer(const Server_WheelTimer &);
+	Server_WheelTimer &operator=(const Server_WheelTimer &);
+	void unlink();
+public:
+	Server_WheelTimer(Server_TimerWheel *_wheel = 0, Server_TimerWheelListener *_listener = 0);
+	~Server_WheelTimer();
+	void setWheel(Server_TimerWheel *_wheel, Server_TimerWheelListener *_listener);
+	// Restarts the timer if it is already active.
+	void start(int ticks);
+	void stop();
+	bool isActive() const { return prev != 0; }
+};
+
+// Hierarchical timer wheel with three levels of slots (256 * 64 * 64 ticks).
+// Starting or stopping a timer is O(1), and a tick only touches the timers due
+// in that tick plus, every 256 ticks, one slot of an upper level that gets
+// redistributed to the lower levels. Timers further away than the wheel covers
+// are parked in the last level and rescheduled when they come around.
+class Server_TimerWheel : public QObject {
+	Q_OBJECT
+	friend class Server_WheelTimer;
+private:
+	enum {
+		Level0Bits = 8,
+		LevelNBits = 6,
+		Level0Size = 1 << Level0Bits,
+		LevelNSize = 1 << LevelNBits,
+		Level0Mask = Level0Size - 1,
+		LevelNMask = LevelNSize - 1,
+		Level1Shift = Level0Bits,
+		Level2Shift = Level0Bits + LevelNBits,
+		WheelSpan = 1 << (Level0Bits + 2 * LevelNBits)
+	};
+	Server_WheelTimer level0[Level0Size];
+	Server_WheelTimer level1[LevelNSize];
+	Server_WheelTimer level2[LevelNSize];
+	qint64 currentTick;
+	int activeTimers;
+	QTimer *tickClock;
+	
+	void insert(Server_WheelTimer *timer);
+	void cascade(Server_WheelTimer *slot);
+	void timerRemoved();
+private slots:
+	void tick();
+public:
+	Server_TimerWheel(int tickInterval, QObject *parent = 0);
+	~Server_TimerWheel();
+	qint64 getCurrentTick() const { return currentTick; }
+};
+
+#endif
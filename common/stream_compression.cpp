@@ -0,0 +1,158 @@
+#include "stream_compression.h"
+
+const char *StreamCompression::methodName = "deflate";
+const char *StreamCompression::startMarker = "<stream_compression type=\"deflate\"/>";
+
+const QByteArray &StreamCompression::getDictionary()
+{
+	// Samples of the items as SerializableItem_Map writes them: child items
+	// in key order followed by the list items, standard zones and known card
+	// names as id attributes. zlib favours strings near the end of the
+	// dictionary, so the most frequent ones (game events, responses and
+	// pings) come last. Both sides must use exactly the same bytes here.
+	static const QByteArray dictionary(
+		"<resp type=\"login\"><cmd_id>0</cmd_id><response_code>ok</response_code><user><avatar_hash>"
+		"</avatar_hash><country></country><name></name><real_name></real_name><userlevel>1</userlevel></user>"
+		"</resp>"
+		"<generic_event type=\"user_list_changed\"><version>0</version><user></user><left_user/>"
+		"</generic_event>"
+		"<room_event type=\"list_games\"><room_id>0</room_id><game><description></description><game_id>0"
+		"</game_id><has_password>1</has_password><max_players>2</max_players><player_count>1</player_count>"
+		"<spectator_count>0</spectator_count><spectators_allowed>1</spectators_allowed>"
+		"<spectators_need_password>1</spectators_need_password><user></user></game></room_event>"
+		"<room_event type=\"join_room\"><room_id>0</room_id><user></user></room_event>"
+		"<room_event type=\"leave_room\"><player_name></player_name><room_id>0</room_id></room_event>"
+		"<room_event type=\"room_say\"><message></message><player_name></player_name><room_id>0</room_id>"
+		"</room_event>"
+		"<resp type=\"join_room\"><cmd_id>0</cmd_id><response_code>ok</response_code><room><auto_join>1"
+		"</auto_join><description></description><game_count>0</game_count><name></name><player_count>0"
+		"</player_count><room_id>0</room_id></room></resp>"
+		"<game_event type=\"game_state_changed\"><active_phase>0</active_phase><active_player>0</active_player>"
+		"<game_started>1</game_started><player><player_properties><conceded>1</conceded><deck_id>0</deck_id>"
+		"<player_id>0</player_id><ready_start>1</ready_start><spectator>1</spectator><user></user>"
+		"</player_properties><zone><card_count>0</card_count><has_coords>1</has_coords><name id=\"0\"/>"
+		"<zone_type>hidden</zone_type></zone><counter><color>0</color><count>20</count><id>0</id><name>life"
+		"</name><radius>0</radius></counter><arrow><color>0</color><id>0</id><start_card_id>0</start_card_id>"
+		"<start_player_id>0</start_player_id><start_zone id=\"2\"/><target_card_id>0</target_card_id>"
+		"<target_player_id>0</target_player_id><target_zone id=\"2\"/></arrow></player></game_event>"
+		"<game_event type=\"join\"><player_id>0</player_id><player_properties><conceded>1</conceded><deck_id>0"
+		"</deck_id><player_id>0</player_id><ready_start>1</ready_start><spectator>1</spectator><user></user>"
+		"</player_properties></game_event>"
+		"<card><annotation></annotation><attach_card_id>0</attach_card_id><attach_player_id>0"
+		"</attach_player_id><attach_zone id=\"2\"/><attacking>1</attacking><color></color>"
+		"<destroy_on_zone_change>1</destroy_on_zone_change><id>0</id><name id=\"0\"/><pt></pt><tapped>1"
+		"</tapped><x>0</x><y>0</y><card_counter><id>0</id><value>0</value></card_counter></card>"
+		"<cmd type=\"create_arrow\"><color>0</color><game_id>0</game_id><start_card_id>0</start_card_id>"
+		"<start_player_id>0</start_player_id><start_zone id=\"2\"/><target_card_id>0</target_card_id>"
+		"<target_player_id>0</target_player_id><target_zone id=\"2\"/></cmd>"
+		"<cmd type=\"set_card_attr\"><attr_name>tapped</attr_name><attr_value>1</attr_value><card_id>0"
+		"</card_id><game_id>0</game_id><zone id=\"2\"/></cmd>"
+		"<cmd type=\"move_card\"><game_id>0</game_id><start_zone id=\"3\"/><target_player_id>0</target_player_id>"
+		"<target_zone id=\"2\"/><x>0</x><y>0</y><card_id>0</card_id></cmd>"
+		"<cmd type=\"inc_counter\"><counter_id>0</counter_id><delta>-1</delta><game_id>0</game_id></cmd>"
+		"<cmd type=\"draw_cards\"><game_id>0</game_id><number>1</number></cmd>"
+		"<cmd type=\"say\"><game_id>0</game_id><message></message></cmd>"
+		"<game_event type=\"say\"><message></message><player_id>0</player_id></game_event>"
+		"<game_event type=\"set_counter\"><counter_id>0</counter_id><player_id>0</player_id><value>20</value>"
+		"</game_event>"
+		"<game_event type=\"set_active_player\"><active_player_id>0</active_player_id><player_id>0</player_id>"
+		"</game_event>"
+		"<game_event type=\"set_active_phase\"><phase>0</phase></game_event>"
+		"<game_event type=\"draw_cards\"><number_cards>1</number_cards><player_id>0</player_id><card><id>0</id>"
+		"<name id=\"0\"/></card></game_event>"
+		"<game_event type=\"set_card_attr\"><attr_name>tapped</attr_name><attr_value>1</attr_value><card_id>0"
+		"</card_id><player_id>0</player_id><zone id=\"2\"/></game_event>"
+		"<game_event type=\"move_card\"><card_id>0</card_id><card_name id=\"0\"/><face_down>1</face_down>"
+		"<new_card_id>0</new_card_id><player_id>0</player_id><position>0</position><start_zone id=\"3\"/>"
+		"<target_player_id>0</target_player_id><target_zone id=\"2\"/><x>0</x><y>0</y></game_event>"
+		"<game_event type=\"ping\"><seconds_elapsed>0</seconds_elapsed><player_ping><ping_time>0</ping_time>"
+		"<player_id>0</player_id></player_ping></game_event>"
+		"<container type=\"game_event\"><game_id>0</game_id></container>"
+		"<container type=\"cmd\"><cmd_id>0</cmd_id></container>"
+		"<resp><cmd_id>0</cmd_id><response_code>ok</response_code></resp>"
+	);
+	return dictionary;
+}
+
+StreamDeflater::StreamDeflater(int level)
+{
+	stream.zalloc = Z_NULL;
+	stream.zfree = Z_NULL;
+	stream.opaque = Z_NULL;
+	valid = (deflateInit(&stream, level) == Z_OK);
+	if (valid) {
+		const QByteArray &dictionary = StreamCompression::getDictionary();
+		valid = (deflateSetDictionary(&stream, (const Bytef *) dictionary.constData(), dictionary.size()) == Z_OK);
+	}
+}
+
+StreamDeflater::~StreamDeflater()
+{
+	deflateEnd(&stream);
+}
+
+QByteArray StreamDeflater::deflate(const QByteArray &data)
+{
+	QByteArray result;
+	if (!valid || data.isEmpty())
+		return result;
+	
+	char buffer[16384];
+	stream.next_in = (Bytef *) data.constData();
+	stream.avail_in = data.size();
+	do {
+		stream.next_out = (Bytef *) buffer;
+		stream.avail_out = sizeof(buffer);
+		if (::deflate(&stream, Z_SYNC_FLUSH) == Z_STREAM_ERROR) {
+			valid = false;
+			return QByteArray();
+		}
+		result.append(buffer, sizeof(buffer) - stream.avail_out);
+	} while (stream.avail_out == 0);
+	
+	return result;
+}
+
+StreamInflater::StreamInflater()
+{
+	stream.zalloc = Z_NULL;
+	stream.zfree = Z_NULL;
+	stream.opaque = Z_NULL;
+	stream.next_in = Z_NULL;
+	stream.avail_in = 0;
+	valid = (inflateInit(&stream) == Z_OK);
+}
+
+StreamInflater::~StreamInflater()
+{
+	inflateEnd(&stream);
+}
+
+bool StreamInflater::inflate(const QByteArray &data, QByteArray &result)
+{
+	if (!valid)
+		return false;
+	
+	char buffer[16384];
+	stream.next_in = (Bytef *) data.constData();
+	stream.avail_in = data.size();
+	forever {
+		stream.next_out = (Bytef *) buffer;
+		stream.avail_out = sizeof(buffer);
+		int ret = ::inflate(&stream, Z_SYNC_FLUSH);
+		if (ret == Z_NEED_DICT) {
+			const QByteArray &dictionary = StreamCompression::getDictionary();
+			if (inflateSetDictionary(&stream, (const Bytef *) dictionary.constData(), dictionary.size()) != Z_OK)
+				break;
+			continue;
+		}
+		if ((ret != Z_OK) && (ret != Z_BUF_ERROR))
+			break;
+		result.append(buffer, sizeof(buffer) - stream.avail_out);
+		// Z_BUF_ERROR: nothing left to do until more input arrives.
+		if ((stream.avail_out != 0) || (ret == Z_BUF_ERROR))
+			return true;
+	}
+	valid = false;
+	return false;
+}
@@ -0,0 +1,46 @@
+#ifndef STREAM_COMPRESSION_H
+#define STREAM_COMPRESSION_H
+
+#include <QByteArray>
+#include <zlib.h>
+
+// Optional deflate compression of the whole protocol stream.
+//
+// The server advertises it with a compression="deflate" attribute in its stream
+// header. A client that wants it repeats the attribute in its own header; everything
+// it sends after the end of that start tag is compressed. The server answers with
+// startMarker, and everything it sends after the marker is compressed.
+//
+// Each direction keeps one zlib context for the whole connection and flushes it
+// after every write, so the receiver can always decode what has arrived so far.
+// Both contexts start from the same preset dictionary of frequent protocol strings.
+class StreamCompression {
+public:
+	static const char *methodName;
+	static const char *startMarker;
+	static const QByteArray &getDictionary();
+};
+
+class StreamDeflater {
+private:
+	z_stream stream;
+	bool valid;
+public:
+	StreamDeflater(int level = Z_DEFAULT_COMPRESSION);
+	~StreamDeflater();
+	bool isValid() const { return valid; }
+	QByteArray deflate(const QByteArray &data);
+};
+
+class StreamInflater {
+private:
+	z_stream stream;
+	bool valid;
+public:
+	StreamInflater();
+	~StreamInflater();
+	bool isValid() const { return valid; }
+	bool inflate(const QByteArray &data, QByteArray &result);
+};
+
+#endif
@@ -1,17 +1,70 @@
 #include <QApplication>
 #include <QTextCodec>
+#include <QDir>
+#include <QFileInfo>
+#include <QTime>
+#include <QtConcurrentMap>
+#include <stdio.h>
 #include "oracleimporter.h"
 #include "window_main.h"
 #include "settingscache.h"
 
 SettingsCache *settingsCache;
 
+static int parseSpoilerFile(const QString &fileName)
+{
+	QFile file(fileName);
+	if (!file.open(QIODevice::ReadOnly))
+		return 0;
+	return OracleImporter::parseTextSpoiler(file.readAll(), QFileInfo(fileName).baseName(), SpoilerUrls()).size();
+}
+
+static void sumCards(int &total, const int &cards)
+{
+	total += cards;
+}
+
+// Parses saved spoilers (e.g. the spoilers/ cache of an import) without
+// network access and prints how long it takes.
+static int runBenchmark(const QString &path)
+{
+	QDir dir(path);
+	const QStringList files = dir.entryList(QStringList() << "*.html", QDir::Files, QDir::Name);
+	QStringList filePaths;
+	for (int i = 0; i < files.size(); ++i)
+		filePaths << dir.absoluteFilePath(files[i]);
+	
+	QTime time;
+	time.start();
+	int totalCards = 0;
+	for (int i = 0; i < filePaths.size(); ++i) {
+		QTime fileTime;
+		fileTime.start();
+		int cards = parseSpoilerFile(filePaths[i]);
+		totalCards += cards;
+		printf("%s: %d cards in %d ms\n", qPrintable(files[i]), cards, fileTime.elapsed());
+	}
+	int sequentialTime = time.elapsed();
+	
+	time.start();
+	int parallelCards = QtConcurrent::blockingMappedReduced<int>(filePaths, parseSpoilerFile, sumCards);
+	int parallelTime = time.elapsed();
+	
+	printf("%d files, %d cards: sequential %d ms, parallel %d ms (%d cards)\n", filePaths.size(), totalCards, sequentialTime, parallelTime, parallelCards);
+	return 0;
+}
+
 int main(int argc, char *argv[])
 {
 	QApplication app(argc, argv);
 	
 	QTextCodec::setCodecForCStrings(QTextCodec::codecForName("UTF-8"));
 
+	QStringList args = app.arguments();
+	int benchmarkIndex = args.indexOf("-benchmark");
+	if (benchmarkIndex != -1)
+		return runBenchmark(args.value(benchmarkIndex + 1, "spoilers"));
+	
 	settingsCache = new SettingsCache;
 	
 	WindowMain wnd;
@@ -3,15 +3,12 @@
 #include <QtNetwork>
 #include <QXmlStreamReader>
 #include <QDomDocument>
+#include <QtConcurrentRun>
 
 OracleImporter::OracleImporter(const QString &_dataDir, QObject *parent)
-	: CardDatabase(parent), dataDir(_dataDir), setIndex(-1)
+	: CardDatabase(parent), dataDir(_dataDir), nextDownloadIndex(-1), nextMergeIndex(-1)
 {
-	buffer = new QBuffer(this);
-	http = new QHttp(this);
-	connect(http, SIGNAL(requestFinished(int, bool)), this, SLOT(httpRequestFinished(int, bool)));
-	connect(http, SIGNAL(responseHeaderReceived(const QHttpResponseHeader &)), this, SLOT(readResponseHeader(const QHttpResponseHeader &)));
-	connect(http, SIGNAL(dataReadProgress(int, int)), this, SIGNAL(dataReadProgress(int, int)));
+	nam = new QNetworkAccessManager(this);
 }
 
 void OracleImporter::readSetsFromFile(const QString &fileName)
@@ -58,86 +55,96 @@ void OracleImporter::readSetsFromXml(QXmlStreamReader &xml)
 			allSets << SetToDownload(edition, editionLong, editionURL, import);
 			edition = editionLong = editionURL = QString();
 		} else if (xml.name() == "picture_url")
-			pictureUrl = xml.readElementText();
+			spoilerUrls.pictureUrl = xml.readElementText();
                 else if (xml.name() == "picture_url_hq")
-                        pictureUrlHq = xml.readElementText();
+                        spoilerUrls.pictureUrlHq = xml.readElementText();
                 else if (xml.name() == "picture_url_stripped")
-                        pictureUrlStripped = xml.readElementText();
+                        spoilerUrls.pictureUrlStripped = xml.readElementText();
 		else if (xml.name() == "set_url")
 			setUrl = xml.readElementText();
 	}
 }
 
-CardInfo *OracleImporter::addCard(QString cardName, const QString &cardCost, const QString &cardType, const QString &cardPT, const QStringList &cardText, const QString setShortName)
+SpoilerCard OracleImporter::makeSpoilerCard(QString cardName, const QString &cardCost, const QString &cardType, const QString &cardPT, const QStringList &cardText, const QString &setShortName, const SpoilerUrls &urls)
 {
-	QString fullCardText = cardText.join("\n");
-	bool splitCard = false;
+	SpoilerCard card;
 	if (cardName.contains('(')) {
 		cardName.remove(QRegExp(" \\(.*\\)"));
-		splitCard = true;
+		card.splitCard = true;
 	}
+	// Workaround for card name weirdness
+	if (cardName.contains("XX"))
+		cardName.remove("XX");
+	cardName = cardName.replace("Æ", "Ae");
 	
+	card.name = cardName;
+	card.cost = cardCost;
+	card.type = cardType;
+	card.pt = cardPT;
+	card.text = cardText.join("\n");
+	
+	bool mArtifact = false;
+	if (cardType.endsWith("Artifact"))
+		for (int i = 0; i < cardText.size(); ++i)
+			if (cardText[i].contains("{T}") && cardText[i].contains("to your mana pool"))
+				mArtifact = true;
+	
+	QStringList allColors = QStringList() << "W" << "U" << "B" << "R" << "G";
+	for (int i = 0; i < allColors.size(); i++)
+		if (cardCost.contains(allColors[i]))
+			card.colors << allColors[i];
+	
+	if (cardText.contains(cardName + " is white."))
+		card.colors << "W";
+	if (cardText.contains(cardName + " is blue."))
+		card.colors << "U";
+	if (cardText.contains(cardName + " is black."))
+		card.colors << "B";
+	if (cardText.contains(cardName + " is red."))
+		card.colors << "R";
+	if (cardText.contains(cardName + " is green."))
+		card.colors << "G";
+	
+	card.cipt = (cardText.contains(cardName + " enters the battlefield tapped."));
+	
+	card.picURL = getURLFromNameAndCardSet(cardName, setShortName, false, urls.pictureUrl);
+	card.picHqURL = getURLFromNameAndCardSet(cardName, setShortName, true, urls.pictureUrlHq);
+	card.picStURL = getURLFromNameAndCardSet(cardName, setShortName, true, urls.pictureUrlStripped);
+	
+	QString mainCardType = CardInfoStore::parseMainCardType(cardType);
+	if ((mainCardType == "Land") || mArtifact)
+		card.tableRow = 0;
+	else if ((mainCardType == "Sorcery") || (mainCardType == "Instant"))
+		card.tableRow = 3;
+	else if (mainCardType == "Creature")
+		card.tableRow = 2;
+	else
+		card.tableRow = 1;
+	
+	return card;
+}
+
+CardInfo *OracleImporter::addCard(const SpoilerCard &spoilerCard)
+{
 	CardInfo *card;
-	if (cardHash.contains(cardName)) {
-		card = cardHash.value(cardName);
-		if (splitCard && !card->getText().contains(fullCardText))
-			card->setText(card->getText() + "\n---\n" + fullCardText);
+	if (cardHash.contains(spoilerCard.name)) {
+		card = cardHash.value(spoilerCard.name);
+		if (spoilerCard.splitCard && !card->getText().contains(spoilerCard.text))
+			card->setText(card->getText() + "\n---\n" + spoilerCard.text);
 	} else {
-		// Workaround for card name weirdness
-		if (cardName.contains("XX"))
-			cardName.remove("XX");
-		cardName = cardName.replace("Æ", "Ae");
-		
-		bool mArtifact = false;
-		if (cardType.endsWith("Artifact"))
-			for (int i = 0; i < cardText.size(); ++i)
-				if (cardText[i].contains("{T}") && cardText[i].contains("to your mana pool"))
-					mArtifact = true;
-					
-		QStringList colors;
-		QStringList allColors = QStringList() << "W" << "U" << "B" << "R" << "G";
-		for (int i = 0; i < allColors.size(); i++)
-			if (cardCost.contains(allColors[i]))
-				colors << allColors[i];
-		
-		if (cardText.contains(cardName + " is white."))
-			colors << "W";
-		if (cardText.contains(cardName + " is blue."))
-			colors << "U";
-		if (cardText.contains(cardName + " is black."))
-			colors << "B";
-		if (cardText.contains(cardName + " is red."))
-			colors << "R";
-		if (cardText.contains(cardName + " is green."))
-			colors << "G";
-		
-		bool cipt = (cardText.contains(cardName + " enters the battlefield tapped."));
-		
-		card = new CardInfo(this, cardName, cardCost, cardType, cardPT, fullCardText, colors, cipt);
-
-                card->setPicURL(getURLFromNameAndCardSet(cardName, setShortName, false, pictureUrl));
-                card->setPicHqURL(getURLFromNameAndCardSet(cardName, setShortName, true, pictureUrlHq));
-                card->setPicStURL(getURLFromNameAndCardSet(cardName, setShortName, true, pictureUrlStripped));
-
-
-		int tableRow = 1;
-		QString mainCardType = card->getMainCardType();
-		if ((mainCardType == "Land") || mArtifact)
-			tableRow = 0;
-		else if ((mainCardType == "Sorcery") || (mainCardType == "Instant"))
-			tableRow = 3;
-		else if (mainCardType == "Creature")
-			tableRow = 2;
-		card->setTableRow(tableRow);
-
-		cardHash.insert(cardName, card);
+		card = new CardInfo(this, spoilerCard.name, spoilerCard.cost, spoilerCard.type, spoilerCard.pt, spoilerCard.text, spoilerCard.colors, spoilerCard.cipt, spoilerCard.tableRow);
+                card->setPicURL(spoilerCard.picURL);
+                card->setPicHqURL(spoilerCard.picHqURL);
+                card->setPicStURL(spoilerCard.picStURL);
+		cardHash.insert(spoilerCard.name, card);
 	}
 	return card;
 }
 
-int OracleImporter::importTextSpoiler(CardSet *set, const QByteArray &data)
+QList<SpoilerCard> OracleImporter::parseTextSpoiler(const QByteArray &data, const QString &setShortName, const SpoilerUrls &urls)
 {
-	int cards = 0;
+	// Runs on a worker thread: no access to the database or to translations.
+	QList<SpoilerCard> result;
 	QString bufferContents(data);
 	
 	// Workaround for ampersand bug in text spoilers
@@ -156,6 +163,7 @@ int OracleImporter::importTextSpoiler(CardSet *set, const QByteArray &data)
 	if (!doc.setContent(bufferContents, &errorMsg, &errorLine, &errorColumn))
 		qDebug(QString("error: %1, line=%2, column=%3").arg(errorMsg).arg(errorLine).arg(errorColumn).toLatin1());
 
+	const QString emDash = QString::fromUtf8("—");
 	QDomNodeList divs = doc.elementsByTagName("div");
 	for (int i = 0; i < divs.size(); ++i) {
 		QDomElement div = divs.at(i).toElement();
@@ -172,15 +180,11 @@ int OracleImporter::importTextSpoiler(CardSet *set, const QByteArray &data)
 					for (int i = 0; i < cardTextSplit.size(); ++i)
 						cardTextSplit[i] = cardTextSplit[i].trimmed();
 					
-                                        CardInfo *card = addCard(cardName, cardCost, cardType, cardPT, cardTextSplit, set->getShortName());
-					if (!set->contains(card)) {
-						card->addToSet(set);
-						cards++;
-					}
+					result.append(makeSpoilerCard(cardName, cardCost, cardType, cardPT, cardTextSplit, setShortName, urls));
 					cardName = cardCost = cardType = cardPT = cardText = QString();
 				} else {
 					QString v1 = tds.at(0).toElement().text().simplified();
-					QString v2 = tds.at(1).toElement().text().replace(trUtf8("—"), "-");
+					QString v2 = tds.at(1).toElement().text().replace(emDash, "-");
 					
 					if (v1 == "Name:")
 						cardName = v2.simplified();
@@ -197,10 +201,10 @@ int OracleImporter::importTextSpoiler(CardSet *set, const QByteArray &data)
 			break;
 		}
 	}
-	return cards;
+	return result;
 }
 
-QString OracleImporter::getURLFromNameAndCardSet(QString name, QString setName, bool hq, QString baseUrl) const
+QString OracleImporter::getURLFromNameAndCardSet(QString name, QString setName, bool hq, QString baseUrl)
 {
         QString simpleName = name
                              .replace("Æther", "Aether")
@@ -221,6 +225,19 @@ QString OracleImporter::getURLFromNameAndCardSet(QString name, QString setName,
 
 }
 
+QString OracleImporter::getSpoilerCacheFileName(int setIndex) const
+{
+	return dataDir + "/spoilers/" + setsToDownload[setIndex].getShortName() + ".html";
+}
+
+void OracleImporter::clearSpoilerCache()
+{
+	QDir cacheDir(dataDir + "/spoilers");
+	const QStringList files = cacheDir.entryList(QStringList() << "*.html", QDir::Files);
+	for (int i = 0; i < files.size(); ++i)
+		cacheDir.remove(files[i]);
+}
+
 int OracleImporter::startDownload()
 {
 	setsToDownload.clear();
@@ -230,79 +247,147 @@ int OracleImporter::startDownload()
 	
 	if (setsToDownload.isEmpty())
 		return 0;
-	setIndex = 0;
+	QDir(dataDir).mkdir("spoilers");
+	nextDownloadIndex = 0;
+	nextMergeIndex = 0;
 	emit setIndexChanged(0, 0, setsToDownload[0].getLongName());
 	
-	downloadNextFile();
+	startDownloads();
 	return setsToDownload.size();
 }
 
-void OracleImporter::downloadNextFile()
+void OracleImporter::startDownloads()
 {
-	QString urlString = setsToDownload[setIndex].getUrl();
-	if (urlString.isEmpty())
-		urlString = setUrl;
-	urlString = urlString.replace("!longname!", setsToDownload[setIndex].getLongName());
-	if (urlString.startsWith("http://")) {
-		QUrl url(urlString);
-		http->setHost(url.host(), QHttp::ConnectionModeHttp, url.port() == -1 ? 0 : url.port());
-		QString path = QUrl::toPercentEncoding(urlString.mid(url.host().size() + 7).replace(' ', '+'), "?!$&'()*+,;=:@/");
+	while ((nextDownloadIndex != -1) && (nextDownloadIndex < setsToDownload.size()) && (runningDownloads.size() < maxParallelDownloads)) {
+		const int setIndex = nextDownloadIndex++;
 		
-		buffer->close();
-		buffer->setData(QByteArray());
-		buffer->open(QIODevice::ReadWrite | QIODevice::Text);
-		reqId = http->get(path, buffer);
-	} else {
-		QFile file(dataDir + "/" + urlString);
-		file.open(QIODevice::ReadOnly | QIODevice::Text);
+		// Spoilers of an interrupted run are kept on disk, so that
+		// a new run only downloads what is still missing.
+		QFile cacheFile(getSpoilerCacheFileName(setIndex));
+		if (cacheFile.open(QIODevice::ReadOnly)) {
+			startParsing(setIndex, cacheFile.readAll());
+			continue;
+		}
 		
-		buffer->close();
-		buffer->setData(file.readAll());
-		buffer->open(QIODevice::ReadWrite | QIODevice::Text);
-		reqId = 0;
-		httpRequestFinished(reqId, false);
+		QString urlString = setsToDownload[setIndex].getUrl();
+		if (urlString.isEmpty())
+			urlString = setUrl;
+		urlString = urlString.replace("!longname!", setsToDownload[setIndex].getLongName());
+		if (urlString.startsWith("http://")) {
+			QUrl url = QUrl::fromEncoded(QUrl::toPercentEncoding(urlString.replace(' ', '+'), "?!$&'()*+,;=:@/"));
+			QNetworkReply *reply = nam->get(QNetworkRequest(url));
+			connect(reply, SIGNAL(finished()), this, SLOT(downloadFinished()));
+			connect(reply, SIGNAL(downloadProgress(qint64, qint64)), this, SLOT(updateDownloadProgress(qint64, qint64)));
+			runningDownloads.insert(reply, setIndex);
+		} else {
+			QFile file(dataDir + "/" + urlString);
+			file.open(QIODevice::ReadOnly | QIODevice::Text);
+			startParsing(setIndex, file.readAll());
+		}
 	}
 }
 
-void OracleImporter::httpRequestFinished(int requestId, bool error)
+void OracleImporter::updateDownloadProgress(qint64 bytesRead, qint64 totalBytes)
 {
-	if (error) {
-		QMessageBox::information(0, tr("HTTP"), tr("Error."));
-		return;
+	downloadProgress.insert(static_cast<QNetworkReply *>(sender()), qMakePair(bytesRead, totalBytes));
+	
+	qint64 read = 0, total = 0;
+	QMapIterator<QNetworkReply *, QPair<qint64, qint64> > i(downloadProgress);
+	while (i.hasNext()) {
+		i.next();
+		read += i.value().first;
+		total += qMax(i.value().first, i.value().second);
 	}
-	if (requestId != reqId)
-		return;
+	emit dataReadProgress(read, total);
+}
 
-	CardSet *set = new CardSet(setsToDownload[setIndex].getShortName(), setsToDownload[setIndex].getLongName());
-	if (!setHash.contains(set->getShortName()))
-		setHash.insert(set->getShortName(), set);
+void OracleImporter::downloadFinished()
+{
+	QNetworkReply *reply = static_cast<QNetworkReply *>(sender());
+	reply->deleteLater();
+	downloadProgress.remove(reply);
+	if (!runningDownloads.contains(reply))
+		return;
+	const int setIndex = runningDownloads.take(reply);
 	
-	buffer->seek(0);
-	buffer->close();
-	int cards = importTextSpoiler(set, buffer->data());
-	++setIndex;
+	if (reply->error() != QNetworkReply::NoError) {
+		QMessageBox::information(0, tr("HTTP"), tr("Download failed: %1.").arg(reply->errorString()));
+		abortImport();
+		return;
+	}
 	
-	if (setIndex == setsToDownload.size()) {
-		emit setIndexChanged(cards, setIndex, QString());
-		setIndex = -1;
-	} else {
-		downloadNextFile();
-		emit setIndexChanged(cards, setIndex, setsToDownload[setIndex].getLongName());
+	const QByteArray data = reply->readAll();
+	QFile cacheFile(getSpoilerCacheFileName(setIndex) + ".part");
+	if (cacheFile.open(QIODevice::WriteOnly)) {
+		cacheFile.write(data);
+		cacheFile.close();
+		QFile::remove(getSpoilerCacheFileName(setIndex));
+		cacheFile.rename(getSpoilerCacheFileName(setIndex));
 	}
+	
+	startParsing(setIndex, data);
+	startDownloads();
 }
 
-void OracleImporter::readResponseHeader(const QHttpResponseHeader &responseHeader)
+void OracleImporter::startParsing(int setIndex, const QByteArray &data)
 {
-	switch (responseHeader.statusCode()) {
-		case 200:
-		case 301:
-		case 302:
-		case 303:
-		case 307:
-			break;
-		default:
-			QMessageBox::information(0, tr("HTTP"), tr("Download failed: %1.").arg(responseHeader.reasonPhrase()));
-			http->abort();
-			deleteLater();
+	QFutureWatcher<QList<SpoilerCard> > *watcher = new QFutureWatcher<QList<SpoilerCard> >(this);
+	connect(watcher, SIGNAL(finished()), this, SLOT(parseFinished()));
+	runningParsers.insert(watcher, setIndex);
+	watcher->setFuture(QtConcurrent::run(&OracleImporter::parseTextSpoiler, data, setsToDownload[setIndex].getShortName(), spoilerUrls));
+}
+
+void OracleImporter::parseFinished()
+{
+	QFutureWatcher<QList<SpoilerCard> > *watcher = static_cast<QFutureWatcher<QList<SpoilerCard> > *>(sender());
+	watcher->deleteLater();
+	if (!runningParsers.contains(watcher))
+		return;
+	parsedSets.insert(runningParsers.take(watcher), watcher->result());
+	mergeParsedSets();
+}
+
+void OracleImporter::mergeParsedSets()
+{
+	while ((nextMergeIndex != -1) && parsedSets.contains(nextMergeIndex)) {
+		const QList<SpoilerCard> spoilerCards = parsedSets.take(nextMergeIndex);
+		const SetToDownload &setToDownload = setsToDownload[nextMergeIndex];
+		
+		CardSet *set;
+		if (setHash.contains(setToDownload.getShortName()))
+			set = setHash.value(setToDownload.getShortName());
+		else {
+			set = new CardSet(setToDownload.getShortName(), setToDownload.getLongName());
+			setHash.insert(set->getShortName(), set);
+		}
+		
+		int cards = 0;
+		for (int i = 0; i < spoilerCards.size(); ++i) {
+			CardInfo *card = addCard(spoilerCards[i]);
+			if (!set->contains(card)) {
+				card->addToSet(set);
+				cards++;
+			}
+		}
+		
+		++nextMergeIndex;
+		if (nextMergeIndex == setsToDownload.size()) {
+			nextDownloadIndex = nextMergeIndex = -1;
+			emit setIndexChanged(cards, setsToDownload.size(), QString());
+		} else
+			emit setIndexChanged(cards, nextMergeIndex, setsToDownload[nextMergeIndex].getLongName());
 	}
 }
+
+void OracleImporter::abortImport()
+{
+	// Aborting emits finished(), so the bookkeeping has to be gone first.
+	const QList<QNetworkReply *> replies = runningDownloads.keys();
+	runningDownloads.clear();
+	downloadProgress.clear();
+	runningParsers.clear();
+	parsedSets.clear();
+	nextDownloadIndex = nextMergeIndex = -1;
+	for (int i = 0; i < replies.size(); ++i)
+		replies[i]->abort();
+}
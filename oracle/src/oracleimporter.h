@@ -2,10 +2,12 @@
 #define ORACLEIMPORTER_H
 
 #include <carddatabase.h>
-#include <QHttp>
+#include <QMap>
+#include <QFutureWatcher>
 
-class QBuffer;
 class QXmlStreamReader;
+class QNetworkAccessManager;
+class QNetworkReply;
 
 class SetToDownload {
 private:
@@ -21,24 +23,56 @@ public:
 		: shortName(_shortName), longName(_longName), url(_url), import(_import) { }
 };
 
+// A card as read from a text spoiler, with everything derived from its
+// text already computed, so that merging it into the database is cheap.
+class SpoilerCard {
+public:
+	QString name, cost, type, pt, text;
+	QStringList colors;
+	QString picURL, picHqURL, picStURL;
+	bool splitCard, cipt;
+	int tableRow;
+	SpoilerCard() : splitCard(false), cipt(false), tableRow(1) { }
+};
+
+class SpoilerUrls {
+public:
+	QString pictureUrl, pictureUrlHq, pictureUrlStripped;
+};
+
 class OracleImporter : public CardDatabase {
 	Q_OBJECT
 private:
+	static const int maxParallelDownloads = 4;
+	
 	QList<SetToDownload> allSets, setsToDownload;
-        QString pictureUrl, pictureUrlHq, pictureUrlStripped, setUrl;
+	SpoilerUrls spoilerUrls;
+	QString setUrl;
 	QString dataDir;
-	int setIndex;
-	int reqId;
-	QBuffer *buffer;
-	QHttp *http;
-        QString getURLFromNameAndCardSet(QString name, QString set, bool hq, QString baseUrl) const;
+	QNetworkAccessManager *nam;
+	
+	// Sets are downloaded and parsed in parallel, but merged strictly in
+	// order, so that the result does not depend on network timing.
+	int nextDownloadIndex, nextMergeIndex;
+	QMap<QNetworkReply *, int> runningDownloads;
+	QMap<QNetworkReply *, QPair<qint64, qint64> > downloadProgress;
+	QMap<QFutureWatcher<QList<SpoilerCard> > *, int> runningParsers;
+	QMap<int, QList<SpoilerCard> > parsedSets;
+	
+	static QString getURLFromNameAndCardSet(QString name, QString set, bool hq, QString baseUrl);
+	static SpoilerCard makeSpoilerCard(QString cardName, const QString &cardCost, const QString &cardType, const QString &cardPT, const QStringList &cardText, const QString &setShortName, const SpoilerUrls &urls);
 	
-	void downloadNextFile();
+	QString getSpoilerCacheFileName(int setIndex) const;
+	void startDownloads();
+	void startParsing(int setIndex, const QByteArray &data);
+	void mergeParsedSets();
+	void abortImport();
 	void readSetsFromXml(QXmlStreamReader &xml);
-        CardInfo *addCard(QString cardName, const QString &cardCost, const QString &cardType, const QString &cardPT, const QStringList &cardText, const QString setShortName);
+	CardInfo *addCard(const SpoilerCard &spoilerCard);
 private slots:
-	void httpRequestFinished(int requestId, bool error);
-	void readResponseHeader(const QHttpResponseHeader &responseHeader);
+	void downloadFinished();
+	void updateDownloadProgress(qint64 bytesRead, qint64 totalBytes);
+	void parseFinished();
 signals:
 	void setIndexChanged(int cardsImported, int setIndex, const QString &nextSetName);
 	void dataReadProgress(int bytesRead, int totalBytes);
@@ -47,7 +81,8 @@ public:
 	void readSetsFromByteArray(const QByteArray &data);
 	void readSetsFromFile(const QString &fileName);
 	int startDownload();
-	int importTextSpoiler(CardSet *set, const QByteArray &data);
+	void clearSpoilerCache();
+	static QList<SpoilerCard> parseTextSpoiler(const QByteArray &data, const QString &setShortName, const SpoilerUrls &urls);
 	QList<SetToDownload> &getSets() { return allSets; }
 	const QString &getDataDir() const { return dataDir; }
 };
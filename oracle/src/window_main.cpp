@@ -165,8 +165,10 @@ void WindowMain::updateTotalProgress(int cardsImported, int setIndex, const QStr
 			}
 			if (fileName.isEmpty())
 				qApp->quit();
-			if (importer->saveToFile(fileName))
+			if (importer->saveToFile(fileName)) {
+				importer->clearSpoilerCache();
 				ok = true;
+			}
 			else
 				QMessageBox::critical(this, tr("Error"), tr("The file could not be saved to the desired location."));
 		} while (!ok);
@@ -13,10 +13,16 @@ CONFIG += qt debug
 QT += network sql
 QT -= gui
 
+# Stream compression needs zlib, which Qt bundles on Windows.
+unix:LIBS += -lz
+win32:INCLUDEPATH += $$[QT_INSTALL_PREFIX]/src/3rdparty/zlib
+
 HEADERS += src/servatrice.h \
 	src/serversocketinterface.h \
 	../common/color.h \
 	../common/serializable_item.h \
+	../common/stream_compression.h \
+	../common/serializable_arena.h \
 	../common/decklist.h \
 	../common/protocol.h \
 	../common/protocol_items.h \
@@ -26,8 +32,11 @@ HEADERS += src/servatrice.h \
 	../common/server.h \
 	../common/server_arrow.h \
 	../common/server_card.h \
+	../common/server_cardpool.h \
 	../common/server_cardzone.h \
 	../common/server_room.h \
+	../common/server_presence.h \
+	../common/server_timerwheel.h \
 	../common/server_counter.h \
 	../common/server_game.h \
 	../common/server_player.h \
@@ -38,6 +47,8 @@ SOURCES += src/main.cpp \
 	src/servatrice.cpp \
 	src/serversocketinterface.cpp \
 	../common/serializable_item.cpp \
+	../common/stream_compression.cpp \
+	../common/serializable_arena.cpp \
 	../common/decklist.cpp \
 	../common/protocol.cpp \
 	../common/protocol_items.cpp \
@@ -47,8 +58,11 @@ SOURCES += src/main.cpp \
 	../common/sfmt/SFMT.c \
 	../common/server.cpp \
 	../common/server_card.cpp \
+	../common/server_cardpool.cpp \
 	../common/server_cardzone.cpp \
 	../common/server_room.cpp \
+	../common/server_presence.cpp \
+	../common/server_timerwheel.cpp \
 	../common/server_game.cpp \
 	../common/server_player.cpp \
 	../common/server_protocolhandler.cpp
@@ -117,5 +117,10 @@ CREATE TABLE `cockatrice_uptime` (
   `uptime` int(11) DEFAULT NULL,
   `users_count` int(11) DEFAULT NULL,
   `games_count` int(11) DEFAULT NULL,
+  `tx_queue_bytes` bigint(20) DEFAULT NULL,
+  `tx_queue_peak_bytes` bigint(20) DEFAULT NULL,
+  `tx_overflows` int(11) DEFAULT NULL,
+  `tx_bytes` bigint(20) DEFAULT NULL,
+  `tx_wire_bytes` bigint(20) DEFAULT NULL,
   PRIMARY KEY (`timest`)
 ) ENGINE=MyISAM DEFAULT CHARSET=utf8;
@@ -23,16 +23,13 @@
 #include <iostream>
 #include "servatrice.h"
 #include "server_room.h"
+#include "server_presence.h"
 #include "serversocketinterface.h"
 #include "protocol.h"
 
 Servatrice::Servatrice(QObject *parent)
-	: Server(parent), uptime(0)
+	: Server(parent), uptime(0), outputQueueBytes(0), outputQueuePeakBytes(0), outputOverflowCount(0), txPlainBytes(0), txWireBytes(0)
 {
-	pingClock = new QTimer(this);
-	connect(pingClock, SIGNAL(timeout()), this, SIGNAL(pingClockTimeout()));
-	pingClock->start(1000);
-	
 	ProtocolItem::initializeHash();
 	settings = new QSettings("servatrice.ini", QSettings::IniFormat, this);
 	
@@ -44,6 +41,20 @@ Servatrice::Servatrice(QObject *parent)
 		statusUpdateClock->start(statusUpdateTime);
 	}
 	
+	presence->setUpdateInterval(settings->value("server/presenceupdate", 500).toInt());
+	
+	maxOutputBuffer = settings->value("server/max_output_buffer", 4 * 1024 * 1024).toInt();
+	const QString overflowPolicy = settings->value("server/output_overflow_policy").toString();
+	if (overflowPolicy == "drop_spectators")
+		outputOverflowPolicy = OverflowDropSpectators;
+	else if (overflowPolicy == "resync")
+		outputOverflowPolicy = OverflowResync;
+	else
+		outputOverflowPolicy = OverflowDisconnect;
+	
+	// 0 disables stream compression, 1-9 are the usual zlib levels.
+	compressionLevel = qBound(0, settings->value("server/compression_level", 6).toInt(), 9);
+	
 	tcpServer = new QTcpServer(this);
 	connect(tcpServer, SIGNAL(newConnection()), this, SLOT(newConnection()));
 	int port = settings->value("server/port", 4747).toInt();
@@ -185,7 +196,7 @@ ServerInfo_User *Servatrice::getUserData(const QString &name)
 				userLevel,
 				realName,
 				country,
-				avatarBmp
+				storeAvatar(avatarBmp)
 			);
 		} else
 			return new ServerInfo_User(name, ServerInfo_User::IsUser);
@@ -218,11 +229,29 @@ void Servatrice::statusUpdate()
 	checkSql();
 	
 	QSqlQuery query;
-	query.prepare("insert into " + dbPrefix + "_uptime (timest, uptime, users_count, games_count) values(NOW(), :uptime, :users_count, :games_count)");
+	query.prepare("insert into " + dbPrefix + "_uptime (timest, uptime, users_count, games_count, tx_queue_bytes, tx_queue_peak_bytes, tx_overflows, tx_bytes, tx_wire_bytes) values(NOW(), :uptime, :users_count, :games_count, :tx_queue_bytes, :tx_queue_peak_bytes, :tx_overflows, :tx_bytes, :tx_wire_bytes)");
 	query.bindValue(":uptime", uptime);
 	query.bindValue(":users_count", users.size());
 	query.bindValue(":games_count", games.size());
+	query.bindValue(":tx_queue_bytes", outputQueueBytes);
+	query.bindValue(":tx_queue_peak_bytes", outputQueuePeakBytes);
+	query.bindValue(":tx_overflows", outputOverflowCount);
+	query.bindValue(":tx_bytes", txPlainBytes);
+	query.bindValue(":tx_wire_bytes", txWireBytes);
 	execSqlQuery(query);
+	
+	// Peak, overflow count and traffic are per status update interval.
+	outputQueuePeakBytes = outputQueueBytes;
+	outputOverflowCount = 0;
+	txPlainBytes = 0;
+	txWireBytes = 0;
+}
+
+void Servatrice::outputQueueChanged(qint64 delta)
+{
+	outputQueueBytes += delta;
+	if (outputQueueBytes > outputQueuePeakBytes)
+		outputQueuePeakBytes = outputQueueBytes;
 }
 
 const QString Servatrice::versionString = "Servatrice 0.20110114";
@@ -35,6 +35,7 @@ private slots:
 	void newConnection();
 	void statusUpdate();
 public:
+	enum OutputOverflowPolicy { OverflowDisconnect, OverflowDropSpectators, OverflowResync };
 	static const QString versionString;
 	Servatrice(QObject *parent = 0);
 	~Servatrice();
@@ -46,12 +47,18 @@ public:
 	int getMaxGameInactivityTime() const { return maxGameInactivityTime; }
 	int getMaxPlayerInactivityTime() const { return maxPlayerInactivityTime; }
 	QString getDbPrefix() const { return dbPrefix; }
+	int getMaxOutputBuffer() const { return maxOutputBuffer; }
+	OutputOverflowPolicy getOutputOverflowPolicy() const { return outputOverflowPolicy; }
+	void outputQueueChanged(qint64 delta);
+	void outputQueueOverflowed() { ++outputOverflowCount; }
+	int getCompressionLevel() const { return compressionLevel; }
+	void dataSent(qint64 plainBytes, qint64 wireBytes) { txPlainBytes += plainBytes; txWireBytes += wireBytes; }
 	void updateLoginMessage();
 protected:
 	AuthenticationResult checkUserPassword(const QString &user, const QString &password);
 	ServerInfo_User *getUserData(const QString &name);
 private:
-	QTimer *pingClock, *statusUpdateClock;
+	QTimer *statusUpdateClock;
 	QTcpServer *tcpServer;
 	QString loginMessage;
 	QString dbPrefix;
@@ -59,6 +66,12 @@ private:
 	int uptime;
 	int maxGameInactivityTime;
 	int maxPlayerInactivityTime;
+	int maxOutputBuffer;
+	OutputOverflowPolicy outputOverflowPolicy;
+	qint64 outputQueueBytes, outputQueuePeakBytes;
+	int outputOverflowCount;
+	int compressionLevel;
+	qint64 txPlainBytes, txWireBytes;
 };
 
 #endif
@@ -20,6 +20,7 @@
 
 #include <QXmlStreamReader>
 #include <QXmlStreamWriter>
+#include <QBuffer>
 #include <QtSql>
 #include <QDebug>
 #include "serversocketinterface.h"
@@ -28,22 +29,31 @@
 #include "protocol_items.h"
 #include "decklist.h"
 #include "server_player.h"
+#include "server_game.h"
+#include "stream_compression.h"
 
 ServerSocketInterface::ServerSocketInterface(Servatrice *_server, QTcpSocket *_socket, QObject *parent)
-	: Server_ProtocolHandler(_server, parent), servatrice(_server), socket(_socket), topLevelItem(0)
+	: Server_ProtocolHandler(_server, parent), servatrice(_server), socket(_socket), topLevelItem(0), outputQueueBytes(0), flushScheduled(false), outputClosed(false), deflater(0), inflater(0)
 {
+	// Items are serialized into a buffer and collected as frames. All frames
+	// produced during one event loop iteration go out with a single write.
+	outputBuffer = new QBuffer(this);
+	outputBuffer->open(QIODevice::WriteOnly);
 	xmlWriter = new QXmlStreamWriter;
-	xmlWriter->setDevice(socket);
+	xmlWriter->setDevice(outputBuffer);
 	
 	xmlReader = new QXmlStreamReader;
 	
 	connect(socket, SIGNAL(readyRead()), this, SLOT(readClient()));
+	connect(socket, SIGNAL(bytesWritten(qint64)), this, SLOT(flushOutputQueue()));
 	connect(socket, SIGNAL(disconnected()), this, SLOT(deleteLater()));
 	connect(socket, SIGNAL(error(QAbstractSocket::SocketError)), this, SLOT(catchSocketError(QAbstractSocket::SocketError)));
 	
 	xmlWriter->writeStartDocument();
 	xmlWriter->writeStartElement("cockatrice_server_stream");
 	xmlWriter->writeAttribute("version", QString::number(ProtocolItem::protocolVersion));
+	if (servatrice->getCompressionLevel() > 0)
+		xmlWriter->writeAttribute("compression", StreamCompression::methodName);
 	
 	sendProtocolItem(new Event_ServerMessage(Servatrice::versionString));
 }
@@ -52,6 +62,9 @@ ServerSocketInterface::~ServerSocketInterface()
 {
 	qDebug("ServerSocketInterface destructor");
 	
+	servatrice->outputQueueChanged(-outputQueueBytes);
+	delete deflater;
+	delete inflater;
 	delete xmlWriter;
 	delete xmlReader;
 	delete socket;
@@ -69,9 +82,44 @@ void ServerSocketInterface::processProtocolItem(ProtocolItem *item)
 void ServerSocketInterface::readClient()
 {
 	QByteArray data = socket->readAll();
+	
+	if (!topLevelItem) {
+		// Anything following the client stream header may already be
+		// compressed, so only the header itself goes to the XML parser.
+		handshakeBuffer.append(data);
+		int headerStart = handshakeBuffer.indexOf("<cockatrice_client_stream");
+		int headerEnd = (headerStart == -1) ? -1 : handshakeBuffer.indexOf('>', headerStart);
+		if (headerEnd == -1) {
+			if (handshakeBuffer.size() > maxHandshakeSize)
+				deleteLater();
+			return;
+		}
+		xmlReader->addData(handshakeBuffer.left(headerEnd + 1));
+		data = handshakeBuffer.mid(headerEnd + 1);
+		handshakeBuffer.clear();
+		parseClientData();
+		if (!topLevelItem) {
+			deleteLater();
+			return;
+		}
+	}
+	
+	if (inflater) {
+		QByteArray plainData;
+		if (!inflater->inflate(data, plainData)) {
+			qDebug("ServerSocketInterface: invalid compressed data");
+			deleteLater();
+			return;
+		}
+		data = plainData;
+	}
 	qDebug() << data;
 	xmlReader->addData(data);
-	
+	parseClientData();
+}
+
+void ServerSocketInterface::parseClientData()
+{
 	while (!xmlReader->atEnd()) {
 		xmlReader->readNext();
 		if (topLevelItem)
@@ -79,6 +127,11 @@ void ServerSocketInterface::readClient()
 		else if (xmlReader->isStartElement() && (xmlReader->name().toString() == "cockatrice_client_stream")) {
 			topLevelItem = new TopLevelProtocolItem;
 			connect(topLevelItem, SIGNAL(protocolItemReceived(ProtocolItem *)), this, SLOT(processProtocolItem(ProtocolItem *)));
+			
+			if ((servatrice->getCompressionLevel() > 0) && (xmlReader->attributes().value("compression").toString() == StreamCompression::methodName)) {
+				inflater = new StreamInflater;
+				enqueueOutputFrame(OutputFrame(StreamCompression::startMarker, -1, true));
+			}
 		}
 	}
 }
@@ -92,11 +145,201 @@ void ServerSocketInterface::catchSocketError(QAbstractSocket::SocketError socket
 
 void ServerSocketInterface::sendProtocolItem(ProtocolItem *item, bool deleteItem)
 {
-	item->write(xmlWriter);
+	if (!outputClosed) {
+		const int cardNameCount = cardNames.size();
+		SerializableItem_CardName::setWriteDictionary(&cardNames);
+		item->write(xmlWriter);
+		SerializableItem_CardName::setWriteDictionary(0);
+		
+		// Frames that introduce card names must not be dropped, as later
+		// frames only refer to those names by id.
+		GameEventContainer *gameEventContainer = qobject_cast<GameEventContainer *>(item);
+		takeOutputFrame((gameEventContainer && (cardNames.size() == cardNameCount)) ? gameEventContainer->getGameId() : -1);
+	}
 	if (deleteItem)
 		delete item;
 }
 
+void ServerSocketInterface::takeOutputFrame(int gameId)
+{
+	QByteArray &data = outputBuffer->buffer();
+	if (data.isEmpty())
+		return;
+	
+	// Events of games we are about to leave are not sent anymore.
+	if ((gameId == -1) || !spectatedGamesToLeave.contains(gameId))
+		enqueueOutputFrame(OutputFrame(data, gameId));
+	data.clear();
+	outputBuffer->seek(0);
+}
+
+void ServerSocketInterface::enqueueOutputFrame(const OutputFrame &frame)
+{
+	outputQueue.append(frame);
+	outputQueueBytes += frame.data.size();
+	servatrice->outputQueueChanged(frame.data.size());
+	
+	// A burst of events within one event loop iteration must not grow the
+	// queue past the limit before the next flush gets to look at it.
+	if (outputQueueBytes > servatrice->getMaxOutputBuffer()) {
+		handleOutputOverflow();
+		if (outputClosed)
+			return;
+	}
+	
+	// While the socket is over its write limit, its bytesWritten() signal
+	// triggers the next flush.
+	if (!flushScheduled && (socket->bytesToWrite() < socketWriteLimit)) {
+		flushScheduled = true;
+		QMetaObject::invokeMethod(this, "flushOutputQueue", Qt::QueuedConnection);
+	}
+}
+
+void ServerSocketInterface::dropGameFrames(const QSet<int> &gameIds)
+{
+	QList<OutputFrame>::iterator i = outputQueue.begin();
+	while (i != outputQueue.end()) {
+		if ((i->gameId != -1) && gameIds.contains(i->gameId)) {
+			outputQueueBytes -= i->data.size();
+			servatrice->outputQueueChanged(-i->data.size());
+			i = outputQueue.erase(i);
+		} else
+			++i;
+	}
+}
+
+void ServerSocketInterface::handleOutputOverflow()
+{
+	servatrice->outputQueueOverflowed();
+	
+	switch (servatrice->getOutputOverflowPolicy()) {
+		case Servatrice::OverflowResync: {
+			// Throw away the queued game events; the client gets a fresh
+			// game state for each affected game once the queue has drained.
+			QSet<int> gameIds;
+			for (int i = 0; i < outputQueue.size(); ++i)
+				if (outputQueue[i].gameId != -1)
+					gameIds.insert(outputQueue[i].gameId);
+			dropGameFrames(gameIds);
+			gamesToResync += gameIds;
+			break;
+		}
+		case Servatrice::OverflowDropSpectators: {
+			// The client leaves the spectated games with the most queued
+			// events until the queue is back under the limit; the queued
+			// events of those games are discarded. Games may be iterating
+			// over their players right now, so the client actually leaves
+			// them on the next flush.
+			QMap<int, qint64> queuedBytes;
+			for (int i = 0; i < outputQueue.size(); ++i) {
+				const int gameId = outputQueue[i].gameId;
+				if ((gameId != -1) && games.contains(gameId) && games.value(gameId).second->getSpectator())
+					queuedBytes[gameId] += outputQueue[i].data.size();
+			}
+			qint64 remainingBytes = outputQueueBytes;
+			QSet<int> gameIds;
+			while (!queuedBytes.isEmpty() && (remainingBytes > servatrice->getMaxOutputBuffer())) {
+				QMap<int, qint64>::iterator largest = queuedBytes.begin();
+				for (QMap<int, qint64>::iterator i = queuedBytes.begin(); i != queuedBytes.end(); ++i)
+					if (i.value() > largest.value())
+						largest = i;
+				gameIds.insert(largest.key());
+				remainingBytes -= largest.value();
+				queuedBytes.erase(largest);
+			}
+			dropGameFrames(gameIds);
+			spectatedGamesToLeave += gameIds;
+			break;
+		}
+		case Servatrice::OverflowDisconnect:
+			break;
+	}
+	
+	if (outputQueueBytes > servatrice->getMaxOutputBuffer()) {
+		qDebug() << "ServerSocketInterface: output queue overflow," << outputQueueBytes << "bytes queued, disconnecting";
+		outputClosed = true;
+		deleteLater();
+	}
+}
+
+void ServerSocketInterface::sendResyncSnapshots()
+{
+	QSetIterator<int> gameIdIterator(gamesToResync);
+	while (gameIdIterator.hasNext()) {
+		const int gameId = gameIdIterator.next();
+		if (!games.contains(gameId))
+			continue;
+		Server_Game *game = games.value(gameId).first;
+		Server_Player *player = games.value(gameId).second;
+		sendProtocolItem(GameEventContainer::makeNew(new Event_GameStateChanged(game->getGameStarted(), game->getActivePlayer(), game->getActivePhase(), game->getGameState(player)), gameId));
+	}
+	gamesToResync.clear();
+}
+
+void ServerSocketInterface::leaveSpectatedGames()
+{
+	const QSet<int> gameIds = spectatedGamesToLeave;
+	spectatedGamesToLeave.clear();
+	QSetIterator<int> gameIdIterator(gameIds);
+	while (gameIdIterator.hasNext()) {
+		const int gameId = gameIdIterator.next();
+		if (!games.contains(gameId))
+			continue;
+		QPair<Server_Game *, Server_Player *> gamePair = games.value(gameId);
+		gamePair.first->removePlayer(gamePair.second);
+		sendProtocolItem(GameEventContainer::makeNew(new Event_GameClosed, gameId));
+	}
+}
+
+void ServerSocketInterface::flushOutputQueue()
+{
+	flushScheduled = false;
+	if (outputClosed)
+		return;
+	
+	if (!spectatedGamesToLeave.isEmpty())
+		leaveSpectatedGames();
+	if (!gamesToResync.isEmpty() && (outputQueueBytes < servatrice->getMaxOutputBuffer() / 2))
+		sendResyncSnapshots();
+	
+	// Frames stay in our queue, where they can still be dropped, until the
+	// socket has caught up with what it was given before.
+	qint64 writeLimit = socketWriteLimit - socket->bytesToWrite();
+	if (outputQueue.isEmpty() || (writeLimit <= 0))
+		return;
+	
+	// Everything after the compression start marker goes through the
+	// deflater in one piece, which flushes it at the end of this write.
+	QByteArray data, plainData;
+	int plainSize = 0;
+	do {
+		const OutputFrame frame = outputQueue.takeFirst();
+		plainSize += frame.data.size();
+		if (deflater)
+			plainData.append(frame.data);
+		else {
+			data.append(frame.data);
+			if (frame.startsCompression)
+				deflater = new StreamDeflater(servatrice->getCompressionLevel());
+		}
+	} while (!outputQueue.isEmpty() && (plainSize + outputQueue.first().data.size() <= writeLimit));
+	
+	if (!plainData.isEmpty()) {
+		data.append(deflater->deflate(plainData));
+		if (!deflater->isValid()) {
+			qDebug("ServerSocketInterface: compression failed, disconnecting");
+			outputClosed = true;
+			deleteLater();
+			return;
+		}
+	}
+	
+	outputQueueBytes -= plainSize;
+	servatrice->outputQueueChanged(-plainSize);
+	servatrice->dataSent(plainSize, data.size());
+	socket->write(data);
+}
+
 int ServerSocketInterface::getDeckPathId(int basePathId, QStringList path)
 {
 	if (path.isEmpty())
@@ -21,14 +21,18 @@
 #define SERVERSOCKETINTERFACE_H
 
 #include <QTcpSocket>
+#include <QSet>
 #include "server_protocolhandler.h"
 
 class QTcpSocket;
+class QBuffer;
 class Servatrice;
 class QXmlStreamReader;
 class QXmlStreamWriter;
 class DeckList;
 class TopLevelProtocolItem;
+class StreamDeflater;
+class StreamInflater;
 
 class ServerSocketInterface : public Server_ProtocolHandler
 {
@@ -37,12 +41,44 @@ private slots:
 	void readClient();
 	void catchSocketError(QAbstractSocket::SocketError socketError);
 	void processProtocolItem(ProtocolItem *item);
+	void flushOutputQueue();
 private:
+	// Serialized protocol items waiting to be handed to the socket. Frames of
+	// game event containers carry their game id so that they can be dropped
+	// on overflow; all other frames have a game id of -1.
+	// The frame carrying the compression start marker is the last one sent
+	// uncompressed.
+	struct OutputFrame {
+		QByteArray data;
+		int gameId;
+		bool startsCompression;
+		OutputFrame(const QByteArray &_data = QByteArray(), int _gameId = -1, bool _startsCompression = false) : data(_data), gameId(_gameId), startsCompression(_startsCompression) { }
+	};
+	static const int maxHandshakeSize = 4096;
+	static const int socketWriteLimit = 64 * 1024;
+	
 	Servatrice *servatrice;
 	QTcpSocket *socket;
+	QBuffer *outputBuffer;
 	QXmlStreamWriter *xmlWriter;
 	QXmlStreamReader *xmlReader;
 	TopLevelProtocolItem *topLevelItem;
+	QList<OutputFrame> outputQueue;
+	qint64 outputQueueBytes;
+	bool flushScheduled, outputClosed;
+	QSet<int> gamesToResync, spectatedGamesToLeave;
+	QByteArray handshakeBuffer;
+	CardNameDictionary cardNames;
+	StreamDeflater *deflater;
+	StreamInflater *inflater;
+	
+	void parseClientData();
+	void enqueueOutputFrame(const OutputFrame &frame);
+	void takeOutputFrame(int gameId);
+	void dropGameFrames(const QSet<int> &gameIds);
+	void handleOutputOverflow();
+	void sendResyncSnapshots();
+	void leaveSpectatedGames();
 
 	int getDeckPathId(int basePathId, QStringList path);
 	int getDeckPathId(const QString &path);
@@ -61,6 +97,7 @@ public:
 	~ServerSocketInterface();
 
 	void sendProtocolItem(ProtocolItem *item, bool deleteItem = true);
+	qint64 getOutputQueueBytes() const { return outputQueueBytes; }
 };
 
 #endif